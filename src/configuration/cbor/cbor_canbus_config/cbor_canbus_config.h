@@ -56,6 +56,7 @@ struct CborCanChannelConfig {
 	uint32_t data_bitrate{};
 	struct zcbor_string dbc_file_path{};
 	std::pmr::vector<CborCanMessageConfig> CborCanMessageConfig_m;
+	uint32_t detected_bitrate{};
 
 	CborCanChannelConfig(std::allocator_arg_t, allocator_type alloc)
         : CborCanMessageConfig_m(alloc) {}
@@ -73,7 +74,8 @@ struct CborCanChannelConfig {
 		bitrate(other.bitrate),
 		data_bitrate(other.data_bitrate),
 		dbc_file_path(other.dbc_file_path),
-		CborCanMessageConfig_m(std::move(other.CborCanMessageConfig_m), alloc) {}
+		CborCanMessageConfig_m(std::move(other.CborCanMessageConfig_m), alloc),
+		detected_bitrate(other.detected_bitrate) {}
 };
 
 struct CborCanbusConfig {
@@ -160,6 +160,12 @@ static bool decode_CborCanChannelConfig(
         return false;
     }
 
+    // Optional, absent in configurations written before bitrate detection was persisted
+    if (!zcbor_array_at_end(state) && !zcbor_uint32_decode(state, &result->detected_bitrate)) {
+        zcbor_list_end_decode(state);
+        return false;
+    }
+
     if (!zcbor_list_end_decode(state)) {
         return false;
     }
@@ -44,6 +44,8 @@ static size_t cbor_get_size_CborCanbusConfig(const CborCanbusConfig& config) {
             }
 
         }
+
+        builder.AddUint(channel_configuration.detected_bitrate);
     }
 
     builder.AddInt(config.com_bus_channel);
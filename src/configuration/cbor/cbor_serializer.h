@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <span>
@@ -26,25 +27,48 @@ public:
         encodeFn_ = funcs.encode;
         decodeFn_ = funcs.decode;
         getSerializingSizeFn_ = funcs.get_size;
+        encode_capacity_ = CONFIG_EERIE_LEAP_CBOR_ENCODE_BUFFER_SIZE;
     }
 
+    // Encodes in a single pass into a buffer sized after the previous
+    // encoding, the size is only calculated when encoding into it fails.
+    // NOTE: Returned buffer keeps its capacity, callers only hold it
+    // until it's written, so it isn't worth a copy to shrink it.
     std::pmr::vector<uint8_t> Serialize(const T& obj, size_t *payload_len_out = nullptr) {
         LOG_MODULE_DECLARE(cbor_serializer_logger);
 
-        std::pmr::vector<uint8_t> buffer(getSerializingSizeFn_(obj), Mrm::GetExtPmr());
+        std::pmr::vector<uint8_t> buffer(encode_capacity_, Mrm::GetExtPmr());
 
         size_t obj_size = 0;
-        if(encodeFn_(buffer.data(), buffer.size(), &obj, &obj_size)) {
+        int rc = encodeFn_(buffer.data(), buffer.size(), &obj, &obj_size);
+
+        // Any failure may come from running out of buffer, zcbor doesn't
+        // always report it as ZCBOR_ERR_NO_PAYLOAD
+        if(rc) {
+            size_t calculated_size = getSerializingSizeFn_(obj);
+
+            if(buffer.size() < calculated_size) {
+                buffer.resize(calculated_size);
+                rc = encodeFn_(buffer.data(), buffer.size(), &obj, &obj_size);
+            }
+        }
+
+        if(rc) {
             LOG_ERR("Failed to encode object.");
             return {};
         }
 
+        buffer.resize(obj_size);
+        encode_capacity_ = std::max(encode_capacity_, obj_size + obj_size / ENCODE_HEADROOM_DIVISOR);
+
         if (payload_len_out != nullptr)
             *payload_len_out = obj_size;
 
         return buffer;
     }
 
+    // NOTE: Decoding doesn't copy strings, string fields of the object
+    // reference the input, which has to outlive it.
     pmr_unique_ptr<T> Deserialize(std::span<const uint8_t> input) {
         LOG_MODULE_DECLARE(cbor_serializer_logger);
 
@@ -58,6 +82,11 @@ public:
     }
 
 private:
+    // Room left for the object to grow before the size is calculated again
+    static constexpr size_t ENCODE_HEADROOM_DIVISOR = 8;
+
+    size_t encode_capacity_;
+
     CborTraitRegistry::CborEncodeFn<T> encodeFn_;
     CborTraitRegistry::CborDecodeFn<T> decodeFn_;
     CborTraitRegistry::CborGetSerializingSizeFn<T> getSerializingSizeFn_;
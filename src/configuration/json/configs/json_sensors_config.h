@@ -1,10 +1,18 @@
 #pragma once
 
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
 #include <boost/container/pmr/vector.hpp>
 #include <boost/json.hpp>
 #include <nameof.hpp>
 
 #include "utilities/memory/memory_resource_manager.h"
+#include "configuration/json/json_stream.h"
 
 namespace eerie_leap::configuration::json::configs {
 
@@ -188,4 +196,409 @@ static JsonSensorsConfig tag_invoke(json::value_to_tag<JsonSensorsConfig>, json:
     return result;
 }
 
+// Builds the configuration as it is parsed by boost::json::basic_parser,
+// without a document. Unknown keys are skipped, missing fields and values
+// of the wrong type fail the parse, as they do converting a document.
+class JsonSensorsConfigHandler {
+private:
+    enum class Scope {
+        Root,
+        Sensors,
+        Sensor,
+        Metadata,
+        Configuration,
+        CalibrationTable,
+        CalibrationData,
+        Ignored
+    };
+
+    struct Frame {
+        Scope scope;
+        uint32_t fields;
+    };
+
+    JsonSensorsConfig result_;
+    std::vector<Frame> frames_;
+    std::string key_;
+    std::string value_;
+    bool is_key_partial_ = false;
+    bool is_value_partial_ = false;
+
+    static uint32_t GetRequiredFields(Scope scope) {
+        switch(scope) {
+        case Scope::Root: return 0b1;
+        case Scope::Sensor: return 0b111;
+        case Scope::Metadata: return 0b111;
+        case Scope::Configuration: return 0b11111111;
+        case Scope::CalibrationData: return 0b11;
+        default: return 0;
+        }
+    }
+
+    static bool Fail(json::error_code& ec) {
+        ec = json::error::syntax;
+        return false;
+    }
+
+    bool IsKey(const char* name) const {
+        return key_ == name;
+    }
+
+    JsonSensorConfig& GetSensor() {
+        return result_.sensors.back();
+    }
+
+    // Scope of a value nested in the current one, Ignored if it is skipped
+    Scope GetNestedScope(bool is_array) const {
+        if(frames_.empty())
+            return is_array ? Scope::Ignored : Scope::Root;
+
+        switch(frames_.back().scope) {
+        case Scope::Root:
+            if(is_array && IsKey(NAMEOF_MEMBER(&JsonSensorsConfig::sensors).c_str()))
+                return Scope::Sensors;
+            break;
+        case Scope::Sensors:
+            if(!is_array)
+                return Scope::Sensor;
+            break;
+        case Scope::Sensor:
+            if(!is_array && IsKey(NAMEOF_MEMBER(&JsonSensorConfig::metadata).c_str()))
+                return Scope::Metadata;
+            if(!is_array && IsKey(NAMEOF_MEMBER(&JsonSensorConfig::configuration).c_str()))
+                return Scope::Configuration;
+            break;
+        case Scope::Configuration:
+            if(is_array && IsKey(NAMEOF_MEMBER(&JsonSensorConfigurationConfig::calibration_table).c_str()))
+                return Scope::CalibrationTable;
+            break;
+        case Scope::CalibrationTable:
+            if(!is_array)
+                return Scope::CalibrationData;
+            break;
+        default:
+            break;
+        }
+
+        return Scope::Ignored;
+    }
+
+    // Fields of the enclosing object a nested value sets
+    uint32_t GetNestedField(Scope scope) const {
+        switch(scope) {
+        case Scope::Sensors: return 0b1;
+        case Scope::Metadata: return 0b10;
+        case Scope::Configuration: return 0b100;
+        case Scope::CalibrationTable: return 0b1000000;
+        default: return 0;
+        }
+    }
+
+    bool BeginNested(bool is_array, json::error_code& ec) {
+        Scope scope = GetNestedScope(is_array);
+
+        if(scope == Scope::Ignored && !frames_.empty()) {
+            Scope parent_scope = frames_.back().scope;
+
+            // Arrays of sensors and calibration data hold objects only, and
+            // known keys can't hold a value of another type
+            if(parent_scope == Scope::Sensors || parent_scope == Scope::CalibrationTable)
+                return Fail(ec);
+            if(parent_scope != Scope::Ignored && IsKnownKey(parent_scope))
+                return Fail(ec);
+        } else if(scope == Scope::Ignored) {
+            return Fail(ec);
+        }
+
+        if(!frames_.empty())
+            frames_.back().fields |= GetNestedField(scope);
+
+        if(scope == Scope::Sensor)
+            result_.sensors.emplace_back();
+        else if(scope == Scope::CalibrationData)
+            GetSensor().configuration.calibration_table.push_back({ .voltage = 0, .value = 0 });
+
+        frames_.push_back({ .scope = scope, .fields = 0 });
+
+        return true;
+    }
+
+    bool EndNested(json::error_code& ec) {
+        const Frame& frame = frames_.back();
+        uint32_t required_fields = GetRequiredFields(frame.scope);
+
+        if((frame.fields & required_fields) != required_fields)
+            return Fail(ec);
+
+        frames_.pop_back();
+
+        return true;
+    }
+
+    bool IsKnownKey(Scope scope) const {
+        switch(scope) {
+        case Scope::Root:
+            return IsKey(NAMEOF_MEMBER(&JsonSensorsConfig::sensors).c_str());
+        case Scope::Sensor:
+            return IsKey(NAMEOF_MEMBER(&JsonSensorConfig::id).c_str())
+                || IsKey(NAMEOF_MEMBER(&JsonSensorConfig::metadata).c_str())
+                || IsKey(NAMEOF_MEMBER(&JsonSensorConfig::configuration).c_str());
+        case Scope::Metadata:
+            return IsKey(NAMEOF_MEMBER(&JsonSensorMetadataConfig::name).c_str())
+                || IsKey(NAMEOF_MEMBER(&JsonSensorMetadataConfig::unit).c_str())
+                || IsKey(NAMEOF_MEMBER(&JsonSensorMetadataConfig::description).c_str());
+        case Scope::Configuration:
+            return IsKey(NAMEOF_MEMBER(&JsonSensorConfigurationConfig::type).c_str())
+                || IsKey(NAMEOF_MEMBER(&JsonSensorConfigurationConfig::channel).c_str())
+                || IsKey(NAMEOF_MEMBER(&JsonSensorConfigurationConfig::connection_string).c_str())
+                || IsKey(NAMEOF_MEMBER(&JsonSensorConfigurationConfig::script_path).c_str())
+                || IsKey(NAMEOF_MEMBER(&JsonSensorConfigurationConfig::sampling_rate_ms).c_str())
+                || IsKey(NAMEOF_MEMBER(&JsonSensorConfigurationConfig::interpolation_method).c_str())
+                || IsKey(NAMEOF_MEMBER(&JsonSensorConfigurationConfig::calibration_table).c_str())
+                || IsKey(NAMEOF_MEMBER(&JsonSensorConfigurationConfig::expression).c_str());
+        case Scope::CalibrationData:
+            return IsKey(NAMEOF_MEMBER(&JsonSensorCalibrationDataConfig::voltage).c_str())
+                || IsKey(NAMEOF_MEMBER(&JsonSensorCalibrationDataConfig::value).c_str());
+        default:
+            return false;
+        }
+    }
+
+    // Returns field set, 0 if the key isn't a string field of the scope
+    uint32_t SetString(Frame& frame) {
+        switch(frame.scope) {
+        case Scope::Sensor:
+            if(IsKey(NAMEOF_MEMBER(&JsonSensorConfig::id).c_str())) {
+                GetSensor().id.assign(value_.data(), value_.size());
+                return 0b1;
+            }
+            break;
+        case Scope::Metadata: {
+            auto& metadata = GetSensor().metadata;
+
+            if(IsKey(NAMEOF_MEMBER(&JsonSensorMetadataConfig::name).c_str())) {
+                metadata.name.assign(value_.data(), value_.size());
+                return 0b1;
+            }
+            if(IsKey(NAMEOF_MEMBER(&JsonSensorMetadataConfig::unit).c_str())) {
+                metadata.unit.assign(value_.data(), value_.size());
+                return 0b10;
+            }
+            if(IsKey(NAMEOF_MEMBER(&JsonSensorMetadataConfig::description).c_str())) {
+                metadata.description.assign(value_.data(), value_.size());
+                return 0b100;
+            }
+            break;
+        }
+        case Scope::Configuration: {
+            auto& configuration = GetSensor().configuration;
+
+            if(IsKey(NAMEOF_MEMBER(&JsonSensorConfigurationConfig::type).c_str())) {
+                configuration.type.assign(value_.data(), value_.size());
+                return 0b1;
+            }
+            if(IsKey(NAMEOF_MEMBER(&JsonSensorConfigurationConfig::connection_string).c_str())) {
+                configuration.connection_string.assign(value_.data(), value_.size());
+                return 0b100;
+            }
+            if(IsKey(NAMEOF_MEMBER(&JsonSensorConfigurationConfig::script_path).c_str())) {
+                configuration.script_path.assign(value_.data(), value_.size());
+                return 0b1000;
+            }
+            if(IsKey(NAMEOF_MEMBER(&JsonSensorConfigurationConfig::interpolation_method).c_str())) {
+                configuration.interpolation_method.assign(value_.data(), value_.size());
+                return 0b100000;
+            }
+            if(IsKey(NAMEOF_MEMBER(&JsonSensorConfigurationConfig::expression).c_str())) {
+                configuration.expression.assign(value_.data(), value_.size());
+                return 0b10000000;
+            }
+            break;
+        }
+        default:
+            break;
+        }
+
+        return 0;
+    }
+
+    // Like boost::json number conversion, any number converts as long as
+    // it is integral and in range, e.g. 100.0 or an unsigned 100
+    static std::optional<int32_t> ToInt32(double number) {
+        if(std::trunc(number) != number
+            || number < std::numeric_limits<int32_t>::min()
+            || number > std::numeric_limits<int32_t>::max()) {
+
+            return std::nullopt;
+        }
+
+        return static_cast<int32_t>(number);
+    }
+
+    // Returns field set, 0 if the key isn't a number field of the scope
+    // or the number doesn't fit it
+    uint32_t SetNumber(Frame& frame, double number) {
+        switch(frame.scope) {
+        case Scope::Configuration: {
+            auto& configuration = GetSensor().configuration;
+            auto integer = ToInt32(number);
+
+            if(integer.has_value() && IsKey(NAMEOF_MEMBER(&JsonSensorConfigurationConfig::channel).c_str())) {
+                configuration.channel = integer.value();
+                return 0b10;
+            }
+            if(integer.has_value() && IsKey(NAMEOF_MEMBER(&JsonSensorConfigurationConfig::sampling_rate_ms).c_str())) {
+                configuration.sampling_rate_ms = integer.value();
+                return 0b10000;
+            }
+            break;
+        }
+        case Scope::CalibrationData: {
+            auto& calibration_data = GetSensor().configuration.calibration_table.back();
+
+            if(IsKey(NAMEOF_MEMBER(&JsonSensorCalibrationDataConfig::voltage).c_str())) {
+                calibration_data.voltage = static_cast<float>(number);
+                return 0b1;
+            }
+            if(IsKey(NAMEOF_MEMBER(&JsonSensorCalibrationDataConfig::value).c_str())) {
+                calibration_data.value = static_cast<float>(number);
+                return 0b10;
+            }
+            break;
+        }
+        default:
+            break;
+        }
+
+        return 0;
+    }
+
+    // Scalars of unknown keys are skipped, known keys have to hold
+    // a value of their type and arrays hold objects only
+    bool OnScalar(uint32_t field, json::error_code& ec) {
+        if(frames_.empty())
+            return Fail(ec);
+
+        Frame& frame = frames_.back();
+        if(frame.scope == Scope::Ignored)
+            return true;
+        if(frame.scope == Scope::Sensors || frame.scope == Scope::CalibrationTable)
+            return Fail(ec);
+
+        if(field == 0)
+            return IsKnownKey(frame.scope) ? Fail(ec) : true;
+
+        frame.fields |= field;
+
+        return true;
+    }
+
+    bool OnNumber(double number, json::error_code& ec) {
+        uint32_t field = !frames_.empty() && frames_.back().scope != Scope::Ignored
+            ? SetNumber(frames_.back(), number)
+            : 0;
+
+        return OnScalar(field, ec);
+    }
+
+public:
+    static constexpr std::size_t max_object_size = std::size_t(-1);
+    static constexpr std::size_t max_array_size = std::size_t(-1);
+    static constexpr std::size_t max_key_size = std::size_t(-1);
+    static constexpr std::size_t max_string_size = std::size_t(-1);
+
+    JsonSensorsConfigHandler() = default;
+
+    JsonSensorsConfig& GetResult() { return result_; }
+
+    bool on_document_begin(json::error_code&) { return true; }
+    bool on_document_end(json::error_code&) { return true; }
+
+    bool on_object_begin(json::error_code& ec) { return BeginNested(false, ec); }
+    bool on_object_end(std::size_t, json::error_code& ec) { return EndNested(ec); }
+    bool on_array_begin(json::error_code& ec) { return BeginNested(true, ec); }
+    bool on_array_end(std::size_t, json::error_code& ec) { return EndNested(ec); }
+
+    bool on_key_part(json::string_view s, std::size_t, json::error_code&) {
+        if(!is_key_partial_)
+            key_.clear();
+
+        key_.append(s.data(), s.size());
+        is_key_partial_ = true;
+
+        return true;
+    }
+
+    bool on_key(json::string_view s, std::size_t, json::error_code&) {
+        if(!is_key_partial_)
+            key_.clear();
+
+        key_.append(s.data(), s.size());
+        is_key_partial_ = false;
+
+        return true;
+    }
+
+    bool on_string_part(json::string_view s, std::size_t, json::error_code&) {
+        if(!is_value_partial_)
+            value_.clear();
+
+        value_.append(s.data(), s.size());
+        is_value_partial_ = true;
+
+        return true;
+    }
+
+    bool on_string(json::string_view s, std::size_t, json::error_code& ec) {
+        if(!is_value_partial_)
+            value_.clear();
+
+        value_.append(s.data(), s.size());
+        is_value_partial_ = false;
+
+        uint32_t field = !frames_.empty() && frames_.back().scope != Scope::Ignored
+            ? SetString(frames_.back())
+            : 0;
+
+        return OnScalar(field, ec);
+    }
+
+    bool on_number_part(json::string_view, json::error_code&) { return true; }
+    bool on_int64(int64_t i, json::string_view, json::error_code& ec) { return OnNumber(static_cast<double>(i), ec); }
+    bool on_uint64(uint64_t u, json::string_view, json::error_code& ec) { return OnNumber(static_cast<double>(u), ec); }
+    bool on_double(double d, json::string_view, json::error_code& ec) { return OnNumber(d, ec); }
+    bool on_bool(bool, json::error_code& ec) { return OnScalar(0, ec); }
+    bool on_null(json::error_code& ec) { return OnScalar(0, ec); }
+
+    bool on_comment_part(json::string_view, json::error_code&) { return true; }
+    bool on_comment(json::string_view, json::error_code&) { return true; }
+};
+
 } // namespace eerie_leap::configuration::json::configs
+
+namespace eerie_leap::configuration::json {
+
+template <>
+struct JsonStream<configs::JsonSensorsConfig> {
+    using Handler = configs::JsonSensorsConfigHandler;
+
+    // Sensors are converted one at a time
+    static void Write(JsonStreamWriter& writer, const configs::JsonSensorsConfig& config) {
+        writer.WriteRaw("{");
+        writer.WriteKey(NAMEOF_MEMBER(&configs::JsonSensorsConfig::sensors).c_str());
+        writer.WriteRaw("[");
+
+        bool is_first = true;
+        for(const auto& sensor : config.sensors) {
+            if(!is_first)
+                writer.WriteRaw(",");
+
+            writer.WriteValue(boost::json::value_from(sensor, Mrm::GetBoostExtPmr()));
+            is_first = false;
+        }
+
+        writer.WriteRaw("]}");
+    }
+};
+
+} // namespace eerie_leap::configuration::json
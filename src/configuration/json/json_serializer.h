@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <span>
+#include <streambuf>
 #include <boost/json.hpp>
 
 #include <zephyr/kernel.h>
@@ -11,6 +12,7 @@
 #include <zephyr/data/json.h>
 
 #include "utilities/memory/memory_resource_manager.h"
+#include "configuration/json/json_stream.h"
 
 namespace eerie_leap::configuration::json {
 
@@ -57,6 +59,27 @@ public:
         return json_str;
     }
 
+    // Writes to the stream in chunks, the document is never held as a whole
+    bool Serialize(const T& obj, std::streambuf& stream_buf) {
+        LOG_MODULE_DECLARE(json_serializer_logger);
+
+        JsonStreamWriter writer(stream_buf);
+
+        try {
+            JsonStream<T>::Write(writer, obj);
+        } catch(...) {
+            LOG_ERR("Failed to serialize object.");
+            return false;
+        }
+
+        if(!writer.IsGood()) {
+            LOG_ERR("Failed to write serialized object.");
+            return false;
+        }
+
+        return true;
+    }
+
     pmr_unique_ptr<T> Deserialize(std::string_view json_str) {
         LOG_MODULE_DECLARE(json_serializer_logger);
 
@@ -67,6 +90,11 @@ public:
             return {};
         }
     }
+
+    // Reader deserializing content written to it in chunks
+    JsonStreamReader<T> CreateReader() {
+        return JsonStreamReader<T>();
+    }
 };
 
 } // namespace eerie_leap::configuration::json
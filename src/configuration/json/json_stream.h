@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstddef>
+#include <ios>
+#include <streambuf>
+#include <string_view>
+
+#include <boost/json.hpp>
+#include <boost/json/basic_parser_impl.hpp>
+
+#include "utilities/memory/memory_resource_manager.h"
+
+namespace eerie_leap::configuration::json {
+
+using namespace eerie_leap::utilities::memory;
+
+// Writes JSON to a stream, values are serialized through a small buffer
+// rather than into a string holding the whole document.
+class JsonStreamWriter {
+private:
+    static constexpr size_t CHUNK_SIZE = 256;
+
+    std::streambuf& stream_buf_;
+    boost::json::serializer serializer_;
+    bool is_good_;
+
+    void WriteSerialized() {
+        char buffer[CHUNK_SIZE];
+
+        while(!serializer_.done()) {
+            boost::json::string_view sv = serializer_.read(buffer, sizeof(buffer));
+            WriteRaw(std::string_view(sv.data(), sv.size()));
+        }
+    }
+
+public:
+    explicit JsonStreamWriter(std::streambuf& stream_buf)
+        : stream_buf_(stream_buf), is_good_(true) {}
+
+    void WriteRaw(std::string_view raw) {
+        if(!is_good_)
+            return;
+
+        auto size = static_cast<std::streamsize>(raw.size());
+        if(stream_buf_.sputn(raw.data(), size) != size)
+            is_good_ = false;
+    }
+
+    void WriteValue(const boost::json::value& value) {
+        serializer_.reset(&value);
+        WriteSerialized();
+    }
+
+    void WriteString(std::string_view str) {
+        serializer_.reset(boost::json::string_view(str.data(), str.size()));
+        WriteSerialized();
+    }
+
+    void WriteKey(std::string_view key) {
+        WriteString(key);
+        WriteRaw(":");
+    }
+
+    bool IsGood() const { return is_good_; }
+};
+
+// Streaming conversion of a configuration. By default the document is
+// built as a whole and written in chunks, large configurations specialize
+// it to write their elements one at a time, and to provide a
+// boost::json::basic_parser handler building the configuration as it is
+// parsed, e.g.
+// template <>
+// struct JsonStream<JsonSensorsConfig> {
+//     using Handler = JsonSensorsConfigHandler;
+//     static void Write(JsonStreamWriter& writer, const JsonSensorsConfig& config);
+// };
+// Handler provides GetResult() returning the configuration once parsed.
+template <typename T>
+struct JsonStream {
+    static void Write(JsonStreamWriter& writer, const T& config) {
+        writer.WriteValue(boost::json::value_from(config, Mrm::GetBoostExtPmr()));
+    }
+};
+
+template <typename T>
+concept JsonStreamParsable = requires { typename JsonStream<T>::Handler; };
+
+// Parses content written in chunks as it is read, the content is never
+// held as a whole. Configurations with a handler are built directly,
+// others through a document.
+template <typename T, bool = JsonStreamParsable<T>>
+class JsonStreamReader {
+private:
+    boost::json::stream_parser parser_;
+    boost::json::error_code ec_;
+
+public:
+    JsonStreamReader() {
+        parser_.reset(Mrm::GetBoostExtPmr());
+    }
+
+    bool Write(std::string_view chunk) {
+        if(!ec_)
+            parser_.write(chunk.data(), chunk.size(), ec_);
+
+        return !ec_;
+    }
+
+    pmr_unique_ptr<T> Finish() {
+        if(!ec_)
+            parser_.finish(ec_);
+
+        if(ec_)
+            return nullptr;
+
+        try {
+            boost::json::value jv = parser_.release();
+
+            return make_unique_pmr<T>(Mrm::GetExtPmr(), boost::json::value_to<T>(jv));
+        } catch(...) {
+            return nullptr;
+        }
+    }
+};
+
+template <typename T>
+class JsonStreamReader<T, true> {
+private:
+    boost::json::basic_parser<typename JsonStream<T>::Handler> parser_;
+    boost::json::error_code ec_;
+
+    static bool IsWhitespace(std::string_view str) {
+        return str.find_first_not_of(" \t\r\n") == std::string_view::npos;
+    }
+
+public:
+    JsonStreamReader() : parser_(boost::json::parse_options()) {}
+
+    bool Write(std::string_view chunk) {
+        if(ec_)
+            return false;
+
+        size_t consumed = parser_.done()
+            ? 0
+            : parser_.write_some(true, chunk.data(), chunk.size(), ec_);
+
+        // Only whitespace may follow the document
+        if(!ec_ && !IsWhitespace(chunk.substr(consumed)))
+            ec_ = boost::json::error::extra_data;
+
+        return !ec_;
+    }
+
+    pmr_unique_ptr<T> Finish() {
+        if(!ec_ && !parser_.done())
+            parser_.write_some(false, "", 0, ec_);
+
+        if(ec_ || !parser_.done())
+            return nullptr;
+
+        return make_unique_pmr<T>(Mrm::GetExtPmr(), std::move(parser_.handler().GetResult()));
+    }
+};
+
+} // namespace eerie_leap::configuration::json
@@ -148,6 +148,8 @@ public:
 
         return std::move(task_load_.result);
     }
+
+    const std::shared_ptr<IFsService>& GetFsService() const { return fs_service_; }
 };
 
 } // namespace eerie_leap::configuration::services
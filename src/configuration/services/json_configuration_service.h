@@ -5,6 +5,7 @@
 #include <string>
 #include <optional>
 #include <span>
+#include <filesystem>
 
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
@@ -12,6 +13,8 @@
 
 #include "utilities/memory/heap_allocator.h"
 #include "subsys/fs/services/i_fs_service.h"
+#include "subsys/fs/services/fs_service_stream_buf.h"
+#include "subsys/fs/utilities/fs_checksum.h"
 
 #include "configuration/json/json_serializer.h"
 
@@ -22,6 +25,7 @@ namespace eerie_leap::configuration::services {
 using namespace eerie_leap::utilities::memory;
 using namespace eerie_leap::configuration::json;
 using namespace eerie_leap::subsys::fs::services;
+using namespace eerie_leap::subsys::fs::utilities;
 
 template <typename T>
 class JsonConfigurationService {
@@ -34,6 +38,8 @@ private:
 
     const std::string configuration_file_path_ = configuration_dir_ + "/" + configuration_name_ + ".json";
 
+    static constexpr size_t CHECKSUM_CHUNK_SIZE = 1024;
+
     struct SaveTask {
         k_work work;
         JsonConfigurationService<T>* instance;
@@ -44,15 +50,23 @@ private:
     struct LoadTask {
         k_work work;
         JsonConfigurationService<T>* instance;
+        std::optional<uint32_t> known_checksum;
         std::optional<LoadedConfig<T>> result;
     };
 
+    struct ChecksumTask {
+        k_work work;
+        JsonConfigurationService<T>* instance;
+        std::optional<uint32_t> result;
+    };
+
     // NOTE: Save and Load perfomed on the System WorkQueue thread
     // to eliminates cases when configuration updated from some thread
     // wich will require that thread to have enough stack size for the operation.
     k_work_sync work_sync_;
     SaveTask task_save_;
     LoadTask task_load_;
+    ChecksumTask task_checksum_;
 
     bool SaveProcessor(T* configuration) {
         if(!fs_service_)
@@ -60,17 +74,40 @@ private:
 
         LOG_MODULE_DECLARE(configuration_service_logger);
 
-        auto json_str = serializer_->Serialize(*configuration);
+        // NOTE: Written through the stream buffer as it is serialized,
+        // configurations are never held in memory as text. A temporary
+        // file replaces the configuration once complete, so a failed save
+        // leaves the previous configuration intact.
+        std::string temp_file_path = configuration_file_path_ + ".tmp";
+        bool is_written = false;
+
+        try {
+            FsServiceStreamBuf stream_buf(fs_service_.get(), temp_file_path, FsServiceStreamBuf::OpenMode::Write);
+            if(!stream_buf.is_open()) {
+                LOG_ERR("Failed to open configuration file %s.", temp_file_path.c_str());
+                return false;
+            }
+
+            bool is_serialized = serializer_->Serialize(*configuration, stream_buf);
+            is_written = stream_buf.close() && is_serialized;
+        } catch(const std::exception& e) {
+            LOG_ERR("Failed to write configuration file %s: %s", temp_file_path.c_str(), e.what());
+        }
+
+        if(!is_written || !fs_service_->RenameFile(temp_file_path, configuration_file_path_)) {
+            LOG_ERR("Failed to save configuration %s.", configuration_file_path_.c_str());
+
+            if(fs_service_->IsAvailable() && fs_service_->Exists(temp_file_path))
+                fs_service_->DeleteFile(temp_file_path);
 
-        if(json_str.empty()) {
-            LOG_ERR("Failed to serialize configuration %s.", configuration_file_path_.c_str());
             return false;
         }
 
-        return fs_service_->WriteFile(configuration_file_path_, json_str.c_str(), json_str.size());
+        return true;
     }
 
-    std::optional<LoadedConfig<T>> LoadProcessor() {
+    // Checksum of the file read in chunks, the file is never held in memory as a whole
+    std::optional<uint32_t> ChecksumProcessor() {
         if(!fs_service_)
             return std::nullopt;
 
@@ -81,25 +118,70 @@ private:
             return std::nullopt;
         }
 
-        size_t buffer_size = fs_service_->GetFileSize(configuration_file_path_);
-        std::pmr::vector<uint8_t> buffer(buffer_size, Mrm::GetExtPmr());
-        size_t out_len = 0;
+        return FsChecksum::GetFileChecksum(*fs_service_, configuration_file_path_);
+    }
 
-        if (!fs_service_->ReadFile(configuration_file_path_, buffer.data(), buffer_size, out_len)) {
-            LOG_ERR("Failed to read configuration file %s.", configuration_file_path_.c_str());
+    std::optional<LoadedConfig<T>> LoadProcessor(std::optional<uint32_t> known_checksum) {
+        if(!fs_service_)
+            return std::nullopt;
+
+        LOG_MODULE_DECLARE(configuration_service_logger);
+
+        if (!fs_service_->Exists(configuration_file_path_)) {
+            LOG_ERR("Configuration file %s does not exist.", configuration_file_path_.c_str());
             return std::nullopt;
         }
 
-        std::string_view json_str(reinterpret_cast<const char*>(buffer.data()), out_len);
-        auto configuration = serializer_->Deserialize(json_str);
+        // NOTE: File is read a second time when it has changed, which is
+        // rare compared to loads at boot finding it unchanged.
+        if(known_checksum.has_value()) {
+            auto checksum = ChecksumProcessor();
+            if(!checksum.has_value())
+                return std::nullopt;
+
+            if(checksum.value() == known_checksum.value()) {
+                LOG_INF("%s configuration unchanged, skipped.", configuration_file_path_.c_str());
+
+                return LoadedConfig<T> {
+                    .config = nullptr,
+                    .checksum = checksum.value()
+                };
+            }
+        }
+
+        // Parsed in chunks as it is read, the checksum is taken on the way
+        auto reader = serializer_->CreateReader();
+        std::pmr::vector<char> chunk(CHECKSUM_CHUNK_SIZE, Mrm::GetExtPmr());
+        uint32_t crc = 0;
+
+        try {
+            FsServiceStreamBuf stream_buf(fs_service_.get(), configuration_file_path_, FsServiceStreamBuf::OpenMode::Read);
+            if(!stream_buf.is_open()) {
+                LOG_ERR("Failed to open configuration file %s.", configuration_file_path_.c_str());
+                return std::nullopt;
+            }
+
+            std::streamsize read = 0;
+            while((read = stream_buf.sgetn(chunk.data(), static_cast<std::streamsize>(chunk.size()))) > 0) {
+                crc = crc32_ieee_update(crc, reinterpret_cast<const uint8_t*>(chunk.data()), static_cast<size_t>(read));
+
+                if(!reader.Write(std::string_view(chunk.data(), static_cast<size_t>(read))))
+                    break;
+            }
+
+            stream_buf.close();
+        } catch(const std::exception& e) {
+            LOG_ERR("Failed to read configuration file %s: %s", configuration_file_path_.c_str(), e.what());
+            return std::nullopt;
+        }
+
+        auto configuration = reader.Finish();
 
         if (configuration == nullptr) {
             LOG_ERR("Failed to deserialize configuration %s.", configuration_file_path_.c_str());
             return std::nullopt;
         }
 
-        uint32_t crc = crc32_ieee(buffer.data(), buffer_size);
-
         LoadedConfig<T> loaded_config {
             .config = std::move(configuration),
             .checksum = crc
@@ -119,7 +201,13 @@ private:
     static void WorkTaskLoad(k_work* work) {
         LoadTask* task = CONTAINER_OF(work, LoadTask, work);
 
-        task->result = task->instance->LoadProcessor();
+        task->result = task->instance->LoadProcessor(task->known_checksum);
+    }
+
+    static void WorkTaskChecksum(k_work* work) {
+        ChecksumTask* task = CONTAINER_OF(work, ChecksumTask, work);
+
+        task->result = task->instance->ChecksumProcessor();
     }
 
 public:
@@ -132,6 +220,9 @@ public:
         task_load_.instance = this;
         k_work_init(&task_load_.work, WorkTaskLoad);
 
+        task_checksum_.instance = this;
+        k_work_init(&task_checksum_.work, WorkTaskChecksum);
+
         serializer_ = std::make_unique<JsonSerializer<T>>();
 
         if(!fs_service_)
@@ -153,12 +244,22 @@ public:
         return task_save_.result;
     }
 
-    std::optional<LoadedConfig<T>> Load() {
+    // With a known checksum, the file is deserialized only if its checksum
+    // differs, otherwise the loaded config holds the checksum only.
+    std::optional<LoadedConfig<T>> Load(std::optional<uint32_t> known_checksum = std::nullopt) {
+        task_load_.known_checksum = known_checksum;
         k_work_submit(&task_load_.work);
         k_work_flush(&task_load_.work, &work_sync_);
 
         return std::move(task_load_.result);
     }
+
+    std::optional<uint32_t> LoadChecksum() {
+        k_work_submit(&task_checksum_.work);
+        k_work_flush(&task_checksum_.work, &work_sync_);
+
+        return task_checksum_.result;
+    }
 };
 
 } // namespace eerie_leap::configuration::services
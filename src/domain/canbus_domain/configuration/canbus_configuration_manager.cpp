@@ -42,7 +42,7 @@ bool CanbusConfigurationManager::ApplyJsonConfiguration() {
     if(!json_configuration_service_->IsAvailable())
         return false;
 
-    auto json_config_loaded = json_configuration_service_->Load();
+    auto json_config_loaded = json_configuration_service_->Load(json_config_checksum_);
     if(json_config_loaded.has_value()) {
         if(json_config_loaded->checksum == json_config_checksum_)
             return true;
@@ -71,15 +71,15 @@ bool CanbusConfigurationManager::Update(const CanbusConfiguration& configuration
             auto json_config = json_parser_->Serialize(configuration);
             json_configuration_service_->Save(json_config.get());
 
-            auto json_config_loaded = json_configuration_service_->Load();
-            if(!json_config_loaded.has_value()) {
+            auto json_config_checksum = json_configuration_service_->LoadChecksum();
+            if(!json_config_checksum.has_value()) {
                 LOG_ERR("Failed to load newly updated CAN Bus JSON configuration.");
                 return false;
             }
 
             LOG_INF("CAN Bus JSON configuration updated successfully.");
 
-            json_config_checksum_ = json_config_loaded->checksum;
+            json_config_checksum_ = json_config_checksum.value();
         }
 
         auto cbor_config = cbor_parser_->Serialize(configuration);
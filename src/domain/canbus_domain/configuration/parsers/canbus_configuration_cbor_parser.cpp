@@ -1,7 +1,9 @@
 #include <utility>
 #include <optional>
+#include <span>
 
 #include "utilities/cbor/cbor_helpers.hpp"
+#include "subsys/fs/services/resource_loader.h"
 
 #include "canbus_configuration_validator.h"
 #include "canbus_configuration_parser_helpers.hpp"
@@ -27,6 +29,7 @@ pmr_unique_ptr<CborCanbusConfig> CanbusConfigurationCborParser::Serialize(const
         channel_config.bus_channel = bus_channel;
         channel_config.bitrate = channel_configuration.bitrate;
         channel_config.data_bitrate = channel_configuration.data_bitrate;
+        channel_config.detected_bitrate = channel_configuration.detected_bitrate;
         channel_config.dbc_file_path = CborHelpers::ToZcborString(channel_configuration.dbc_file_path);
 
         for(const auto& message_configuration : channel_configuration.message_configurations) {
@@ -66,6 +69,7 @@ pmr_unique_ptr<CborCanbusConfig> CanbusConfigurationCborParser::Serialize(const
 
 pmr_unique_ptr<CanbusConfiguration> CanbusConfigurationCborParser::Deserialize(std::pmr::memory_resource* mr, const CborCanbusConfig& config) {
     auto configuration = make_unique_pmr<CanbusConfiguration>(mr);
+    ResourceLoader resource_loader(sd_fs_service_, "canbus");
 
     for(const auto& canbus_config : config.CborCanChannelConfig_m) {
         CanChannelConfiguration channel_configuration(std::allocator_arg, mr);
@@ -75,10 +79,16 @@ pmr_unique_ptr<CanbusConfiguration> CanbusConfigurationCborParser::Deserialize(s
         channel_configuration.bus_channel = static_cast<uint8_t>(canbus_config.bus_channel);
         channel_configuration.bitrate = canbus_config.bitrate;
         channel_configuration.data_bitrate = canbus_config.data_bitrate;
+        channel_configuration.detected_bitrate = canbus_config.detected_bitrate;
         channel_configuration.dbc_file_path = CborHelpers::ToPmrString(mr, canbus_config.dbc_file_path);
 
-        if(sd_fs_service_ != nullptr && !channel_configuration.dbc_file_path.empty())
-            CanbusConfigurationParserHelpers::LoadDbcConfiguration(sd_fs_service_.get(), channel_configuration);
+        if(!channel_configuration.dbc_file_path.empty()) {
+            resource_loader.Add(
+                channel_configuration.dbc_file_path,
+                [dbc = channel_configuration.dbc, dbc_file_path = std::string(channel_configuration.dbc_file_path)](std::span<const uint8_t> content) {
+                    CanbusConfigurationParserHelpers::LoadDbcConfiguration(content, *dbc, dbc_file_path);
+                });
+        }
 
         for(const auto& message_config : canbus_config.CborCanMessageConfig_m) {
             auto message_configuration = make_shared_pmr<CanMessageConfiguration>(mr);
@@ -104,22 +114,16 @@ pmr_unique_ptr<CanbusConfiguration> CanbusConfigurationCborParser::Deserialize(s
                 message_configuration->signal_configurations.push_back(std::move(signal_configuration));
             }
 
-            if(sd_fs_service_ != nullptr
-                && sd_fs_service_->IsAvailable()
-                && !message_configuration->script_path.empty()
-                && sd_fs_service_->Exists(message_configuration->script_path)) {
-
-                size_t script_size = sd_fs_service_->GetFileSize(message_configuration->script_path);
+            if(!message_configuration->script_path.empty()) {
+                resource_loader.Add(
+                    message_configuration->script_path,
+                    [message_configuration](std::span<const uint8_t> source) {
+                        if(source.empty())
+                            return;
 
-                if(script_size != 0) {
-                    std::pmr::vector<uint8_t> buffer(script_size, Mrm::GetExtPmr());
-
-                    size_t out_len = 0;
-                    sd_fs_service_->ReadFile(message_configuration->script_path, buffer.data(), script_size, out_len);
-
-                    message_configuration->lua_script = std::make_shared<LuaScript>(LuaScript::CreateExt());
-                    message_configuration->lua_script->Load(std::span<const uint8_t>(buffer.data(), buffer.size()));
-                }
+                        message_configuration->lua_script = std::make_shared<LuaScript>(LuaScript::CreateExt());
+                        message_configuration->lua_script->Load(source);
+                    });
             }
 
             channel_configuration.message_configurations.push_back(std::move(message_configuration));
@@ -137,6 +141,8 @@ pmr_unique_ptr<CanbusConfiguration> CanbusConfigurationCborParser::Deserialize(s
         ? std::optional<uint8_t>(config.com_bus_channel)
         : std::nullopt;
 
+    resource_loader.Load();
+
     CanbusConfigurationValidator::Validate(*configuration, sd_fs_service_.get());
 
     return configuration;
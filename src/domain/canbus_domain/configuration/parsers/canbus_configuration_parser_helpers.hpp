@@ -1,8 +1,11 @@
 #pragma once
 
+#include <span>
 #include <stdexcept>
+#include <string>
 
 #include "utilities/memory/memory_resource_manager.h"
+#include "utilities/stream/span_stream_buf.hpp"
 #include "configuration/cbor/cbor_canbus_config/cbor_canbus_config.h"
 #include "subsys/fs/services/i_fs_service.h"
 #include "subsys/fs/services/fs_service_stream_buf.h"
@@ -11,6 +14,7 @@
 namespace eerie_leap::domain::canbus_domain::configuration::parsers {
 
 using namespace eerie_leap::utilities::memory;
+using namespace eerie_leap::utilities::stream;
 using namespace eerie_leap::subsys::fs::services;
 using namespace eerie_leap::domain::canbus_domain::models;
 
@@ -30,6 +34,14 @@ public:
                 throw std::runtime_error("Failed to load DBC file. " + std::string(channel_configuration.dbc_file_path));
         }
     }
+
+    // Loads DBC file content already read into memory
+    static void LoadDbcConfiguration(std::span<const uint8_t> content, Dbc& dbc, const std::string& dbc_file_path) {
+        SpanStreamBuf stream_buf(content);
+
+        if(!dbc.LoadDbcFile(stream_buf))
+            throw std::runtime_error("Failed to load DBC file. " + dbc_file_path);
+    }
 };
 
 } // namespace eerie_leap::domain::canbus_domain::configuration::parsers
@@ -25,6 +25,8 @@ struct CanChannelConfiguration {
     uint8_t bus_channel = 0;
     uint32_t bitrate = 0;
     uint32_t data_bitrate = 0;
+    // NOTE: Last bitrate found by auto-detection, tried first on next boot
+    uint32_t detected_bitrate = 0;
     std::pmr::string dbc_file_path;
     std::pmr::vector<std::shared_ptr<CanMessageConfiguration>> message_configurations;
 
@@ -47,6 +49,7 @@ struct CanChannelConfiguration {
         bus_channel(other.bus_channel),
         bitrate(other.bitrate),
         data_bitrate(other.data_bitrate),
+        detected_bitrate(other.detected_bitrate),
         dbc_file_path(std::move(other.dbc_file_path), alloc),
         message_configurations(std::move(other.message_configurations), alloc),
         dbc(std::move(other.dbc)) {}
@@ -20,6 +20,7 @@ CanbusService::CanbusService(
             channel_configuration.bitrate,
             channel_configuration.data_bitrate,
             channel_configuration.is_extended_id);
+        canbus->SetBitrateHint(channel_configuration.detected_bitrate);
 
         if(!canbus->Initialize()) {
             LOG_ERR("Failed to initialize CAN channel %d.", bus_channel);
@@ -34,6 +35,10 @@ CanbusService::CanbusService(
 
         ConfigureUserSignals(channel_configuration);
     }
+
+    gateway_ = std::make_shared<CanbusGateway>([this](uint8_t bus_channel) {
+        return GetCanbus(bus_channel);
+    });
 }
 
 std::shared_ptr<Canbus> CanbusService::GetCanbus(uint8_t bus_channel) const {
@@ -70,9 +75,20 @@ std::shared_ptr<Canbus> CanbusService::GetComCanbus() const {
 
 void CanbusService::BitrateUpdated(uint8_t bus_channel, uint32_t bitrate) {
     auto canbus_configuration = canbus_configuration_manager_->Get();
-    bool is_bus_channel_valid = canbus_configuration->channel_configurations.contains(bus_channel);
+    if(!canbus_configuration->channel_configurations.contains(bus_channel)) {
+        LOG_ERR("Failed to update bitrate for bus channel %d.", bus_channel);
+        return;
+    }
+
+    auto& channel_configuration = canbus_configuration->channel_configurations.at(bus_channel);
+
+    // Same bitrate as on last boot, nothing to persist
+    if(channel_configuration.detected_bitrate == bitrate)
+        return;
+
+    channel_configuration.detected_bitrate = bitrate;
 
-    if(is_bus_channel_valid && canbus_configuration_manager_->Update(*canbus_configuration))
+    if(canbus_configuration_manager_->Update(*canbus_configuration))
         LOG_INF("Bitrate for bus channel %d updated to %d bps.", bus_channel, bitrate);
     else
         LOG_ERR("Failed to update bitrate for bus channel %d.", bus_channel);
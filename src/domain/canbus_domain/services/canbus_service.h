@@ -8,6 +8,7 @@
 #include "domain/canbus_domain/models/can_channel_configuration.h"
 #include "subsys/fs/services/i_fs_service.h"
 #include "subsys/canbus/canbus.h"
+#include "subsys/canbus/canbus_gateway.h"
 #include "subsys/dbc/dbc.h"
 #include "domain/canbus_domain/configuration/canbus_configuration_manager.h"
 
@@ -23,6 +24,7 @@ private:
     std::shared_ptr<CanbusConfigurationManager> canbus_configuration_manager_;
 
     std::unordered_map<uint8_t, std::shared_ptr<Canbus>> canbuses_;
+    std::shared_ptr<CanbusGateway> gateway_;
 
     void BitrateUpdated(uint8_t bus_channel, uint32_t bitrate);
     void ConfigureUserSignals(const CanChannelConfiguration& channel_configuration);
@@ -35,6 +37,7 @@ public:
     [[nodiscard]] std::shared_ptr<Canbus> GetCanbus(uint8_t bus_channel) const;
     [[nodiscard]] std::shared_ptr<Canbus> GetComCanbus() const;
     [[nodiscard]] const CanChannelConfiguration* GetChannelConfiguration(uint8_t bus_channel) const;
+    [[nodiscard]] std::shared_ptr<CanbusGateway> GetGateway() const { return gateway_; }
 };
 
 } // namespace eerie_leap::domain::canbus_domain::services
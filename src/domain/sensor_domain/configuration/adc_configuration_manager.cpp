@@ -54,7 +54,7 @@ bool AdcConfigurationManager::ApplyJsonConfiguration() {
     if(!json_configuration_service_->IsAvailable())
         return false;
 
-    auto json_config_loaded = json_configuration_service_->Load();
+    auto json_config_loaded = json_configuration_service_->Load(json_config_checksum_);
     if(json_config_loaded.has_value()) {
         if(json_config_loaded->checksum == json_config_checksum_)
             return true;
@@ -85,15 +85,15 @@ bool AdcConfigurationManager::Update(const AdcConfiguration& configuration, bool
             auto json_config = json_parser_->Serialize(configuration);
             json_configuration_service_->Save(json_config.get());
 
-            auto json_config_loaded = json_configuration_service_->Load();
-            if(!json_config_loaded.has_value()) {
+            auto json_config_checksum = json_configuration_service_->LoadChecksum();
+            if(!json_config_checksum.has_value()) {
                 LOG_ERR("Failed to load newly updated JSON configuration.");
                 return false;
             }
 
             LOG_INF("JSON configuration updated successfully.");
 
-            json_config_checksum_ = json_config_loaded->checksum;
+            json_config_checksum_ = json_config_checksum.value();
         }
 
         auto cbor_config = cbor_parser_->Serialize(configuration);
@@ -1,11 +1,14 @@
+#include <algorithm>
 #include <utility>
 
 #include <zephyr/kernel.h>
+#include <zephyr/sys/crc.h>
 
 #include "utilities/cbor/cbor_helpers.hpp"
 #include "utilities/voltage_interpolator/linear_voltage_interpolator.hpp"
 #include "utilities/voltage_interpolator/cubic_spline_voltage_interpolator.hpp"
 #include "subsys/lua_script/lua_script.h"
+#include "subsys/fs/services/resource_loader.h"
 #include "domain/sensor_domain/utilities/sensors_order_resolver.h"
 #include "sensor_validator.h"
 
@@ -102,13 +105,67 @@ pmr_unique_ptr<CborSensorsConfig> SensorsCborParser::Serialize(
     return sensors_config;
 }
 
+// NOTE: Called on a resource loader worker, only touches its own sensor
+void SensorsCborParser::LoadScript(
+    std::pmr::memory_resource* mr,
+    Sensor& sensor,
+    uint16_t sensor_index,
+    std::span<const uint8_t> source,
+    const SensorsRuntimeImage* runtime_image,
+    LoadedScript& loaded_script) {
+
+    sensor.configuration.script_checksum = crc32_ieee(source.data(), source.size());
+
+    if(source.empty()) {
+        loaded_script.is_from_image = true;
+        return;
+    }
+
+    SensorsRuntimeImageScript script = {
+        .sensor_index = sensor_index,
+        .source_checksum = sensor.configuration.script_checksum.value(),
+        .bytecode = std::pmr::vector<uint8_t>(Mrm::GetExtPmr()) };
+
+    auto bytecode = runtime_image != nullptr && runtime_image->IsLoaded()
+        ? runtime_image->GetScriptBytecode(sensor_index, script.source_checksum)
+        : std::nullopt;
+
+    sensor.configuration.lua_script = make_shared_pmr<LuaScript>(mr, LuaScript::CreateExt());
+
+    if(bytecode.has_value()) {
+        sensor.configuration.lua_script->Load(bytecode.value());
+        script.bytecode.assign(bytecode->begin(), bytecode->end());
+        loaded_script.is_from_image = true;
+    } else {
+        sensor.configuration.lua_script->Load(source, &script.bytecode);
+    }
+
+    if(!script.bytecode.empty())
+        loaded_script.script = std::move(script);
+}
+
 std::vector<std::shared_ptr<Sensor>> SensorsCborParser::Deserialize(
     std::pmr::memory_resource* mr,
     const CborSensorsConfig& sensors_config,
     uint32_t gpio_channel_count,
-    uint32_t adc_channel_count) {
+    uint32_t adc_channel_count,
+    SensorsRuntimeImage* runtime_image,
+    uint32_t config_checksum) {
 
-    SensorsOrderResolver order_resolver;
+    SensorsRuntimeImageKey image_key = {
+        .config_checksum = config_checksum,
+        .sensor_count = static_cast<uint16_t>(sensors_config.CborSensorConfig_m.size()),
+        .gpio_channel_count = static_cast<uint16_t>(gpio_channel_count),
+        .adc_channel_count = static_cast<uint16_t>(adc_channel_count)
+    };
+
+    bool is_image_valid = runtime_image != nullptr && runtime_image->Load(image_key);
+
+    std::vector<std::shared_ptr<Sensor>> configured_sensors;
+    configured_sensors.reserve(sensors_config.CborSensorConfig_m.size());
+
+    ResourceLoader resource_loader(sd_fs_service_, "sensors");
+    std::vector<LoadedScript> loaded_scripts(sensors_config.CborSensorConfig_m.size());
 
     for(const auto& sensor_config : sensors_config.CborSensorConfig_m) {
         auto sensor = make_shared_pmr<Sensor>(mr, CborHelpers::ToPmrString(mr, sensor_config.id));
@@ -124,22 +181,16 @@ std::vector<std::shared_ptr<Sensor>> SensorsCborParser::Deserialize(
         sensor->configuration.UnwrapConnectionString();
 
         sensor->configuration.script_path = CborHelpers::ToPmrString(mr, sensor_config.configuration.script_path);
-        if(sd_fs_service_ != nullptr
-            && sd_fs_service_->IsAvailable()
-            && !sensor->configuration.script_path.empty()
-            && sd_fs_service_->Exists(sensor->configuration.script_path)) {
-
-            size_t script_size = sd_fs_service_->GetFileSize(sensor->configuration.script_path);
-
-            if(script_size != 0) {
-                std::pmr::vector<uint8_t> buffer(script_size, Mrm::GetExtPmr());
+        if(!sensor->configuration.script_path.empty()) {
+            auto sensor_index = static_cast<uint16_t>(configured_sensors.size());
 
-                size_t out_len = 0;
-                sd_fs_service_->ReadFile(sensor->configuration.script_path, buffer.data(), script_size, out_len);
-
-                sensor->configuration.lua_script = make_shared_pmr<LuaScript>(mr, LuaScript::CreateExt());
-                sensor->configuration.lua_script->Load(std::span<const uint8_t>(buffer.data(), buffer.size()));
-            }
+            resource_loader.Add(
+                sensor->configuration.script_path,
+                [mr, sensor = sensor.get(), sensor_index, runtime_image, &loaded_script = loaded_scripts[sensor_index]](std::span<const uint8_t> source) {
+                    LoadScript(mr, *sensor, sensor_index, source, runtime_image, loaded_script);
+                });
+        } else {
+            loaded_scripts[configured_sensors.size()].is_from_image = true;
         }
 
         sensor->configuration.sampling_rate_ms = sensor_config.configuration.sampling_rate_ms > 0
@@ -186,12 +237,48 @@ std::vector<std::shared_ptr<Sensor>> SensorsCborParser::Deserialize(
 
         sensor->metadata.description = CborHelpers::ToPmrString(mr, sensor_config.metadata.description);
 
-        order_resolver.AddSensor(std::move(sensor));
+        configured_sensors.push_back(std::move(sensor));
+    }
+
+    resource_loader.Load();
+
+    std::vector<SensorsRuntimeImageScript> scripts;
+    for(auto& loaded_script : loaded_scripts) {
+        if(!loaded_script.is_from_image)
+            is_image_valid = false;
+
+        if(loaded_script.script.has_value())
+            scripts.push_back(std::move(loaded_script.script.value()));
     }
 
+    // NOTE: Image is only saved for validated sensors
+    if(is_image_valid) {
+        std::vector<std::shared_ptr<Sensor>> sensors;
+        sensors.reserve(configured_sensors.size());
+
+        for(uint16_t sensor_index : runtime_image->GetOrder())
+            sensors.push_back(configured_sensors[sensor_index]);
+
+        return sensors;
+    }
+
+    SensorsOrderResolver order_resolver;
+    for(const auto& sensor : configured_sensors)
+        order_resolver.AddSensor(sensor);
+
     auto sensors = order_resolver.GetProcessingOrder();
     SensorValidator::Validate(sensors, sd_fs_service_.get(), gpio_channel_count, adc_channel_count);
 
+    // NOTE: Sensors were added in configuration order, indexes only match
+    // it if no sensor was ignored as a duplicate
+    const auto& order_indexes = order_resolver.GetProcessingOrderIndexes();
+
+    if(runtime_image != nullptr && order_indexes.size() == configured_sensors.size()) {
+        std::vector<uint16_t> order(order_indexes.begin(), order_indexes.end());
+
+        runtime_image->Save(image_key, order, scripts);
+    }
+
     return sensors;
 }
 
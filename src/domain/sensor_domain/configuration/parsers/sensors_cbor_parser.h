@@ -2,23 +2,40 @@
 
 #include <vector>
 #include <memory>
+#include <optional>
 #include <span>
 
 #include "utilities/memory/memory_resource_manager.h"
 #include "subsys/fs/services/i_fs_service.h"
 #include "configuration/cbor/cbor_sensors_config/cbor_sensors_config.h"
 #include "domain/sensor_domain/models/sensor.h"
+#include "domain/sensor_domain/utilities/sensors_runtime_image.h"
 
 namespace eerie_leap::domain::sensor_domain::configuration::parsers {
 
 using namespace eerie_leap::utilities::memory;
 using namespace eerie_leap::subsys::fs::services;
 using namespace eerie_leap::domain::sensor_domain::models;
+using namespace eerie_leap::domain::sensor_domain::utilities;
 
 class SensorsCborParser {
 private:
+    struct LoadedScript {
+        // False if compiled from source
+        bool is_from_image = false;
+        std::optional<SensorsRuntimeImageScript> script;
+    };
+
     std::shared_ptr<IFsService> sd_fs_service_;
 
+    static void LoadScript(
+        std::pmr::memory_resource* mr,
+        Sensor& sensor,
+        uint16_t sensor_index,
+        std::span<const uint8_t> source,
+        const SensorsRuntimeImage* runtime_image,
+        LoadedScript& loaded_script);
+
 public:
     explicit SensorsCborParser(std::shared_ptr<IFsService> sd_fs_service);
 
@@ -26,11 +43,17 @@ public:
         const std::vector<std::shared_ptr<Sensor>>& sensors,
         uint32_t gpio_channel_count,
         uint32_t adc_channel_count);
+    // With a runtime image built from the same configuration, scripts are
+    // loaded from their bytecode, and ordering and validation are skipped.
+    // Otherwise the image is rebuilt once sensors are validated.
+    // Scripts are read and compiled by the resource loader.
     std::vector<std::shared_ptr<Sensor>> Deserialize(
         std::pmr::memory_resource* mr,
         const CborSensorsConfig& sensors_config,
         uint32_t gpio_channel_count,
-        uint32_t adc_channel_count);
+        uint32_t adc_channel_count,
+        SensorsRuntimeImage* runtime_image = nullptr,
+        uint32_t config_checksum = 0);
 };
 
 } // namespace eerie_leap::domain::sensor_domain::configuration::parsers
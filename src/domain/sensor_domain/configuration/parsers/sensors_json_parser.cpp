@@ -1,3 +1,5 @@
+#include <zephyr/sys/crc.h>
+
 #include "utilities/voltage_interpolator/interpolation_method.h"
 #include "utilities/voltage_interpolator/linear_voltage_interpolator.hpp"
 #include "utilities/voltage_interpolator/cubic_spline_voltage_interpolator.hpp"
@@ -123,6 +125,7 @@ std::vector<std::shared_ptr<Sensor>> SensorsJsonParser::Deserialize(
 
                 size_t out_len = 0;
                 sd_fs_service_->ReadFile(sensor->configuration.script_path, buffer.data(), script_size, out_len);
+                sensor->configuration.script_checksum = crc32_ieee(buffer.data(), buffer.size());
 
                 sensor->configuration.lua_script = make_shared_pmr<LuaScript>(mr, LuaScript::CreateExt());
                 sensor->configuration.lua_script->Load(std::span<const uint8_t>(buffer.data(), buffer.size()));
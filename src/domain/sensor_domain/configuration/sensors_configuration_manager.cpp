@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <utility>
 
 #include <zephyr/logging/log.h>
@@ -22,6 +23,9 @@ SensorsConfigurationManager::SensorsConfigurationManager(
 
     cbor_parser_ = std::make_unique<SensorsCborParser>(sd_fs_service_);
     json_parser_ = std::make_unique<SensorsJsonParser>(sd_fs_service_);
+    runtime_image_ = std::make_unique<SensorsRuntimeImage>(
+        cbor_configuration_service_->GetFsService(),
+        "config/sensors_runtime.img");
 
     const std::vector<std::shared_ptr<Sensor>>* sensors = nullptr;
 
@@ -51,7 +55,7 @@ bool SensorsConfigurationManager::ApplyJsonConfiguration() {
     if(!json_configuration_service_->IsAvailable())
         return false;
 
-    auto json_config_loaded = json_configuration_service_->Load();
+    auto json_config_loaded = json_configuration_service_->Load(json_config_checksum_);
     if(json_config_loaded.has_value()) {
         if(json_config_loaded->checksum == json_config_checksum_)
             return true;
@@ -89,15 +93,15 @@ bool SensorsConfigurationManager::Update(const std::vector<std::shared_ptr<Senso
                 adc_channel_count_);
             json_configuration_service_->Save(json_config.get());
 
-            auto json_config_loaded = json_configuration_service_->Load();
-            if(!json_config_loaded.has_value()) {
+            auto json_config_checksum = json_configuration_service_->LoadChecksum();
+            if(!json_config_checksum.has_value()) {
                 LOG_ERR("Failed to load newly updated JSON configuration.");
                 return false;
             }
 
             LOG_INF("JSON configuration updated successfully.");
 
-            json_config_checksum_ = json_config_loaded->checksum;
+            json_config_checksum_ = json_config_checksum.value();
         }
 
         auto cbor_config = cbor_parser_->Serialize(
@@ -126,15 +130,51 @@ const std::vector<std::shared_ptr<Sensor>>* SensorsConfigurationManager::Get(boo
 
     auto cbor_config = std::move(cbor_config_data.value().config);
 
-    sensors_.clear();
-    sensors_ = cbor_parser_->Deserialize(
-        Mrm::GetExtPmr(), *cbor_config, gpio_channel_count_, adc_channel_count_);
+    auto sensors = cbor_parser_->Deserialize(
+        Mrm::GetExtPmr(),
+        *cbor_config,
+        gpio_channel_count_,
+        adc_channel_count_,
+        runtime_image_.get(),
+        cbor_config_data.value().checksum);
+    ReuseUnchangedSensors(sensors);
+
+    sensors_ = std::move(sensors);
 
     json_config_checksum_ = cbor_config->json_config_checksum;
 
     return &sensors_;
 }
 
+void SensorsConfigurationManager::ReuseUnchangedSensors(std::vector<std::shared_ptr<Sensor>>& sensors) {
+    std::unordered_map<size_t, uint32_t> sensor_fingerprints;
+    sensor_fingerprints.reserve(sensors.size());
+
+    int reused_count = 0;
+    for(auto& sensor : sensors) {
+        uint32_t fingerprint = SensorFingerprint::Get(*sensor);
+        sensor_fingerprints.emplace(sensor->id_hash, fingerprint);
+
+        auto fingerprint_it = sensor_fingerprints_.find(sensor->id_hash);
+        if(fingerprint_it == sensor_fingerprints_.end() || fingerprint_it->second != fingerprint)
+            continue;
+
+        auto sensor_it = std::find_if(sensors_.begin(), sensors_.end(), [&sensor](const auto& loaded_sensor) {
+            return loaded_sensor->id_hash == sensor->id_hash;
+        });
+
+        if(sensor_it != sensors_.end()) {
+            sensor = *sensor_it;
+            reused_count++;
+        }
+    }
+
+    sensor_fingerprints_ = std::move(sensor_fingerprints);
+
+    if(!sensors_.empty())
+        LOG_INF("Sensors configuration loaded, %d of %zu sensors unchanged.", reused_count, sensors.size());
+}
+
 bool SensorsConfigurationManager::CreateDefaultConfiguration() {
     auto sensors = std::vector<std::shared_ptr<Sensor>>();
 
@@ -13,6 +13,8 @@
 #include "domain/sensor_domain/configuration/parsers/sensors_cbor_parser.h"
 #include "domain/sensor_domain/configuration/parsers/sensors_json_parser.h"
 #include "domain/sensor_domain/models/sensor.h"
+#include "domain/sensor_domain/utilities/sensors_runtime_image.h"
+#include "domain/sensor_domain/utilities/sensor_fingerprint.h"
 
 namespace eerie_leap::domain::sensor_domain::configuration {
 
@@ -31,8 +33,11 @@ private:
 
     std::unique_ptr<SensorsCborParser> cbor_parser_;
     std::unique_ptr<SensorsJsonParser> json_parser_;
+    std::unique_ptr<SensorsRuntimeImage> runtime_image_;
 
     std::vector<std::shared_ptr<Sensor>> sensors_;
+    // Fingerprints of loaded sensors by sensor ID hash
+    std::unordered_map<size_t, uint32_t> sensor_fingerprints_;
     int gpio_channel_count_;
     int adc_channel_count_;
 
@@ -40,6 +45,7 @@ private:
 
     bool ApplyJsonConfiguration();
     bool CreateDefaultConfiguration();
+    void ReuseUnchangedSensors(std::vector<std::shared_ptr<Sensor>>& sensors);
 
 public:
     SensorsConfigurationManager(
@@ -49,6 +55,8 @@ public:
         int gpio_channel_count,
         int adc_channel_count);
 
+    // NOTE: Sensors left unchanged by the update keep their instances,
+    // so processing can tell them apart from changed ones.
     bool Update(const std::vector<std::shared_ptr<Sensor>>& sensors, bool internal_only = false);
     const std::vector<std::shared_ptr<Sensor>>* Get(bool force_load = false);
 };
@@ -28,6 +28,8 @@ struct SensorConfiguration {
     std::optional<uint32_t> channel = std::nullopt;
     std::pmr::string connection_string;
     std::pmr::string script_path;
+    // CRC32 of the script source as loaded, not set for a missing script
+    std::optional<uint32_t> script_checksum = std::nullopt;
     // TODO: make optional
     std::optional<int> sampling_rate_ms = std::nullopt;
 
@@ -55,6 +57,7 @@ struct SensorConfiguration {
         channel(other.channel),
         connection_string(other.connection_string, alloc),
         script_path(other.script_path, alloc),
+        script_checksum(other.script_checksum),
         sampling_rate_ms(other.sampling_rate_ms),
         voltage_interpolator(std::move(other.voltage_interpolator)),
         expression_evaluator(std::move(other.expression_evaluator)),
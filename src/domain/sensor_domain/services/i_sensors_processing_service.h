@@ -11,6 +11,8 @@ public:
     virtual void Stop() = 0;
     virtual void Pause() = 0;
     virtual void Resume() = 0;
+    // Applies the current sensors configuration while running
+    virtual void Reload() = 0;
 };
 
 } // namespace eerie_leap::domain::sensor_domain::services
@@ -1,4 +1,5 @@
 #include <span>
+#include <unordered_set>
 
 #include "subsys/time/time_helpers.hpp"
 #include "subsys/lua_script/lua_script.h"
@@ -25,7 +26,8 @@ ProcessingIsrService::ProcessingIsrService(
         sensor_readings_frame_(std::move(sensor_readings_frame)),
         isr_sensor_reader_factory_(std::move(isr_sensor_reader_factory)),
         work_queue_thread_(std::move(work_queue_thread)),
-        reading_processors_(std::move(reading_processors)) {
+        reading_processors_(std::move(reading_processors)),
+        is_paused_(false) {
 
     collect_isr_reading_processor_ = std::make_unique<CollectIsrReadingProcessor>(sensor_readings_frame_);
 };
@@ -58,26 +60,31 @@ void ProcessingIsrService::ProcessSensor(const Sensor& sensor) {
     }
 }
 
-void ProcessingIsrService::Start() {
-    const auto* sensors = sensors_configuration_manager_->Get();
+void ProcessingIsrService::AddReader(std::shared_ptr<Sensor> sensor) {
+    if(sensor->configuration.GetReadingUpdateMethod() != SensorReadingUpdateMethod::ISR)
+        return;
 
-    readers_.clear();
-    for(const auto& sensor : *sensors) {
-        if(sensor->configuration.GetReadingUpdateMethod() != SensorReadingUpdateMethod::ISR)
-            continue;
+    auto reader = isr_sensor_reader_factory_->Create(
+        sensor,
+        work_queue_thread_,
+        [this](const Sensor& sensor) { ProcessSensor(sensor); });
 
-        auto reader = isr_sensor_reader_factory_->Create(
-            sensor,
-            work_queue_thread_,
-            [this](const Sensor& sensor) { ProcessSensor(sensor); });
+    if(reader == nullptr)
+        return;
 
-        if(reader == nullptr)
-            continue;
+    readers_.push_back({ .sensor = sensor, .reader = std::move(reader) });
 
-        readers_.push_back(std::move(reader));
+    LOG_INF("Created ISR reader for sensor: %s", sensor->id.c_str());
+}
 
-        LOG_INF("Created ISR reader for sensor: %s", sensor->id.c_str());
-    }
+void ProcessingIsrService::Start() {
+    const auto* sensors = sensors_configuration_manager_->Get();
+
+    readers_.clear();
+    for(const auto& sensor : *sensors)
+        AddReader(sensor);
+
+    is_paused_ = false;
 }
 
 void ProcessingIsrService::Stop() {
@@ -86,10 +93,40 @@ void ProcessingIsrService::Stop() {
 
 void ProcessingIsrService::Pause() {
     readers_.clear();
+    is_paused_ = true;
 }
 
 void ProcessingIsrService::Resume() {
     Start();
 }
 
+void ProcessingIsrService::Reload() {
+    // Readers are created from the configuration on Resume
+    if(is_paused_)
+        return;
+
+    const auto* sensors = sensors_configuration_manager_->Get();
+
+    std::unordered_set<const Sensor*> loaded_sensors;
+    for(const auto& sensor : *sensors)
+        loaded_sensors.insert(sensor.get());
+
+    std::unordered_set<const Sensor*> running_sensors;
+    std::erase_if(readers_, [&](const IsrReader& reader) {
+        if(loaded_sensors.contains(reader.sensor.get())) {
+            running_sensors.insert(reader.sensor.get());
+            return false;
+        }
+
+        LOG_INF("Removing ISR reader for sensor: %s", reader.sensor->id.c_str());
+
+        return true;
+    });
+
+    for(const auto& sensor : *sensors) {
+        if(!running_sensors.contains(sensor.get()))
+            AddReader(sensor);
+    }
+}
+
 } // namespace eerie_leap::domain::sensor_domain::services
@@ -25,6 +25,11 @@ using namespace eerie_leap::domain::sensor_domain::processors;
 
 class ProcessingIsrService : public ISensorsProcessingService {
 private:
+    struct IsrReader {
+        std::shared_ptr<Sensor> sensor;
+        std::unique_ptr<IIsrSensorReader> reader;
+    };
+
     std::shared_ptr<SensorsConfigurationManager> sensors_configuration_manager_;
     std::shared_ptr<SensorReadingsFrame> sensor_readings_frame_;
     std::shared_ptr<IsrSensorReaderFactory> isr_sensor_reader_factory_;
@@ -33,9 +38,11 @@ private:
 
     std::unique_ptr<CollectIsrReadingProcessor> collect_isr_reading_processor_;
     std::shared_ptr<std::vector<std::shared_ptr<IReadingProcessor>>> reading_processors_;
-    std::vector<std::unique_ptr<IIsrSensorReader>> readers_;
+    std::vector<IsrReader> readers_;
+    bool is_paused_;
 
     void ProcessSensor(const Sensor& sensor);
+    void AddReader(std::shared_ptr<Sensor> sensor);
 
 public:
     ProcessingIsrService(
@@ -51,6 +58,7 @@ public:
     void Stop() override;
     void Pause() override;
     void Resume() override;
+    void Reload() override;
 };
 
 } // namespace eerie_leap::domain::sensor_domain::services
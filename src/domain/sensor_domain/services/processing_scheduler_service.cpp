@@ -1,4 +1,5 @@
 #include <span>
+#include <unordered_set>
 
 #include "subsys/time/time_helpers.hpp"
 #include "subsys/lua_script/lua_script.h"
@@ -25,6 +26,7 @@ ProcessingSchedulerService::ProcessingSchedulerService(
         sensor_readings_frame_(std::move(sensor_readings_frame)),
         sensor_reader_factory_(std::move(sensor_reader_factory)),
         work_queue_thread_(std::move(work_queue_thread)),
+        is_paused_(false),
         reading_processors_(std::move(reading_processors)) {};
 
 WorkQueueTaskResult ProcessingSchedulerService::ProcessSensorWorkTask(SensorTask* task) {
@@ -86,28 +88,34 @@ std::unique_ptr<SensorTask> ProcessingSchedulerService::CreateSensorTask(std::sh
     return task;
 }
 
+bool ProcessingSchedulerService::AddTask(std::shared_ptr<Sensor> sensor) {
+    if(sensor->configuration.GetReadingUpdateMethod() != SensorReadingUpdateMethod::SCHEDULER)
+        return false;
+
+    auto task = CreateSensorTask(sensor);
+    if(task == nullptr)
+        return false;
+
+    work_queue_tasks_.push_back(std::make_unique<WorkQueueTask<SensorTask>>(
+        work_queue_thread_->CreateTask(ProcessSensorWorkTask, std::move(task))));
+    LOG_INF("Created task for sensor: %s", sensor->id.c_str());
+
+    return true;
+}
+
 void ProcessingSchedulerService::StartTasks() {
     for(auto& work_queue_task : work_queue_tasks_)
-        work_queue_task.Schedule();
+        work_queue_task->Schedule();
 }
 
 void ProcessingSchedulerService::Start() {
     const auto* sensors = sensors_configuration_manager_->Get();
 
     work_queue_tasks_.clear();
-    for(const auto& sensor : *sensors) {
-        if(sensor->configuration.GetReadingUpdateMethod() != SensorReadingUpdateMethod::SCHEDULER)
-            continue;
-
-        auto task = CreateSensorTask(sensor);
-        if(task == nullptr)
-            continue;
-
-        work_queue_tasks_.emplace_back(
-            work_queue_thread_->CreateTask(ProcessSensorWorkTask, std::move(task)));
-        LOG_INF("Created task for sensor: %s", sensor->id.c_str());
-    }
+    for(const auto& sensor : *sensors)
+        AddTask(sensor);
 
+    is_paused_ = false;
     StartTasks();
 }
 
@@ -117,17 +125,55 @@ void ProcessingSchedulerService::Stop() {
 }
 
 void ProcessingSchedulerService::Pause() {
+    is_paused_ = true;
+
     for(auto& work_queue_task : work_queue_tasks_) {
-        LOG_INF("Canceling task for sensor: %s", work_queue_task.GetUserdata()->sensor->id.c_str());
+        LOG_INF("Canceling task for sensor: %s", work_queue_task->GetUserdata()->sensor->id.c_str());
 
-        while(work_queue_task.Cancel())
+        while(work_queue_task->Cancel())
             k_sleep(K_MSEC(1));
     }
 }
 
 void ProcessingSchedulerService::Resume() {
+    is_paused_ = false;
+
     for(auto& work_queue_task : work_queue_tasks_)
-        work_queue_task.Schedule();
+        work_queue_task->Schedule();
+}
+
+// NOTE: Unchanged sensors keep their instances across configuration
+// updates, so only tasks of sensors that were replaced are recreated.
+// Runs on the work queue, tasks can't be processing meanwhile. While
+// paused, new tasks are left for Resume to schedule.
+void ProcessingSchedulerService::Reload() {
+    const auto* sensors = sensors_configuration_manager_->Get();
+
+    std::unordered_set<const Sensor*> loaded_sensors;
+    for(const auto& sensor : *sensors)
+        loaded_sensors.insert(sensor.get());
+
+    std::unordered_set<const Sensor*> running_sensors;
+    std::erase_if(work_queue_tasks_, [&](auto& work_queue_task) {
+        const auto* sensor = work_queue_task->GetUserdata()->sensor.get();
+        if(loaded_sensors.contains(sensor)) {
+            running_sensors.insert(sensor);
+            return false;
+        }
+
+        LOG_INF("Removing task for sensor: %s", sensor->id.c_str());
+        work_queue_task->CancelOnQueue();
+
+        return true;
+    });
+
+    for(const auto& sensor : *sensors) {
+        if(running_sensors.contains(sensor.get()))
+            continue;
+
+        if(AddTask(sensor) && !is_paused_)
+            work_queue_tasks_.back()->Schedule();
+    }
 }
 
 } // namespace eerie_leap::domain::sensor_domain::services
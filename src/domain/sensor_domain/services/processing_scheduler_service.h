@@ -28,11 +28,14 @@ private:
     std::shared_ptr<SensorReaderFactory> sensor_reader_factory_;
 
     std::shared_ptr<WorkQueueThread> work_queue_thread_;
-    std::vector<WorkQueueTask<SensorTask>> work_queue_tasks_;
+    // NOTE: Tasks are kept by pointer, scheduled work can't be moved
+    std::vector<std::unique_ptr<WorkQueueTask<SensorTask>>> work_queue_tasks_;
+    bool is_paused_;
 
     std::shared_ptr<std::vector<std::shared_ptr<IReadingProcessor>>> reading_processors_;
 
     void StartTasks();
+    bool AddTask(std::shared_ptr<Sensor> sensor);
     std::unique_ptr<SensorTask> CreateSensorTask(std::shared_ptr<Sensor> sensor);
     static WorkQueueTaskResult ProcessSensorWorkTask(SensorTask* task);
 
@@ -50,6 +53,7 @@ public:
     void Stop() override;
     void Pause() override;
     void Resume() override;
+    void Reload() override;
 };
 
 } // namespace eerie_leap::domain::sensor_domain::services
@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <map>
+#include <span>
+#include <string>
+
+#include <zephyr/logging/log.h>
+
+#include "sensors_mdf4_logger.h"
+
+LOG_MODULE_REGISTER(sensors_mdf4_logger);
+
+namespace eerie_leap::domain::sensor_domain::services {
+
+SensorsMdf4Logger::SensorsMdf4Logger(
+    std::shared_ptr<Mdf4File> mdf4_file,
+    std::shared_ptr<SensorReadingsFrame> sensor_readings_frame)
+        : mdf4_file_(std::move(mdf4_file)),
+        sensor_readings_frame_(std::move(sensor_readings_frame)),
+        sink_(nullptr),
+        is_trigger_condition_met_(false) {}
+
+SensorsMdf4Logger::~SensorsMdf4Logger() {
+    Stop();
+    sensor_readings_frame_->ClearValueBlocks();
+}
+
+void SensorsMdf4Logger::Configure(const std::vector<std::shared_ptr<Sensor>>& sensors) {
+    if(IsRunning())
+        throw std::runtime_error("Sensors MDF logger is running");
+
+    std::map<uint32_t, std::vector<std::shared_ptr<Sensor>>> sensors_by_rate;
+    for(const auto& sensor : sensors) {
+        if(!sensor->configuration.sampling_rate_ms.has_value() || sensor->configuration.sampling_rate_ms.value() <= 0)
+            continue;
+
+        sensors_by_rate[sensor->configuration.sampling_rate_ms.value()].push_back(sensor);
+    }
+
+    rate_groups_.clear();
+    rate_groups_.reserve(sensors_by_rate.size());
+    sensor_readings_frame_->ClearValueBlocks();
+
+    for(const auto& [sampling_rate_ms, rate_sensors] : sensors_by_rate) {
+        RateGroup rate_group = {
+            .sampling_rate_ms = sampling_rate_ms,
+            .value_block_offset = 0,
+            .next_log_time = 0,
+            .record_count = 0,
+            .capture_source_id = 0
+        };
+
+        // Single channel group per data group, no record ID needed
+        rate_group.data_group = mdf4_file_->CreateDataGroup(0);
+        rate_group.channel_group = mdf4_file_->CreateChannelGroup(
+            rate_group.data_group,
+            0,
+            "Sensors " + std::to_string(sampling_rate_ms) + " ms");
+
+        std::vector<size_t> sensor_id_hashes;
+        sensor_id_hashes.reserve(rate_sensors.size());
+        for(const auto& sensor : rate_sensors) {
+            mdf4_file_->CreateDataChannel(
+                rate_group.channel_group,
+                MdfDataType::Float32,
+                std::string(sensor->id),
+                std::string(sensor->metadata.unit));
+            sensor_id_hashes.push_back(sensor->id_hash);
+        }
+
+        rate_group.value_block_offset = sensor_readings_frame_->AddValueBlock(sensor_id_hashes);
+
+        rate_group.row.resize(1 + rate_sensors.size());
+        if(rate_group.channel_group->GetDataSizeBytes() != rate_group.row.size() * sizeof(float))
+            throw std::runtime_error("Unexpected sensors record layout");
+
+        rate_group.data_record = std::make_unique<mdf4::DataRecord>(rate_group.channel_group);
+
+        rate_groups_.push_back(std::move(rate_group));
+    }
+
+    LOG_INF("Sensors MDF logger configured with %zu rate groups.", rate_groups_.size());
+}
+
+void SensorsMdf4Logger::Start(IMdf4BlockSink& sink, Mdf4CompressionType compression) {
+    Stop();
+
+    // NOTE: Each rate group has a writer of its own holding a buffer
+    sink.ReserveBuffers(rate_groups_.size());
+    sink_ = &sink;
+
+    for(size_t i = 0; i < rate_groups_.size(); i++) {
+        mdf4_file_->EnableDataList(sink, rate_groups_[i].data_group);
+
+        Mdf4BlockOptions options = {
+            .writer_id = mdf4_file_->GetDataGroupIndex(rate_groups_[i].data_group),
+            .compression = compression,
+            .record_size_bytes = static_cast<uint32_t>(rate_groups_[i].row.size() * sizeof(float))
+        };
+
+        rate_groups_[i].writer = std::make_unique<Mdf4RecordWriter>(sink, options);
+        rate_groups_[i].next_log_time = 0;
+        rate_groups_[i].record_count = 0;
+
+        if(capture_)
+            rate_groups_[i].capture_source_id = capture_->RegisterSource(*this);
+    }
+
+    is_trigger_condition_met_ = false;
+}
+
+void SensorsMdf4Logger::Stop() {
+    if(capture_ && IsRunning()) {
+        capture_->Flush();
+
+        for(const auto& rate_group : rate_groups_)
+            capture_->UnregisterSource(rate_group.capture_source_id);
+    }
+
+    for(auto& rate_group : rate_groups_) {
+        if(rate_group.writer == nullptr)
+            continue;
+
+        try {
+            rate_group.writer->Flush();
+        } catch(const std::exception& e) {
+            LOG_ERR("Failed to flush sensors MDF records: %s", e.what());
+        }
+
+        rate_group.writer.reset();
+    }
+
+    if(sink_ == nullptr)
+        return;
+
+    try {
+        sink_->FlushDataLists();
+    } catch(const std::exception& e) {
+        LOG_ERR("Failed to write sensors MDF data lists: %s", e.what());
+    }
+
+    sink_ = nullptr;
+}
+
+void SensorsMdf4Logger::LogRateGroup(size_t index, float time) {
+    auto& rate_group = rate_groups_.at(index);
+    if(rate_group.writer == nullptr)
+        throw std::runtime_error("Sensors MDF logger is not running");
+
+    rate_group.row[0] = time;
+    sensor_readings_frame_->CopyValueBlock(
+        rate_group.value_block_offset,
+        std::span<float>(rate_group.row).subspan(1));
+
+    auto row = std::span<const uint8_t>(
+        reinterpret_cast<const uint8_t*>(rate_group.row.data()),
+        rate_group.row.size() * sizeof(float));
+
+    if(capture_) {
+        capture_->Capture(rate_group.capture_source_id, time, row);
+        return;
+    }
+
+    rate_group.data_record->WriteToWriter(*rate_group.writer, row);
+    rate_group.record_count++;
+}
+
+void SensorsMdf4Logger::SetCapture(std::shared_ptr<Mdf4TriggeredCapture> capture) {
+    if(IsRunning())
+        throw std::runtime_error("Sensors MDF logger is running");
+
+    capture_ = std::move(capture);
+}
+
+void SensorsMdf4Logger::SetTriggerExpression(std::optional<std::string> expression) {
+    if(!expression.has_value() || expression.value().empty()) {
+        trigger_evaluator_.reset();
+        return;
+    }
+
+    trigger_evaluator_ = std::make_unique<ExpressionEvaluator>(std::move(expression.value()));
+    trigger_evaluator_->RegisterVariableValueHandler(
+        [&sensor_readings_frame = sensor_readings_frame_](const std::string& sensor_id) {
+            return sensor_readings_frame->GetReadingValuePtr(sensor_id);
+        });
+
+    is_trigger_condition_met_ = false;
+}
+
+void SensorsMdf4Logger::WriteCapturedRecord(uint16_t source_id, std::span<const uint8_t> record, float time) {
+    auto rate_group = std::find_if(rate_groups_.begin(), rate_groups_.end(), [source_id](const RateGroup& rate_group) {
+        return rate_group.capture_source_id == source_id; });
+
+    if(rate_group == rate_groups_.end() || rate_group->writer == nullptr)
+        return;
+
+    rate_group->data_record->WriteToWriter(*rate_group->writer, record);
+    rate_group->record_count++;
+}
+
+void SensorsMdf4Logger::FlushCapturedRecords() {
+    for(auto& rate_group : rate_groups_) {
+        if(rate_group.writer != nullptr)
+            rate_group.writer->Flush();
+    }
+}
+
+void SensorsMdf4Logger::CheckTrigger() {
+    bool is_condition_met = false;
+
+    try {
+        is_condition_met = trigger_evaluator_->Evaluate() != 0;
+    } catch(const std::exception& e) {
+        LOG_ERR("Failed to evaluate capture trigger: %s", e.what());
+    }
+
+    // NOTE: Only the rising edge triggers, a condition that stays met
+    // doesn't capture back to back segments.
+    if(is_condition_met && !is_trigger_condition_met_)
+        capture_->Trigger();
+
+    is_trigger_condition_met_ = is_condition_met;
+}
+
+void SensorsMdf4Logger::Log(float time) {
+    if(capture_ && trigger_evaluator_)
+        CheckTrigger();
+
+    for(size_t i = 0; i < rate_groups_.size(); i++) {
+        auto& rate_group = rate_groups_[i];
+        if(time < rate_group.next_log_time)
+            continue;
+
+        LogRateGroup(i, time);
+
+        // NOTE: Missed periods are skipped rather than logged in a burst
+        float period = rate_group.sampling_rate_ms / 1000.0f;
+        rate_group.next_log_time += period;
+        if(rate_group.next_log_time <= time)
+            rate_group.next_log_time = time + period;
+    }
+}
+
+std::vector<Mdf4DataBlockInfo> SensorsMdf4Logger::GetDataBlocks(size_t index) const {
+    const auto& rate_group = rate_groups_.at(index);
+    if(rate_group.writer == nullptr)
+        return {};
+
+    return rate_group.writer->GetDataBlocks();
+}
+
+} // namespace eerie_leap::domain::sensor_domain::services
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "subsys/mdf/mdf4_file.h"
+#include "subsys/mdf/mdf4_record_writer.h"
+#include "subsys/mdf/i_mdf4_block_sink.h"
+#include "subsys/mdf/mdf4_triggered_capture.h"
+#include "subsys/mdf/mdf4/data_record.h"
+#include "subsys/math_parser/expression_evaluator.h"
+#include "domain/sensor_domain/models/sensor.h"
+#include "domain/sensor_domain/utilities/sensor_readings_frame.hpp"
+
+namespace eerie_leap::domain::sensor_domain::services {
+
+using namespace eerie_leap::subsys::mdf;
+using namespace eerie_leap::subsys::math_parser;
+using namespace eerie_leap::domain::sensor_domain::models;
+using namespace eerie_leap::domain::sensor_domain::utilities;
+
+// Logs processed sensor values to an MDF4 file.
+// Sensors sharing a sampling rate are logged as one fixed length row per
+// sample, each rate gets its own data group. Row layout is a timestamp
+// followed by one float per sensor, so it is copied in one go from the
+// readings frame value block and written without per record allocation.
+// With a triggered capture set, rows go to its ring buffer, the trigger
+// expression is evaluated over sensor values on each Log call and fires
+// the capture when it turns non zero.
+class SensorsMdf4Logger : public IMdf4CaptureSource {
+private:
+    struct RateGroup {
+        uint32_t sampling_rate_ms;
+        std::shared_ptr<mdf4::DataGroupBlock> data_group;
+        std::shared_ptr<mdf4::ChannelGroupBlock> channel_group;
+        std::unique_ptr<mdf4::DataRecord> data_record;
+        // Offset of the rate group sensors in the readings frame value block
+        size_t value_block_offset;
+        std::vector<float> row;
+        std::unique_ptr<Mdf4RecordWriter> writer;
+        float next_log_time;
+        uint32_t record_count;
+        uint16_t capture_source_id;
+    };
+
+    std::shared_ptr<Mdf4File> mdf4_file_;
+    std::shared_ptr<SensorReadingsFrame> sensor_readings_frame_;
+    std::vector<RateGroup> rate_groups_;
+    IMdf4BlockSink* sink_;
+
+    std::shared_ptr<Mdf4TriggeredCapture> capture_;
+    std::unique_ptr<ExpressionEvaluator> trigger_evaluator_;
+    bool is_trigger_condition_met_;
+
+    void CheckTrigger();
+
+public:
+    SensorsMdf4Logger(
+        std::shared_ptr<Mdf4File> mdf4_file,
+        std::shared_ptr<SensorReadingsFrame> sensor_readings_frame);
+    ~SensorsMdf4Logger();
+
+    // Creates the data groups, must be called before the file header is written.
+    // Sensors without sampling rate are not logged.
+    void Configure(const std::vector<std::shared_ptr<Sensor>>& sensors);
+
+    // NOTE: Each rate group writes blocks tagged with its data group index
+    // and linked from DL blocks, the file header must be written already.
+    // Rows are fixed length, so TranspositionDeflate is the better fit
+    // for compression.
+    void Start(IMdf4BlockSink& sink, Mdf4CompressionType compression = Mdf4CompressionType::None);
+    void Stop();
+    bool IsRunning() const { return !rate_groups_.empty() && rate_groups_.front().writer != nullptr; }
+
+    // NOTE: Capture takes effect on next Start, capture segment in
+    // progress is ended on Stop.
+    void SetCapture(std::shared_ptr<Mdf4TriggeredCapture> capture);
+    // Expression variables are sensor IDs, e.g. "coolant_temp > 110"
+    void SetTriggerExpression(std::optional<std::string> expression);
+    void WriteCapturedRecord(uint16_t source_id, std::span<const uint8_t> record, float time) override;
+    void FlushCapturedRecords() override;
+
+    // Logs a row for every rate group whose sampling period has elapsed
+    void Log(float time);
+    void LogRateGroup(size_t index, float time);
+
+    size_t GetRateGroupCount() const { return rate_groups_.size(); }
+    uint32_t GetSamplingRateMs(size_t index) const { return rate_groups_.at(index).sampling_rate_ms; }
+    uint32_t GetRecordCount(size_t index) const { return rate_groups_.at(index).record_count; }
+    std::shared_ptr<mdf4::DataGroupBlock> GetDataGroup(size_t index) const { return rate_groups_.at(index).data_group; }
+    std::vector<Mdf4DataBlockInfo> GetDataBlocks(size_t index) const;
+};
+
+} // namespace eerie_leap::domain::sensor_domain::services
@@ -1,4 +1,5 @@
 #include <span>
+#include <unordered_set>
 
 #include "subsys/time/time_helpers.hpp"
 #include "subsys/lua_script/lua_script.h"
@@ -31,7 +32,9 @@ SensorsProcessingService::SensorsProcessingService(
         sensor_readings_frame_(std::move(sensor_readings_frame)),
         isr_sensor_reader_factory_(std::move(isr_sensor_reader_factory)),
         sensor_reader_factory_(std::move(sensor_reader_factory)),
-        reading_processors_(std::make_shared<std::vector<std::shared_ptr<IReadingProcessor>>>()) {
+        reading_processors_(std::make_shared<std::vector<std::shared_ptr<IReadingProcessor>>>()),
+        is_running_(false),
+        is_paused_(false) {
 
     work_queue_thread_ = std::make_shared<WorkQueueThread>(
         "processing_service",
@@ -77,6 +80,10 @@ void SensorsProcessingService::Start() {
     for(auto& processing_service : processing_services_)
         processing_service->Start();
 
+    sensors_ = *sensors;
+    is_running_ = true;
+    is_paused_ = false;
+
     LOG_INF("Processing Service started.");
 }
 
@@ -85,6 +92,9 @@ void SensorsProcessingService::Stop() {
         processing_service->Stop();
 
     sensor_readings_frame_->ClearReadings();
+    sensors_.clear();
+    is_running_ = false;
+    is_paused_ = false;
 
     LOG_INF("Processing Service stopped.");
 }
@@ -93,6 +103,9 @@ void SensorsProcessingService::Pause() {
     for(auto& processing_service : processing_services_)
         processing_service->Pause();
 
+    is_running_ = false;
+    is_paused_ = true;
+
     LOG_INF("Processing Service paused.");
 }
 
@@ -100,9 +113,71 @@ void SensorsProcessingService::Resume() {
     for(auto& processing_service : processing_services_)
         processing_service->Resume();
 
+    is_running_ = true;
+    is_paused_ = false;
+
     LOG_INF("Processing Service resumed.");
 }
 
+// NOTE: Configuration is applied while paused as well, so Resume
+// continues with the sensors loaded meanwhile.
+void SensorsProcessingService::Reload() {
+    if(!is_running_ && !is_paused_)
+        return;
+
+    k_sem applied_sem;
+    k_sem_init(&applied_sem, 0, 1);
+
+    // Sensors are processed on the work queue, running the swap
+    // on it ensures no sensor is being processed meanwhile
+    work_queue_thread_->Run([this, &applied_sem]() {
+        ApplyConfiguration();
+        k_sem_give(&applied_sem);
+    });
+
+    k_sem_take(&applied_sem, K_FOREVER);
+
+    LOG_INF("Processing Service reloaded.");
+}
+
+void SensorsProcessingService::ApplyConfiguration() {
+    const auto* sensors = sensors_configuration_manager_->Get();
+
+    std::unordered_set<const Sensor*> running_sensors;
+    for(const auto& sensor : sensors_)
+        running_sensors.insert(sensor.get());
+
+    std::unordered_set<const Sensor*> loaded_sensors;
+    std::unordered_set<size_t> loaded_sensor_ids;
+    for(const auto& sensor : *sensors) {
+        loaded_sensors.insert(sensor.get());
+        loaded_sensor_ids.insert(sensor->id_hash);
+
+        if(!running_sensors.contains(sensor.get()))
+            InitializeScript(sensor);
+    }
+
+    for(auto& processing_service : processing_services_)
+        processing_service->Reload();
+
+    int replaced_count = 0;
+    for(const auto& sensor : sensors_) {
+        if(loaded_sensors.contains(sensor.get()))
+            continue;
+
+        if(loaded_sensor_ids.contains(sensor->id_hash))
+            sensor_readings_frame_->ClearReading(sensor->id_hash);
+        else
+            sensor_readings_frame_->RemoveReading(sensor->id_hash);
+
+        replaced_count++;
+    }
+
+    LOG_INF("Sensors reloaded, %d replaced or removed, %zu total.", replaced_count, sensors->size());
+
+    sensors_ = *sensors;
+}
+
 void SensorsProcessingService::RegisterReadingProcessor(std::shared_ptr<IReadingProcessor> processor) {
     reading_processors_->push_back(processor);
 }
@@ -38,7 +38,13 @@ private:
     std::shared_ptr<std::vector<std::shared_ptr<IReadingProcessor>>> reading_processors_;
     std::vector<std::unique_ptr<ISensorsProcessingService>> processing_services_;
 
+    // Sensors being processed
+    std::vector<std::shared_ptr<Sensor>> sensors_;
+    bool is_running_;
+    bool is_paused_;
+
     void InitializeScript(std::shared_ptr<Sensor> sensor);
+    void ApplyConfiguration();
 
 public:
     SensorsProcessingService(
@@ -53,6 +59,11 @@ public:
     void Stop() override;
     void Pause() override;
     void Resume() override;
+    // Swaps in sensors changed by the last configuration update between
+    // processing cycles, sensors left unchanged keep their readers and
+    // readings. Has no effect unless running.
+    // NOTE: Blocks until applied, can't be called from the processing thread.
+    void Reload() override;
 
     void RegisterReadingProcessor(std::shared_ptr<IReadingProcessor> processor);
 };
@@ -0,0 +1,56 @@
+#include <string_view>
+#include <utility>
+
+#include <zephyr/sys/crc.h>
+
+#include "sensor_fingerprint.h"
+
+namespace eerie_leap::domain::sensor_domain::utilities {
+
+template <typename T>
+static uint32_t Update(uint32_t crc, const T& value) {
+    return crc32_ieee_update(crc, reinterpret_cast<const uint8_t*>(&value), sizeof(T));
+}
+
+static uint32_t Update(uint32_t crc, std::string_view value) {
+    crc = Update(crc, static_cast<uint32_t>(value.size()));
+    return crc32_ieee_update(crc, reinterpret_cast<const uint8_t*>(value.data()), value.size());
+}
+
+uint32_t SensorFingerprint::Get(const Sensor& sensor) {
+    const auto& configuration = sensor.configuration;
+    uint32_t crc = 0;
+
+    crc = Update(crc, std::string_view(sensor.id));
+    crc = Update(crc, std::to_underlying(configuration.type));
+    crc = Update(crc, configuration.channel.value_or(UINT32_MAX));
+    crc = Update(crc, std::string_view(configuration.connection_string));
+    crc = Update(crc, configuration.sampling_rate_ms.value_or(-1));
+
+    crc = Update(crc, std::string_view(configuration.script_path));
+    if(!configuration.script_path.empty())
+        crc = Update(crc, configuration.script_checksum.value_or(0));
+
+    if(configuration.voltage_interpolator != nullptr) {
+        crc = Update(crc, configuration.voltage_interpolator->GetInterpolationMethod());
+
+        auto calibration_table = configuration.voltage_interpolator->GetCalibrationTable();
+        if(calibration_table != nullptr) {
+            for(const auto& calibration_data : *calibration_table) {
+                crc = Update(crc, calibration_data.voltage);
+                crc = Update(crc, calibration_data.value);
+            }
+        }
+    }
+
+    if(configuration.expression_evaluator != nullptr)
+        crc = Update(crc, std::string_view(configuration.expression_evaluator->GetExpression()));
+
+    crc = Update(crc, std::string_view(sensor.metadata.name));
+    crc = Update(crc, std::string_view(sensor.metadata.unit));
+    crc = Update(crc, std::string_view(sensor.metadata.description));
+
+    return crc;
+}
+
+} // namespace eerie_leap::domain::sensor_domain::utilities
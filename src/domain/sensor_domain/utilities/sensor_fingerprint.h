@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+#include "domain/sensor_domain/models/sensor.h"
+
+namespace eerie_leap::domain::sensor_domain::utilities {
+
+using namespace eerie_leap::domain::sensor_domain::models;
+
+// Checksum of everything configured for a sensor, including the content
+// of its script, equal fingerprints mean the sensor can be kept as is.
+// Script content is covered by the checksum taken when it was loaded.
+class SensorFingerprint {
+public:
+    static uint32_t Get(const Sensor& sensor);
+};
+
+} // namespace eerie_leap::domain::sensor_domain::utilities
@@ -1,9 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
 #include <optional>
+#include <span>
 #include <unordered_map>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #include <zephyr/spinlock.h>
 
@@ -23,6 +28,11 @@ private:
     std::unordered_map<size_t, float> reading_values_;
     mutable std::unordered_map<std::string, size_t> sensor_id_hash_map_;
 
+    // Values of sensors laid out contiguously, mirrored on each update
+    // so value rows are copied with a single memcpy
+    std::vector<float> value_block_;
+    std::unordered_map<size_t, size_t> value_block_indexes_;
+
     mutable k_sem processing_semaphore_;
 
     size_t GetSensorIdHash(const std::string& sensor_id) const {
@@ -38,6 +48,14 @@ private:
         return sensor_id_hash;
     }
 
+    void SetReadingValue(const size_t sensor_id_hash, float value) {
+        reading_values_[sensor_id_hash] = value;
+
+        auto it = value_block_indexes_.find(sensor_id_hash);
+        if(it != value_block_indexes_.end())
+            value_block_[it->second] = value;
+    }
+
     void AddOrUpdateReadingIsr(SensorReading& reading) {
         size_t sensor_id_hash = reading.sensor->id_hash;
 
@@ -46,7 +64,7 @@ private:
         isr_readings_.insert({ sensor_id_hash, reading });
 
         if(reading.status == ReadingStatus::PROCESSED && reading.value.has_value()) {
-            reading_values_[sensor_id_hash] = reading.value.value();
+            SetReadingValue(sensor_id_hash, reading.value.value());
 
             if(processed_readings_.contains(sensor_id_hash))
                 processed_readings_.erase(sensor_id_hash);
@@ -65,7 +83,7 @@ private:
         readings_.insert({ sensor_id_hash, reading });
 
         if(reading.status == ReadingStatus::PROCESSED && reading.value.has_value()) {
-            reading_values_[sensor_id_hash] = reading.value.value();
+            SetReadingValue(sensor_id_hash, reading.value.value());
 
             if(processed_readings_.contains(sensor_id_hash))
                 processed_readings_.erase(sensor_id_hash);
@@ -148,6 +166,53 @@ public:
         return TryGetReadingValue(sensor_id_hash);
     }
 
+    // Adds sensors to the value block in the given order,
+    // returns offset of the first one for CopyValueBlock
+    size_t AddValueBlock(std::span<const size_t> sensor_id_hashes) {
+        k_sem_take(&processing_semaphore_, K_FOREVER);
+
+        size_t offset = value_block_.size();
+
+        for(size_t sensor_id_hash : sensor_id_hashes) {
+            if(value_block_indexes_.contains(sensor_id_hash)) {
+                k_sem_give(&processing_semaphore_);
+                throw std::invalid_argument("Sensor is already in value block");
+            }
+
+            auto it = reading_values_.find(sensor_id_hash);
+            value_block_indexes_.emplace(sensor_id_hash, value_block_.size());
+            value_block_.push_back(it != reading_values_.end()
+                ? it->second
+                : std::numeric_limits<float>::quiet_NaN());
+        }
+
+        k_sem_give(&processing_semaphore_);
+
+        return offset;
+    }
+
+    void ClearValueBlocks() {
+        k_sem_take(&processing_semaphore_, K_FOREVER);
+        value_block_.clear();
+        value_block_indexes_.clear();
+        k_sem_give(&processing_semaphore_);
+    }
+
+    // Copies values.size() values starting at offset under a single lock,
+    // missing values are NaN
+    void CopyValueBlock(size_t offset, std::span<float> values) const {
+        k_sem_take(&processing_semaphore_, K_FOREVER);
+
+        if(offset + values.size() > value_block_.size()) {
+            k_sem_give(&processing_semaphore_);
+            throw std::out_of_range("Value block range out of bounds");
+        }
+
+        std::memcpy(values.data(), value_block_.data() + offset, values.size_bytes());
+
+        k_sem_give(&processing_semaphore_);
+    }
+
     float* GetReadingValuePtr(const std::string& sensor_id) {
         const size_t sensor_id_hash = GetSensorIdHash(sensor_id);
 
@@ -193,12 +258,39 @@ public:
         k_sem_give(&processing_semaphore_);
     }
 
+    // Clears readings of the sensor, the value slot is kept
+    // as expressions may hold a pointer to it
+    void ClearReading(const size_t sensor_id_hash) {
+        k_sem_take(&processing_semaphore_, K_FOREVER);
+        isr_readings_.erase(sensor_id_hash);
+        readings_.erase(sensor_id_hash);
+        processed_readings_.erase(sensor_id_hash);
+        if(reading_values_.contains(sensor_id_hash))
+            SetReadingValue(sensor_id_hash, std::numeric_limits<float>::quiet_NaN());
+        k_sem_give(&processing_semaphore_);
+    }
+
+    // NOTE: Only for sensors no longer referenced by expressions
+    void RemoveReading(const size_t sensor_id_hash) {
+        k_sem_take(&processing_semaphore_, K_FOREVER);
+        isr_readings_.erase(sensor_id_hash);
+        readings_.erase(sensor_id_hash);
+        processed_readings_.erase(sensor_id_hash);
+        reading_values_.erase(sensor_id_hash);
+
+        auto it = value_block_indexes_.find(sensor_id_hash);
+        if(it != value_block_indexes_.end())
+            value_block_[it->second] = std::numeric_limits<float>::quiet_NaN();
+        k_sem_give(&processing_semaphore_);
+    }
+
     void ClearReadings() {
         k_sem_take(&processing_semaphore_, K_FOREVER);
         isr_readings_.clear();
         readings_.clear();
         processed_readings_.clear();
         reading_values_.clear();
+        std::fill(value_block_.begin(), value_block_.end(), std::numeric_limits<float>::quiet_NaN());
         k_sem_give(&processing_semaphore_);
     }
 };
@@ -0,0 +1,234 @@
+#include <exception>
+#include <sstream>
+#include <string>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/sys_heap.h>
+
+#include "configuration/cbor/cbor_serializer.h"
+#include "configuration/json/json_serializer.h"
+#include "domain/sensor_domain/models/sensor_type.h"
+#include "domain/sensor_domain/configuration/parsers/sensor_validator.h"
+#include "domain/sensor_domain/configuration/parsers/sensors_cbor_parser.h"
+#include "domain/sensor_domain/configuration/parsers/sensors_json_parser.h"
+#include "domain/sensor_domain/utilities/sensors_order_resolver.h"
+
+#include "sensors_configuration_benchmark.h"
+
+namespace eerie_leap::domain::sensor_domain::utilities {
+
+LOG_MODULE_REGISTER(sensors_configuration_benchmark_logger);
+
+using namespace eerie_leap::configuration::cbor;
+using namespace eerie_leap::configuration::json;
+using namespace eerie_leap::domain::sensor_domain::models;
+using namespace eerie_leap::domain::sensor_domain::configuration::parsers;
+
+#ifdef CONFIG_SYS_HEAP_RUNTIME_STATS
+
+static void ResetHeapPeak() {
+    sys_heap** heaps = nullptr;
+    int heap_count = sys_heap_array_get(&heaps);
+
+    for(int i = 0; i < heap_count; i++)
+        sys_heap_runtime_stats_reset_max(heaps[i]);
+}
+
+static size_t GetHeapBytes(bool is_peak) {
+    sys_heap** heaps = nullptr;
+    int heap_count = sys_heap_array_get(&heaps);
+    size_t bytes = 0;
+
+    for(int i = 0; i < heap_count; i++) {
+        sys_memory_stats stats;
+        sys_heap_runtime_stats_get(heaps[i], &stats);
+
+        bytes += is_peak ? stats.max_allocated_bytes : stats.allocated_bytes;
+    }
+
+    return bytes;
+}
+
+#else
+
+static void ResetHeapPeak() {}
+static size_t GetHeapBytes(bool) { return 0; }
+
+#endif // CONFIG_SYS_HEAP_RUNTIME_STATS
+
+// NOTE: 32 bit cycle counter wraps within seconds on fast cores, phases
+// of large configurations fall back to system ticks without a 64 bit one.
+static uint64_t GetTimeUs() {
+#ifdef CONFIG_TIMER_HAS_64BIT_CYCLE_COUNTER
+    return k_cyc_to_us_floor64(k_cycle_get_64());
+#else
+    return k_ticks_to_us_floor64(k_uptime_ticks());
+#endif // CONFIG_TIMER_HAS_64BIT_CYCLE_COUNTER
+}
+
+// Logs time of the phase and heap allocated on top of what it started with
+template <typename Fn>
+static void MeasurePhase(const char* name, Fn&& fn) {
+    ResetHeapPeak();
+    size_t start_bytes = GetHeapBytes(false);
+    uint64_t start_us = GetTimeUs();
+
+    fn();
+
+    uint64_t time_us = GetTimeUs() - start_us;
+    size_t peak_bytes = GetHeapBytes(true);
+
+    LOG_INF("  %-18s: %llu us, heap peak %zu B",
+        name,
+        time_us,
+        peak_bytes > start_bytes ? peak_bytes - start_bytes : 0);
+}
+
+// Every fourth sensor is virtual, depending on the previous virtual sensor
+// and the sensor before it, so chains grow with the configuration
+pmr_unique_ptr<JsonSensorsConfig> SensorsConfigurationBenchmark::CreateConfig(size_t sensor_count) {
+    auto config = make_unique_pmr<JsonSensorsConfig>(Mrm::GetExtPmr());
+    config->sensors.reserve(sensor_count);
+
+    for(size_t i = 0; i < sensor_count; i++) {
+        JsonSensorConfig sensor_config;
+        std::string sensor_id = "sensor_" + std::to_string(i);
+
+        sensor_config.id = sensor_id.c_str();
+        sensor_config.metadata.name = ("Sensor " + std::to_string(i)).c_str();
+        sensor_config.metadata.unit = "V";
+        sensor_config.metadata.description = "Synthetic sensor";
+
+        auto& configuration = sensor_config.configuration;
+        configuration.channel = -1;
+        configuration.sampling_rate_ms = -1;
+        configuration.interpolation_method = "NONE";
+
+        switch(i % 4) {
+        case 0:
+            configuration.type = GetSensorTypeName(SensorType::PHYSICAL_ANALOG);
+            configuration.channel = static_cast<int>(i % ADC_CHANNEL_COUNT);
+            configuration.sampling_rate_ms = 100;
+            configuration.interpolation_method = "LINEAR";
+            configuration.calibration_table.push_back({ .voltage = 0.0F, .value = 0.0F });
+            configuration.calibration_table.push_back({ .voltage = 3.3F, .value = 100.0F });
+            break;
+
+        case 1:
+            configuration.type = GetSensorTypeName(SensorType::CANBUS_ANALOG);
+            configuration.connection_string = ("0/" + std::to_string(0x100 + i / 4) + "/signal_" + std::to_string(i)).c_str();
+            break;
+
+        case 2:
+            configuration.type = GetSensorTypeName(SensorType::CANBUS_RAW);
+            configuration.connection_string = ("1/" + std::to_string(0x200 + i / 4)).c_str();
+            break;
+
+        default: {
+            configuration.type = GetSensorTypeName(SensorType::VIRTUAL_ANALOG);
+            configuration.sampling_rate_ms = 100;
+
+            std::string expression = "sensor_" + std::to_string(i - 1) + " * 0.5";
+            if(i >= 4)
+                expression += " + sensor_" + std::to_string(i - 4);
+
+            configuration.expression = expression.c_str();
+            break;
+        }
+        }
+
+        config->sensors.push_back(std::move(sensor_config));
+    }
+
+    return config;
+}
+
+void SensorsConfigurationBenchmark::RunConfig(size_t sensor_count) {
+    LOG_INF("Sensors configuration benchmark, %zu sensors:", sensor_count);
+
+    pmr_unique_ptr<JsonSensorsConfig> json_config = nullptr;
+    MeasurePhase("Generate", [&]() {
+        json_config = CreateConfig(sensor_count);
+    });
+
+    JsonSerializer<JsonSensorsConfig> json_serializer;
+    std::stringbuf json_text;
+    MeasurePhase("JSON encode", [&]() {
+        if(!json_serializer.Serialize(*json_config, json_text))
+            throw std::runtime_error("Failed to encode JSON configuration.");
+    });
+    json_config = nullptr;
+
+    MeasurePhase("JSON decode", [&]() {
+        auto reader = json_serializer.CreateReader();
+        reader.Write(json_text.view());
+        json_config = reader.Finish();
+
+        if(json_config == nullptr)
+            throw std::runtime_error("Failed to decode JSON configuration.");
+    });
+
+    SensorsJsonParser json_parser(nullptr);
+    std::vector<std::shared_ptr<Sensor>> sensors;
+    MeasurePhase("JSON to sensors", [&]() {
+        sensors = json_parser.Deserialize(Mrm::GetExtPmr(), *json_config, GPIO_CHANNEL_COUNT, ADC_CHANNEL_COUNT);
+    });
+
+    MeasurePhase("Validate", [&]() {
+        SensorValidator::Validate(sensors, nullptr, GPIO_CHANNEL_COUNT, ADC_CHANNEL_COUNT);
+    });
+
+    MeasurePhase("Order", [&]() {
+        SensorsOrderResolver order_resolver;
+        for(const auto& sensor : sensors)
+            order_resolver.AddSensor(sensor);
+
+        order_resolver.GetProcessingOrder();
+    });
+
+    MeasurePhase("Sensors to JSON", [&]() {
+        json_config = json_parser.Serialize(sensors, GPIO_CHANNEL_COUNT, ADC_CHANNEL_COUNT);
+    });
+
+    SensorsCborParser cbor_parser(nullptr);
+    pmr_unique_ptr<CborSensorsConfig> cbor_config = nullptr;
+    MeasurePhase("Sensors to CBOR", [&]() {
+        cbor_config = cbor_parser.Serialize(sensors, GPIO_CHANNEL_COUNT, ADC_CHANNEL_COUNT);
+    });
+
+    CborSerializer<CborSensorsConfig> cbor_serializer;
+    std::pmr::vector<uint8_t> cbor_bytes(Mrm::GetExtPmr());
+    MeasurePhase("CBOR encode", [&]() {
+        cbor_bytes = cbor_serializer.Serialize(*cbor_config);
+
+        if(cbor_bytes.empty())
+            throw std::runtime_error("Failed to encode CBOR configuration.");
+    });
+    cbor_config = nullptr;
+
+    MeasurePhase("CBOR decode", [&]() {
+        cbor_config = cbor_serializer.Deserialize(cbor_bytes);
+
+        if(cbor_config == nullptr)
+            throw std::runtime_error("Failed to decode CBOR configuration.");
+    });
+
+    MeasurePhase("CBOR to sensors", [&]() {
+        sensors = cbor_parser.Deserialize(Mrm::GetExtPmr(), *cbor_config, GPIO_CHANNEL_COUNT, ADC_CHANNEL_COUNT);
+    });
+
+    LOG_INF("  JSON %zu B, CBOR %zu B", json_text.view().size(), cbor_bytes.size());
+}
+
+void SensorsConfigurationBenchmark::Run(std::span<const size_t> sensor_counts) {
+    for(size_t sensor_count : sensor_counts) {
+        try {
+            RunConfig(sensor_count);
+        } catch(const std::exception& e) {
+            LOG_ERR("Sensors configuration benchmark of %zu sensors failed: %s", sensor_count, e.what());
+        }
+    }
+}
+
+} // namespace eerie_leap::domain::sensor_domain::utilities
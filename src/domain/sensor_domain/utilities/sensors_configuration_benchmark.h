@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <span>
+
+#include "utilities/memory/memory_resource_manager.h"
+#include "configuration/json/configs/json_sensors_config.h"
+
+namespace eerie_leap::domain::sensor_domain::utilities {
+
+using namespace eerie_leap::utilities::memory;
+using namespace eerie_leap::configuration::json::configs;
+
+// Measures how handling of sensors configuration scales with its size.
+// Synthetic configurations mix physical, CAN bus and virtual sensors, with
+// virtual sensors forming a dependency chain through the configuration.
+// Time and heap peak of each phase, from parsing to validation, ordering
+// and serialization, are logged.
+// NOTE: Heap peak requires CONFIG_SYS_HEAP_RUNTIME_STATS, it covers all
+// heaps and allocations of other threads running meanwhile.
+class SensorsConfigurationBenchmark {
+private:
+    static constexpr uint32_t GPIO_CHANNEL_COUNT = 8;
+    static constexpr uint32_t ADC_CHANNEL_COUNT = 8;
+
+    static pmr_unique_ptr<JsonSensorsConfig> CreateConfig(size_t sensor_count);
+    static void RunConfig(size_t sensor_count);
+
+public:
+    static constexpr std::array<size_t, 3> DEFAULT_SENSOR_COUNTS = { 10, 100, 1000 };
+
+    static void Run(std::span<const size_t> sensor_counts = DEFAULT_SENSOR_COUNTS);
+};
+
+} // namespace eerie_leap::domain::sensor_domain::utilities
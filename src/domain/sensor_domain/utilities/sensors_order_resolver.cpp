@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <stdexcept>
+
 #include "sensors_order_resolver.h"
 
 namespace eerie_leap::domain::sensor_domain::utilities {
@@ -5,82 +8,159 @@ namespace eerie_leap::domain::sensor_domain::utilities {
 using namespace eerie_leap::domain::sensor_domain::models;
 
 void SensorsOrderResolver::AddSensor(std::shared_ptr<Sensor> sensor) {
+    if(sensor_indexes_.contains(sensor->id))
+        return;
+
+    std::vector<std::string> dependency_ids;
+
     if(sensor->configuration.expression_evaluator != nullptr) {
         auto sensor_ids = sensor->configuration.expression_evaluator->GetVariableNames();
         sensor_ids.erase("x");
 
-        dependencies_.emplace(sensor->id, std::unordered_set<std::string>(sensor_ids.begin(), sensor_ids.end()));
-    } else {
-        dependencies_.emplace(sensor->id, std::unordered_set<std::string>());
+        dependency_ids.assign(sensor_ids.begin(), sensor_ids.end());
     }
 
-    sensors_.emplace(sensor->id, std::move(sensor));
+    sensor_indexes_.emplace(std::string_view(sensor->id), static_cast<uint32_t>(sensors_.size()));
+    dependency_ids_.push_back(std::move(dependency_ids));
+    sensors_.push_back(std::move(sensor));
 }
 
-bool SensorsOrderResolver::HasCyclicDependency(
-    const std::string& sensor_id,
-    std::unordered_set<std::string>& visited,
-    std::unordered_set<std::string>& temp) {
+void SensorsOrderResolver::BuildGraph(
+    std::vector<uint32_t>& dependency_offsets,
+    std::vector<uint32_t>& dependencies,
+    std::vector<uint32_t>& dependent_offsets,
+    std::vector<uint32_t>& dependents) const {
+
+    size_t sensor_count = sensors_.size();
+
+    dependency_offsets.assign(sensor_count + 1, 0);
+    dependencies.clear();
+
+    for(size_t i = 0; i < sensor_count; i++) {
+        for(const auto& dependency_id : dependency_ids_[i]) {
+            auto it = sensor_indexes_.find(dependency_id);
+            if(it == sensor_indexes_.end())
+                throw std::runtime_error("Sensor "
+                    + std::string(sensors_[i]->id)
+                    + " depends on non-existent sensor "
+                    + dependency_id
+                    + ".");
+
+            dependencies.push_back(it->second);
+        }
+
+        dependency_offsets[i + 1] = static_cast<uint32_t>(dependencies.size());
+    }
 
-    if(temp.contains(sensor_id))
-        return true;
-    if(visited.contains(sensor_id))
-        return false;
+    // Dependents are the same edges reversed
+    dependent_offsets.assign(sensor_count + 1, 0);
+    for(uint32_t dependency : dependencies)
+        dependent_offsets[dependency + 1]++;
 
-    temp.insert(sensor_id);
+    for(size_t i = 0; i < sensor_count; i++)
+        dependent_offsets[i + 1] += dependent_offsets[i];
 
-    for(const auto& dep : dependencies_.at(sensor_id)) {
-        if(!sensors_.contains(dep))
-            throw std::runtime_error("Sensor "
-                + sensor_id
-                + " depends on non-existent sensor "
-                + dep
-                + ".");
+    dependents.resize(dependencies.size());
+    std::vector<uint32_t> dependent_positions(dependent_offsets.begin(), dependent_offsets.end() - 1);
 
-        if(HasCyclicDependency(dep, visited, temp))
-            return true;
+    for(size_t i = 0; i < sensor_count; i++) {
+        for(uint32_t j = dependency_offsets[i]; j < dependency_offsets[i + 1]; j++)
+            dependents[dependent_positions[dependencies[j]]++] = static_cast<uint32_t>(i);
     }
+}
 
-    temp.erase(sensor_id);
-    visited.insert(sensor_id);
+// Sensors left unordered either are in a cycle or depend on one, each has
+// an unordered dependency. Following those for as many steps as there are
+// sensors ends up in a cycle.
+uint32_t SensorsOrderResolver::FindCyclicSensor(
+    const std::vector<uint32_t>& dependency_offsets,
+    const std::vector<uint32_t>& dependencies,
+    const std::vector<uint32_t>& pending_dependency_counts) const {
+
+    auto it = std::find_if(pending_dependency_counts.begin(), pending_dependency_counts.end(), [](uint32_t count) {
+        return count > 0;
+    });
+    auto sensor_index = static_cast<uint32_t>(std::distance(pending_dependency_counts.begin(), it));
+
+    for(size_t step = 0; step < sensors_.size(); step++) {
+        for(uint32_t j = dependency_offsets[sensor_index]; j < dependency_offsets[sensor_index + 1]; j++) {
+            if(pending_dependency_counts[dependencies[j]] > 0) {
+                sensor_index = dependencies[j];
+                break;
+            }
+        }
+    }
 
-    return false;
+    return sensor_index;
 }
 
-void SensorsOrderResolver::ResolveDependencies(
-    const std::string& sensor_id,
-    std::unordered_set<std::string>& visited,
-    std::vector<std::shared_ptr<Sensor>>& ordered_sensors) {
+std::vector<std::shared_ptr<Sensor>> SensorsOrderResolver::GetProcessingOrder() {
+    size_t sensor_count = sensors_.size();
+
+    std::vector<uint32_t> dependency_offsets;
+    std::vector<uint32_t> dependencies;
+    std::vector<uint32_t> dependent_offsets;
+    std::vector<uint32_t> dependents;
+    BuildGraph(dependency_offsets, dependencies, dependent_offsets, dependents);
+
+    std::vector<uint32_t> pending_dependency_counts(sensor_count);
+    std::vector<uint32_t> levels(sensor_count, 0);
+    std::vector<uint32_t> ready;
+    ready.reserve(sensor_count);
+
+    for(size_t i = 0; i < sensor_count; i++) {
+        pending_dependency_counts[i] = dependency_offsets[i + 1] - dependency_offsets[i];
+        if(pending_dependency_counts[i] == 0)
+            ready.push_back(static_cast<uint32_t>(i));
+    }
 
-    if(visited.contains(sensor_id))
-        return;
+    uint32_t max_level = 0;
 
-    visited.insert(sensor_id);
+    for(size_t head = 0; head < ready.size(); head++) {
+        uint32_t sensor_index = ready[head];
 
-    for(const auto& dep : dependencies_.at(sensor_id))
-        ResolveDependencies(dep, visited, ordered_sensors);
+        for(uint32_t j = dependent_offsets[sensor_index]; j < dependent_offsets[sensor_index + 1]; j++) {
+            uint32_t dependent = dependents[j];
 
-    ordered_sensors.push_back(sensors_.at(sensor_id));
-}
+            levels[dependent] = std::max(levels[dependent], levels[sensor_index] + 1);
+            max_level = std::max(max_level, levels[dependent]);
 
-std::vector<std::shared_ptr<Sensor>> SensorsOrderResolver::GetProcessingOrder() {
-    std::unordered_set<std::string> visited;
-    std::unordered_set<std::string> temp;
-
-    for(const auto& [sensor_id, _] : sensors_) {
-        if(!visited.contains(sensor_id)) {
-            if(HasCyclicDependency(sensor_id, visited, temp))
-                throw std::runtime_error("Cyclic dependency detected in sensor "
-                    + sensor_id
-                    + ".");
+            if(--pending_dependency_counts[dependent] == 0)
+                ready.push_back(dependent);
         }
     }
 
-    visited.clear();
+    if(ready.size() < sensor_count) {
+        uint32_t sensor_index = FindCyclicSensor(dependency_offsets, dependencies, pending_dependency_counts);
+
+        throw std::runtime_error("Cyclic dependency detected in sensor "
+            + std::string(sensors_[sensor_index]->id)
+            + ".");
+    }
+
+    // Sensors grouped by level, in the order they were added within a level
+    std::vector<uint32_t> level_offsets(sensor_count > 0 ? max_level + 2 : 1, 0);
+    for(uint32_t level : levels)
+        level_offsets[level + 1]++;
+
+    for(size_t i = 1; i < level_offsets.size(); i++)
+        level_offsets[i] += level_offsets[i - 1];
+
+    order_.resize(sensor_count);
+    levels_.resize(sensor_count);
+
+    for(size_t i = 0; i < sensor_count; i++) {
+        uint32_t position = level_offsets[levels[i]]++;
+
+        order_[position] = static_cast<uint32_t>(i);
+        levels_[position] = levels[i];
+    }
+
     std::vector<std::shared_ptr<Sensor>> ordered_sensors;
+    ordered_sensors.reserve(sensor_count);
 
-    for(const auto& [sensor_id, _] : sensors_)
-        ResolveDependencies(sensor_id, visited, ordered_sensors);
+    for(uint32_t sensor_index : order_)
+        ordered_sensors.push_back(sensors_[sensor_index]);
 
     return ordered_sensors;
 }
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
-#include <unordered_set>
 
 #include "domain/sensor_domain/models/sensor.h"
 
@@ -11,24 +13,44 @@ namespace eerie_leap::domain::sensor_domain::utilities {
 
 using namespace eerie_leap::domain::sensor_domain::models;
 
+// Orders sensors so each one comes after the sensors its expression
+// depends on. Sensors are indexed in the order they are added, and
+// dependencies are resolved into a graph over the indexes, ordered
+// level by level with Kahn's algorithm in linear time.
+// Sensors of the same level don't depend on each other, within a level
+// they keep the order they were added in.
 class SensorsOrderResolver {
 private:
-    std::unordered_map<std::string, std::unordered_set<std::string>> dependencies_;
-    std::unordered_map<std::string, std::shared_ptr<Sensor>> sensors_;
-
-    bool HasCyclicDependency(
-        const std::string& sensor_id,
-        std::unordered_set<std::string>& visited,
-        std::unordered_set<std::string>& temp);
-
-    void ResolveDependencies(
-        const std::string& sensor_id,
-        std::unordered_set<std::string>& visited,
-        std::vector<std::shared_ptr<Sensor>>& ordered_sensors);
+    std::vector<std::shared_ptr<Sensor>> sensors_;
+    std::unordered_map<std::string_view, uint32_t> sensor_indexes_;
+    // Ids of sensors each sensor depends on, resolved once ordered
+    std::vector<std::vector<std::string>> dependency_ids_;
+
+    std::vector<uint32_t> order_;
+    std::vector<uint32_t> levels_;
+
+    // Graph in compressed sparse row form, dependencies of sensor i are
+    // dependencies[dependency_offsets[i]..dependency_offsets[i + 1]]
+    void BuildGraph(
+        std::vector<uint32_t>& dependency_offsets,
+        std::vector<uint32_t>& dependencies,
+        std::vector<uint32_t>& dependent_offsets,
+        std::vector<uint32_t>& dependents) const;
+
+    uint32_t FindCyclicSensor(
+        const std::vector<uint32_t>& dependency_offsets,
+        const std::vector<uint32_t>& dependencies,
+        const std::vector<uint32_t>& pending_dependency_counts) const;
 
 public:
+    // NOTE: Sensors with an id already added are ignored
     void AddSensor(std::shared_ptr<Sensor> sensor);
     std::vector<std::shared_ptr<Sensor>> GetProcessingOrder();
+
+    // Of the last processing order, indexes of the sensors in the order they were added
+    const std::vector<uint32_t>& GetProcessingOrderIndexes() const { return order_; }
+    // Of the last processing order, dependency level of each sensor in it
+    const std::vector<uint32_t>& GetProcessingLevels() const { return levels_; }
 };
 
 } // namespace eerie_leap::domain::sensor_domain::utilities
@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <cstring>
+
+#include <zephyr/fs/fs.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/crc.h>
+
+#include "sensors_runtime_image.h"
+
+namespace eerie_leap::domain::sensor_domain::utilities {
+
+LOG_MODULE_REGISTER(sensors_runtime_image_logger);
+
+SensorsRuntimeImage::SensorsRuntimeImage(
+    std::shared_ptr<IFsService> fs_service,
+    std::string path,
+    std::pmr::memory_resource* mr)
+        : fs_service_(std::move(fs_service)),
+        path_(std::move(path)),
+        image_(mr),
+        is_loaded_(false) {}
+
+void SensorsRuntimeImage::Clear() {
+    image_.clear();
+    image_.shrink_to_fit();
+    order_.clear();
+    scripts_.clear();
+    is_loaded_ = false;
+}
+
+bool SensorsRuntimeImage::Load(const SensorsRuntimeImageKey& key) {
+    Clear();
+
+    if(fs_service_ == nullptr || !fs_service_->IsAvailable() || !fs_service_->Exists(path_))
+        return false;
+
+    size_t image_size = fs_service_->GetFileSize(path_);
+    if(image_size < sizeof(Header))
+        return false;
+
+    image_.resize(image_size);
+    size_t out_len = 0;
+
+    if(!fs_service_->ReadFile(path_, image_.data(), image_.size(), out_len) || out_len != image_size) {
+        LOG_ERR("Failed to read sensors runtime image.");
+        Clear();
+
+        return false;
+    }
+
+    if(!Parse(key)) {
+        Clear();
+        return false;
+    }
+
+    is_loaded_ = true;
+
+    LOG_INF("Sensors runtime image loaded, %zu scripts.", scripts_.size());
+
+    return true;
+}
+
+bool SensorsRuntimeImage::Parse(const SensorsRuntimeImageKey& key) {
+    Header header;
+    std::memcpy(&header, image_.data(), sizeof(Header));
+
+    if(header.magic != MAGIC || header.version != VERSION)
+        return false;
+
+    if(header.config_checksum != key.config_checksum
+        || header.sensor_count != key.sensor_count
+        || header.gpio_channel_count != key.gpio_channel_count
+        || header.adc_channel_count != key.adc_channel_count) {
+
+        LOG_INF("Sensors runtime image is outdated.");
+        return false;
+    }
+
+    auto payload = std::span<const uint8_t>(image_).subspan(sizeof(Header));
+    if(payload.size() != header.payload_size || crc32_ieee(payload.data(), payload.size()) != header.payload_checksum) {
+        LOG_ERR("Sensors runtime image is corrupted.");
+        return false;
+    }
+
+    size_t order_size = header.sensor_count * sizeof(uint16_t);
+    if(payload.size() < order_size)
+        return false;
+
+    order_.resize(header.sensor_count);
+    std::memcpy(order_.data(), payload.data(), order_size);
+
+    // Order has to be a permutation of the configuration
+    std::vector<bool> is_ordered(header.sensor_count, false);
+    for(uint16_t sensor_index : order_) {
+        if(sensor_index >= header.sensor_count || is_ordered[sensor_index])
+            return false;
+
+        is_ordered[sensor_index] = true;
+    }
+
+    size_t offset = order_size;
+    scripts_.reserve(header.script_count);
+
+    for(uint32_t i = 0; i < header.script_count; i++) {
+        if(payload.size() - offset < sizeof(ScriptHeader))
+            return false;
+
+        ScriptHeader script_header;
+        std::memcpy(&script_header, payload.data() + offset, sizeof(ScriptHeader));
+        offset += sizeof(ScriptHeader);
+
+        if(payload.size() - offset < script_header.bytecode_size)
+            return false;
+
+        scripts_.push_back({
+            .sensor_index = script_header.sensor_index,
+            .source_checksum = script_header.source_checksum,
+            .bytecode = payload.subspan(offset, script_header.bytecode_size) });
+
+        offset += script_header.bytecode_size;
+    }
+
+    return offset == payload.size();
+}
+
+std::optional<std::span<const uint8_t>> SensorsRuntimeImage::GetScriptBytecode(uint16_t sensor_index, uint32_t source_checksum) const {
+    auto it = std::find_if(scripts_.begin(), scripts_.end(), [sensor_index](const ScriptView& script) {
+        return script.sensor_index == sensor_index;
+    });
+
+    if(it == scripts_.end() || it->source_checksum != source_checksum || it->bytecode.empty())
+        return std::nullopt;
+
+    return it->bytecode;
+}
+
+bool SensorsRuntimeImage::Save(
+    const SensorsRuntimeImageKey& key,
+    std::span<const uint16_t> order,
+    std::span<const SensorsRuntimeImageScript> scripts) {
+
+    if(fs_service_ == nullptr || !fs_service_->IsAvailable())
+        return false;
+
+    std::pmr::vector<uint8_t> image(image_.get_allocator());
+
+    size_t image_size = sizeof(Header) + order.size_bytes();
+    for(const auto& script : scripts)
+        image_size += sizeof(ScriptHeader) + script.bytecode.size();
+
+    image.resize(sizeof(Header));
+    image.reserve(image_size);
+
+    auto order_bytes = std::as_bytes(order);
+    image.insert(
+        image.end(),
+        reinterpret_cast<const uint8_t*>(order_bytes.data()),
+        reinterpret_cast<const uint8_t*>(order_bytes.data()) + order_bytes.size());
+
+    for(const auto& script : scripts) {
+        ScriptHeader script_header = {
+            .sensor_index = script.sensor_index,
+            .reserved = 0,
+            .source_checksum = script.source_checksum,
+            .bytecode_size = static_cast<uint32_t>(script.bytecode.size())
+        };
+
+        auto* script_header_bytes = reinterpret_cast<const uint8_t*>(&script_header);
+        image.insert(image.end(), script_header_bytes, script_header_bytes + sizeof(ScriptHeader));
+        image.insert(image.end(), script.bytecode.begin(), script.bytecode.end());
+    }
+
+    auto payload = std::span<const uint8_t>(image).subspan(sizeof(Header));
+
+    Header header = {
+        .magic = MAGIC,
+        .version = VERSION,
+        .sensor_count = key.sensor_count,
+        .config_checksum = key.config_checksum,
+        .gpio_channel_count = key.gpio_channel_count,
+        .adc_channel_count = key.adc_channel_count,
+        .script_count = static_cast<uint32_t>(scripts.size()),
+        .payload_size = static_cast<uint32_t>(payload.size()),
+        .payload_checksum = crc32_ieee(payload.data(), payload.size())
+    };
+    std::memcpy(image.data(), &header, sizeof(Header));
+
+    if(!fs_service_->WriteFile(path_, image.data(), image.size())) {
+        LOG_ERR("Failed to save sensors runtime image.");
+        return false;
+    }
+
+    LOG_INF("Sensors runtime image saved, %zu bytes.", image.size());
+
+    return true;
+}
+
+void SensorsRuntimeImage::Invalidate() {
+    Clear();
+
+    if(fs_service_ != nullptr && fs_service_->IsAvailable() && fs_service_->Exists(path_))
+        fs_service_->DeleteFile(path_);
+}
+
+} // namespace eerie_leap::domain::sensor_domain::utilities
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "utilities/memory/memory_resource_manager.h"
+#include "subsys/fs/services/i_fs_service.h"
+
+namespace eerie_leap::domain::sensor_domain::utilities {
+
+using namespace eerie_leap::utilities::memory;
+using namespace eerie_leap::subsys::fs::services;
+
+// Configuration the image was built from
+struct SensorsRuntimeImageKey {
+    uint32_t config_checksum;
+    uint16_t sensor_count;
+    uint16_t gpio_channel_count;
+    uint16_t adc_channel_count;
+};
+
+struct SensorsRuntimeImageScript {
+    // Index of the sensor in the configuration
+    uint16_t sensor_index;
+    uint32_t source_checksum;
+    std::pmr::vector<uint8_t> bytecode;
+};
+
+// Work done building sensors from a validated configuration, persisted so
+// the next boot with the same configuration doesn't repeat it. The image
+// holds the processing order of sensors, as indexes into the configuration,
+// and the compiled bytecode of their Lua scripts along with the checksum of
+// the source it was compiled from.
+// Image is read into memory as a whole and used in place, it is discarded
+// if the key or its own checksum doesn't match.
+class SensorsRuntimeImage {
+private:
+    static constexpr uint32_t MAGIC = 0x49524C45; // "ELRI"
+    static constexpr uint16_t VERSION = 1;
+
+    struct Header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t sensor_count;
+        uint32_t config_checksum;
+        uint16_t gpio_channel_count;
+        uint16_t adc_channel_count;
+        uint32_t script_count;
+        uint32_t payload_size;
+        uint32_t payload_checksum;
+    };
+
+    struct ScriptHeader {
+        uint16_t sensor_index;
+        uint16_t reserved;
+        uint32_t source_checksum;
+        uint32_t bytecode_size;
+    };
+
+    struct ScriptView {
+        uint16_t sensor_index;
+        uint32_t source_checksum;
+        std::span<const uint8_t> bytecode;
+    };
+
+    std::shared_ptr<IFsService> fs_service_;
+    std::string path_;
+
+    std::pmr::vector<uint8_t> image_;
+    std::vector<uint16_t> order_;
+    std::vector<ScriptView> scripts_;
+    bool is_loaded_;
+
+    bool Parse(const SensorsRuntimeImageKey& key);
+    void Clear();
+
+public:
+    SensorsRuntimeImage(
+        std::shared_ptr<IFsService> fs_service,
+        std::string path,
+        std::pmr::memory_resource* mr = Mrm::GetExtPmr());
+
+    // Loads the image built from the configuration, false if there is none
+    bool Load(const SensorsRuntimeImageKey& key);
+    bool IsLoaded() const { return is_loaded_; }
+
+    const std::vector<uint16_t>& GetOrder() const { return order_; }
+    // Bytecode of the sensor script, if compiled from the same source
+    std::optional<std::span<const uint8_t>> GetScriptBytecode(uint16_t sensor_index, uint32_t source_checksum) const;
+
+    bool Save(
+        const SensorsRuntimeImageKey& key,
+        std::span<const uint16_t> order,
+        std::span<const SensorsRuntimeImageScript> scripts);
+    void Invalidate();
+};
+
+} // namespace eerie_leap::domain::sensor_domain::utilities
@@ -7,6 +7,8 @@ namespace eerie_leap::subsys::canbus {
 
 struct CanFrame {
     uint32_t id;
+    // CAN_FRAME_* flags of the driver frame
+    uint8_t flags;
     bool is_transmit;
     bool is_can_fd;
     std::vector<uint8_t> data;
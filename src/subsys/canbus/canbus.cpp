@@ -22,7 +22,8 @@ Canbus::Canbus(
         is_extended_id_(is_extended_id),
         bitrate_(bitrate),
         data_bitrate_(data_bitrate),
-        auto_detect_running_(ATOMIC_INIT(0)) {
+        auto_detect_running_(ATOMIC_INIT(0)),
+        detect_frame_count_(ATOMIC_INIT(0)) {
 
     k_msgq_init(
         &frame_msgq_,
@@ -30,6 +31,9 @@ Canbus::Canbus(
         sizeof(IsrCanFrameWrapper),
         FRAME_MSGQ_SIZE);
 
+    k_sem_init(&detect_frame_sem_, 0, K_SEM_MAX_LIMIT);
+    k_mutex_init(&raw_frame_filters_mutex_);
+
     if(type_ == CanbusType::CANFD && data_bitrate_ == 0)
         data_bitrate_ = bitrate_;
 
@@ -43,6 +47,20 @@ Canbus::Canbus(
 
 Canbus::~Canbus() {
     StopActivityMonitoring();
+
+    // Device is going away, filters are removed without restoring per-ID ones
+    RemoveStatisticsFilters();
+    statistics_.reset();
+
+    for(const auto& [_, filter_id] : can_filter_ids_)
+        can_remove_rx_filter(canbus_dev_, filter_id);
+    can_filter_ids_.clear();
+
+    k_mutex_lock(&raw_frame_filters_mutex_, K_FOREVER);
+    for(const auto& [filter_id, _] : raw_frame_filters_)
+        can_remove_rx_filter(canbus_dev_, filter_id);
+    raw_frame_filters_.clear();
+    k_mutex_unlock(&raw_frame_filters_mutex_);
     if(canbus_dev_ != nullptr && is_initialized_)
         can_stop(canbus_dev_);
 
@@ -65,12 +83,20 @@ bool Canbus::Initialize() {
 
     thread_->Initialize();
 
-    can_mode_t can_mode = CAN_MODE_NORMAL;
+    can_mode_ = CAN_MODE_NORMAL;
     if(type_ == CanbusType::CANFD && (capabilities & CAN_MODE_FD))
-        can_mode = CAN_MODE_FD;
+        can_mode_ = CAN_MODE_FD;
     else
         type_ = CanbusType::CLASSICAL_CAN;
 
+    is_listen_only_supported_ = (capabilities & CAN_MODE_LISTENONLY) != 0;
+
+    // NOTE: Listen-only keeps bitrate probing from disturbing the bus
+    // with error frames and ACKs while a wrong bitrate is being tested
+    can_mode_t can_mode = can_mode_;
+    if(bitrate_ == 0 && is_listen_only_supported_)
+        can_mode |= CAN_MODE_LISTENONLY;
+
     ret = can_set_mode(canbus_dev_, can_mode);
 	if(ret != 0) {
 		LOG_ERR("Failed to set mode [%d].", ret);
@@ -175,9 +201,28 @@ void Canbus::SendFrame(uint32_t frame_id, std::span<const uint8_t> frame_data) {
         return;
     }
 
+    if(statistics_)
+        statistics_->RecordFrame(can_frame);
+
     LOG_DBG("Frame sent: ID=0x%08X, DLC=%d", frame_id, can_bytes_to_dlc(frame_data.size()));
 }
 
+bool Canbus::SendRawFrame(const can_frame& frame) {
+    if(!is_initialized_ || !bitrate_detected_)
+        return false;
+
+    int res = can_send(canbus_dev_, &frame, K_NO_WAIT, SendFrameCallback, nullptr);
+    if(res != 0) {
+        LOG_DBG("Failed to send raw frame [%d].", res);
+        return false;
+    }
+
+    if(statistics_)
+        statistics_->RecordFrame(frame);
+
+    return true;
+}
+
 void Canbus::SendFrameCallback(const device* dev, int error, void* user_data) {
     if(error != 0)
         LOG_ERR("SendFrameCallback error: %d", error);
@@ -188,17 +233,48 @@ void Canbus::CanFrameReceivedCallback(const device *dev, can_frame *frame, void
 
     auto* canbus = static_cast<Canbus*>(user_data);
 
-    if(!canbus->handlers_.contains(frame->id))
+    // NOTE: Handlers are registered for standard IDs, catch-all statistics
+    // filters also deliver extended frames which may share the numeric ID
+    if((frame->flags & CAN_FRAME_IDE) != 0 || !canbus->handlers_.contains(frame->id))
         return;
 
     IsrCanFrameWrapper wrapper = {
         .canbus = canbus,
+        .raw_filter_id = -1,
+        .raw_filter_generation = 0,
+        .rx_cycles = 0,
         .frame = *frame
     };
 
     k_msgq_put(&canbus->frame_msgq_, &wrapper, K_NO_WAIT);
 }
 
+void Canbus::RawFrameReceivedCallback(const device *dev, can_frame *frame, void *user_data) {
+    auto* raw_filter = static_cast<RawFrameFilter*>(user_data);
+    if(raw_filter->filter_id < 0)
+        return;
+
+    IsrCanFrameWrapper wrapper = {
+        .canbus = raw_filter->canbus,
+        .raw_filter_id = raw_filter->filter_id,
+        .raw_filter_generation = raw_filter->generation,
+        .rx_cycles = k_cycle_get_32(),
+        .frame = *frame
+    };
+
+    if(k_msgq_put(&raw_filter->canbus->frame_msgq_, &wrapper, K_NO_WAIT) != 0)
+        atomic_inc(&raw_filter->overflow_count);
+}
+
+void Canbus::StatisticsFrameReceivedCallback(const device *dev, can_frame *frame, void *user_data) {
+    auto* canbus = static_cast<Canbus*>(user_data);
+
+    if(canbus->statistics_)
+        canbus->statistics_->RecordFrame(*frame);
+
+    CanFrameReceivedCallback(dev, frame, user_data);
+}
+
 int Canbus::RegisterFrameReceivedHandler(uint32_t can_id, CanFrameHandler handler) {
     if(!is_initialized_) {
         LOG_ERR("CANBus is not initialized.");
@@ -238,7 +314,11 @@ bool Canbus::RegisterFilter(uint32_t can_id) {
     if(!handlers_.contains(can_id))
         throw std::runtime_error("Handler not found for ID " + std::to_string(can_id));
 
-    if(!can_filters_.contains(can_id)) {
+    // Catch-all statistics filters already deliver this ID
+    if(IsStatisticsFilterInstalled())
+        return true;
+
+    if(!can_filter_ids_.contains(can_id)) {
         can_filter filter = {
             .id = can_id,
             .mask = CAN_STD_ID_MASK,
@@ -251,7 +331,7 @@ bool Canbus::RegisterFilter(uint32_t can_id) {
             return false;
         }
 
-        can_filters_.insert({can_id, filter});
+        can_filter_ids_.insert({can_id, filter_id});
     }
 
     return true;
@@ -274,9 +354,9 @@ bool Canbus::RemoveFrameReceivedHandler(uint32_t can_id, int handler_id) {
     handler_list.erase(handler_id);
     if(handler_list.empty()) {
         // Remove filter
-        if(can_filters_.contains(can_id)) {
-            can_remove_rx_filter(canbus_dev_, can_filters_.at(can_id).id);
-            can_filters_.erase(can_id);
+        if(can_filter_ids_.contains(can_id)) {
+            can_remove_rx_filter(canbus_dev_, can_filter_ids_.at(can_id));
+            can_filter_ids_.erase(can_id);
         }
 
         handlers_.erase(can_id);
@@ -285,6 +365,73 @@ bool Canbus::RemoveFrameReceivedHandler(uint32_t can_id, int handler_id) {
     return true;
 }
 
+int Canbus::AddRawFrameFilter(uint32_t id, uint32_t mask, bool is_extended_id, RawCanFrameHandler handler) {
+    if(!is_initialized_) {
+        LOG_ERR("CANBus is not initialized.");
+        return -1;
+    }
+
+    auto raw_filter = std::make_unique<RawFrameFilter>();
+    raw_filter->canbus = this;
+    raw_filter->filter_id = -1;
+    raw_filter->overflow_count = ATOMIC_INIT(0);
+    raw_filter->handler = std::move(handler);
+
+    can_filter filter = {
+        .id = id,
+        .mask = mask,
+        .flags = static_cast<uint8_t>(is_extended_id ? CAN_FILTER_IDE : 0)
+    };
+
+    // Filter ID is known only once the filter is added,
+    // frames arriving before that are dropped by the callback
+    int filter_id = can_add_rx_filter(canbus_dev_, RawFrameReceivedCallback, raw_filter.get(), &filter);
+    if(filter_id < 0) {
+        LOG_ERR("Unable to add raw rx filter [%d].", filter_id);
+        return -1;
+    }
+
+    k_mutex_lock(&raw_frame_filters_mutex_, K_FOREVER);
+
+    raw_filter->generation = ++raw_filter_generation_;
+    raw_filter->filter_id = filter_id;
+    raw_frame_filters_.emplace(filter_id, std::move(raw_filter));
+
+    k_mutex_unlock(&raw_frame_filters_mutex_);
+
+    return filter_id;
+}
+
+bool Canbus::RemoveRawFrameFilter(int filter_id) {
+    k_mutex_lock(&raw_frame_filters_mutex_, K_FOREVER);
+
+    auto it = raw_frame_filters_.find(filter_id);
+    if(it == raw_frame_filters_.end()) {
+        k_mutex_unlock(&raw_frame_filters_mutex_);
+        return false;
+    }
+
+    can_remove_rx_filter(canbus_dev_, filter_id);
+    raw_frame_filters_.erase(it);
+
+    k_mutex_unlock(&raw_frame_filters_mutex_);
+
+    return true;
+}
+
+uint32_t Canbus::GetRawFrameFilterOverflowCount(int filter_id) const {
+    k_mutex_lock(&raw_frame_filters_mutex_, K_FOREVER);
+
+    auto it = raw_frame_filters_.find(filter_id);
+    uint32_t overflow_count = it != raw_frame_filters_.end()
+        ? static_cast<uint32_t>(atomic_get(&it->second->overflow_count))
+        : 0;
+
+    k_mutex_unlock(&raw_frame_filters_mutex_);
+
+    return overflow_count;
+}
+
 bool Canbus::StartActivityMonitoring() {
     atomic_set(&auto_detect_running_, 1);
 
@@ -317,6 +464,11 @@ void Canbus::BitrateAutodetectTask() {
             if(bitrate_detected_fn_)
                 bitrate_detected_fn_(bitrate_);
 
+            if(statistics_) {
+                statistics_->SetBitrates(bitrate_, data_bitrate_);
+                InstallStatisticsFilters();
+            }
+
             for(const auto& [can_id, _] : handlers_)
                 RegisterFilter(can_id);
 
@@ -337,8 +489,24 @@ void Canbus::ProcessFramesTask() {
     auto* canbus = frame_wrapper.canbus;
     can_frame* frame = &frame_wrapper.frame;
 
+    if(frame_wrapper.raw_filter_id >= 0) {
+        k_mutex_lock(&canbus->raw_frame_filters_mutex_, K_FOREVER);
+
+        auto it = canbus->raw_frame_filters_.find(frame_wrapper.raw_filter_id);
+        if(it != canbus->raw_frame_filters_.end()
+            && it->second->generation == frame_wrapper.raw_filter_generation) {
+
+            it->second->handler(*frame, frame_wrapper.rx_cycles);
+        }
+
+        k_mutex_unlock(&canbus->raw_frame_filters_mutex_);
+
+        return;
+    }
+
     CanFrame can_frame = {
         .id = frame->id,
+        .flags = frame->flags,
         .is_transmit = false,
         .is_can_fd = (frame->flags & CAN_FRAME_FDF) != 0
     };
@@ -360,30 +528,70 @@ bool Canbus::AutoDetectBitrate() {
     else
         supported_bitrates = classical_can_supported_bitrates_;
 
-    for(int i = 0; i < supported_bitrates.size(); i++) {
+    // Last known bitrate goes first, the bus rarely changes between boots
+    std::array<uint32_t, canfd_supported_bitrates_.size()> candidates = {};
+    size_t candidate_count = 0;
+
+    if(bitrate_hint_ != 0 && IsBitrateSupported(type_, bitrate_hint_))
+        candidates[candidate_count++] = bitrate_hint_;
+
+    for(uint32_t bitrate : supported_bitrates) {
+        if(bitrate != bitrate_hint_)
+            candidates[candidate_count++] = bitrate;
+    }
+
+    for(size_t i = 0; i < candidate_count; i++) {
         if(!atomic_get(&auto_detect_running_)) {
             LOG_WRN("Bitrate detection stopped by user");
             return false;
         }
 
         uint32_t frame_count = 0;
-        if(TestBitrate(supported_bitrates[i], frame_count)) {
-            bitrate_detected_ = true;
-            bitrate_ = supported_bitrates[i];
+        if(TestBitrate(candidates[i], frame_count) && StartDetectedBitrate(candidates[i])) {
+            bitrate_ = candidates[i];
 
             if(type_ == CanbusType::CANFD && data_bitrate_ == 0)
-                data_bitrate_ = supported_bitrates[i];
+                data_bitrate_ = candidates[i];
+
+            bitrate_detected_ = true;
 
             return true;
         }
 
         can_stop(canbus_dev_);
-        k_sleep(K_MSEC(50));
     }
 
     return false;
 }
 
+bool Canbus::StartDetectedBitrate(uint32_t bitrate) {
+    if(!is_listen_only_supported_)
+        return true;
+
+    // Leave listen-only mode so the node can ACK and transmit
+    can_stop(canbus_dev_);
+
+    int ret = can_set_mode(canbus_dev_, can_mode_);
+    if(ret != 0) {
+        LOG_ERR("Failed to set mode [%d].", ret);
+        return false;
+    }
+
+    if(!SetTiming(bitrate))
+        return false;
+
+    if(type_ == CanbusType::CANFD && !SetDataTiming(data_bitrate_ == 0 ? bitrate : data_bitrate_))
+        return false;
+
+    ret = can_start(canbus_dev_);
+    if(ret != 0) {
+        LOG_ERR("Failed to start device [%d].", ret);
+        return false;
+    }
+
+    return true;
+}
+
 bool Canbus::IsBitrateSupported(CanbusType type, uint32_t bitrate) {
     if(bitrate == 0)
         return true;
@@ -395,6 +603,9 @@ bool Canbus::IsBitrateSupported(CanbusType type, uint32_t bitrate) {
 }
 
 bool Canbus::TestBitrate(uint32_t bitrate, uint32_t &frame_count) {
+    if(is_listen_only_supported_ && can_set_mode(canbus_dev_, can_mode_ | CAN_MODE_LISTENONLY) != 0)
+        return false;
+
     if(!SetTiming(bitrate))
         return false;
 
@@ -410,54 +621,192 @@ bool Canbus::TestBitrate(uint32_t bitrate, uint32_t &frame_count) {
         return false;
     }
 
-    can_filter filter = {
-        .id = 0,
-        .mask = 0,  // Accept all IDs
-        .flags = 0
-    };
+    k_sem_reset(&detect_frame_sem_);
+    atomic_set(&detect_frame_count_, 0);
 
-    volatile uint32_t received_frames = 0;
+    enum can_state state;
+    struct can_bus_err_cnt base_err_cnt;
 
-    int filter_id = can_add_rx_filter(canbus_dev_,
-        [](const device *dev, can_frame *frame, void *user_data) {
-            volatile uint32_t *counter = static_cast<volatile uint32_t*>(user_data);
-            (*counter)++;
-        },
-        (void*)&received_frames,
-        &filter);
+    ret = can_get_state(canbus_dev_, &state, &base_err_cnt);
+    if(ret != 0)
+        return false;
 
-    if(filter_id < 0) {
-        LOG_WRN("Failed to add test filter [%d]", filter_id);
-        can_stop(canbus_dev_);
+    // Accept all standard and extended IDs
+    const std::array<can_filter, 2> filters = {{
+        { .id = 0, .mask = 0, .flags = 0 },
+        { .id = 0, .mask = 0, .flags = CAN_FILTER_IDE }
+    }};
+    std::array<int, 2> filter_ids = {-1, -1};
 
-        return false;
+    for(size_t i = 0; i < filters.size(); ++i) {
+        filter_ids[i] = can_add_rx_filter(canbus_dev_, DetectFrameReceivedCallback, this, &filters[i]);
+        if(filter_ids[i] < 0) {
+            LOG_WRN("Failed to add test filter [%d]", filter_ids[i]);
+
+            for(int filter_id : filter_ids) {
+                if(filter_id >= 0)
+                    can_remove_rx_filter(canbus_dev_, filter_id);
+            }
+
+            return false;
+        }
     }
 
-    k_sleep(K_MSEC(AUTO_DETECT_TIMEOUT_MS));
-    can_remove_rx_filter(canbus_dev_, filter_id);
-    frame_count = received_frames;
+    // NOTE: Wakes on every received frame or poll interval, returns as soon
+    // as enough valid frames arrived, and gives up on a climbing error counter
+    // which is how a wrong bitrate shows long before the timeout runs out
+    bool is_detected = false;
+    int64_t deadline = k_uptime_get() + AUTO_DETECT_TIMEOUT_MS;
+
+    while(true) {
+        int64_t remaining_ms = deadline - k_uptime_get();
+        if(remaining_ms <= 0)
+            break;
+
+        k_sem_take(&detect_frame_sem_, K_MSEC(std::min<int64_t>(remaining_ms, AUTO_DETECT_POLL_MS)));
 
-    if(received_frames >= MIN_FRAMES_FOR_DETECTION) {
-        enum can_state state;
         struct can_bus_err_cnt err_cnt;
+        if(can_get_state(canbus_dev_, &state, &err_cnt) != 0)
+            break;
 
-        int ret = can_get_state(canbus_dev_, &state, &err_cnt);
-        if(ret != 0)
-            return false;
+        int rx_error_delta = static_cast<int>(err_cnt.rx_err_cnt) - base_err_cnt.rx_err_cnt;
+        if(state != CAN_STATE_ERROR_ACTIVE || rx_error_delta >= MAX_DETECTION_ERROR_DELTA) {
+            LOG_DBG("Bitrate %u rejected, state: %d, RX errors: %u", bitrate, state, err_cnt.rx_err_cnt);
+            break;
+        }
 
-        // Valid activity means error-active state with reasonable error counts
-        return (state == CAN_STATE_ERROR_ACTIVE
-            && err_cnt.tx_err_cnt < 128
-            && err_cnt.rx_err_cnt < 128);
+        if(atomic_get(&detect_frame_count_) >= MIN_FRAMES_FOR_DETECTION) {
+            is_detected = true;
+            break;
+        }
     }
 
-    return false;
+    for(int filter_id : filter_ids)
+        can_remove_rx_filter(canbus_dev_, filter_id);
+
+    frame_count = atomic_get(&detect_frame_count_);
+
+    return is_detected;
+}
+
+void Canbus::DetectFrameReceivedCallback(const device *dev, can_frame *frame, void *user_data) {
+    auto* canbus = static_cast<Canbus*>(user_data);
+
+    atomic_inc(&canbus->detect_frame_count_);
+    k_sem_give(&canbus->detect_frame_sem_);
 }
 
 void Canbus::RegisterBitrateDetectedCallback(const BitrateDetectedCallback& callback) {
     bitrate_detected_fn_ = callback;
 }
 
+bool Canbus::EnableStatistics(uint32_t window_ms) {
+    if(!is_initialized_) {
+        LOG_ERR("CANBus is not initialized.");
+        return false;
+    }
+
+    if(statistics_)
+        return true;
+
+    statistics_ = std::make_unique<CanbusStatistics>(
+        bitrate_detected_ ? bitrate_ : 0,
+        type_ == CanbusType::CANFD ? data_bitrate_ : 0,
+        window_ms);
+
+    // Filters are installed once the bitrate is known
+    if(bitrate_detected_ && !InstallStatisticsFilters()) {
+        statistics_.reset();
+        return false;
+    }
+
+    LOG_INF("CANBus statistics enabled, window: %u ms.", window_ms);
+
+    return true;
+}
+
+void Canbus::DisableStatistics() {
+    if(!statistics_)
+        return;
+
+    RemoveStatisticsFilters();
+    statistics_.reset();
+
+    for(const auto& [can_id, _] : handlers_)
+        RegisterFilter(can_id);
+
+    LOG_INF("CANBus statistics disabled.");
+}
+
+bool Canbus::InstallStatisticsFilters() {
+    if(IsStatisticsFilterInstalled())
+        return true;
+
+    const std::array<can_filter, 2> filters = {{
+        { .id = 0, .mask = 0, .flags = 0 },
+        { .id = 0, .mask = 0, .flags = CAN_FILTER_IDE }
+    }};
+
+    for(size_t i = 0; i < filters.size(); ++i) {
+        int filter_id = can_add_rx_filter(canbus_dev_, StatisticsFrameReceivedCallback, this, &filters[i]);
+        if(filter_id < 0) {
+            LOG_ERR("Unable to add statistics rx filter [%d].", filter_id);
+            RemoveStatisticsFilters();
+
+            return false;
+        }
+
+        statistics_filter_ids_[i] = filter_id;
+    }
+
+    // Per-ID filters would deliver frames twice on drivers calling every matching filter
+    for(const auto& [_, filter_id] : can_filter_ids_)
+        can_remove_rx_filter(canbus_dev_, filter_id);
+    can_filter_ids_.clear();
+
+    return true;
+}
+
+void Canbus::RemoveStatisticsFilters() {
+    for(auto& filter_id : statistics_filter_ids_) {
+        if(filter_id >= 0)
+            can_remove_rx_filter(canbus_dev_, filter_id);
+        filter_id = -1;
+    }
+}
+
+std::optional<CanbusStatisticsReport> Canbus::GetStatisticsReport(size_t top_n) {
+    if(!statistics_)
+        return std::nullopt;
+
+    return statistics_->GetReport(top_n);
+}
+
+void Canbus::PrintStatisticsReport(size_t top_n) {
+    auto report = GetStatisticsReport(top_n);
+    if(!report.has_value()) {
+        LOG_INF("CANBus statistics are disabled.");
+        return;
+    }
+
+    LOG_INF("CANBus %s statistics, window: %u ms", canbus_dev_->name, report->window_ms);
+    LOG_INF("  Bus load: %.1f%%, peak: %.1f%%", (double)report->bus_load_percent, (double)report->peak_bus_load_percent);
+    LOG_INF("  Frames: %u, bytes: %u, untracked frames: %u",
+        report->frame_count, report->byte_count, report->untracked_frame_count);
+
+    for(const auto& id_statistics : report->top_ids) {
+        LOG_INF("  ID 0x%08X%s: load %.2f%%, frames %u, bytes %u, inter-arrival min/mean/max %u/%u/%u us",
+            id_statistics.id,
+            id_statistics.is_extended_id ? " (ext)" : "",
+            (double)id_statistics.bus_load_percent,
+            id_statistics.frame_count,
+            id_statistics.byte_count,
+            id_statistics.inter_arrival_min_us,
+            id_statistics.inter_arrival_mean_us,
+            id_statistics.inter_arrival_max_us);
+    }
+}
+
 // NOTE: Borrowed from zephyr/drivers/can/can_common.c
 uint16_t sample_point_for_bitrate(uint32_t bitrate) {
 	uint16_t sample_pnt;
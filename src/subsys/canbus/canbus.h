@@ -6,6 +6,8 @@
 #include <vector>
 #include <unordered_map>
 #include <functional>
+#include <memory>
+#include <optional>
 
 #include <zephyr/kernel.h>
 #include <zephyr/devicetree.h>
@@ -17,27 +19,47 @@
 
 #include "canbus_type.h"
 #include "can_frame.h"
+#include "canbus_statistics.h"
 
 namespace eerie_leap::subsys::canbus {
 
 using namespace eerie_leap::subsys::threading;
 
 using CanFrameHandler = std::function<void (const CanFrame&)>;
+using RawCanFrameHandler = std::function<void (const can_frame& frame, uint32_t rx_cycles)>;
 
 class Canbus : public IThread {
 private:
     struct IsrCanFrameWrapper {
         Canbus* canbus;
+        int raw_filter_id;
+        uint32_t raw_filter_generation;
+        uint32_t rx_cycles;
         can_frame frame;
     };
 
-    static constexpr int FRAME_MSGQ_SIZE = 4;
+    struct RawFrameFilter {
+        Canbus* canbus;
+        int filter_id;
+        // NOTE: Driver reuses filter IDs, frames queued for a removed
+        // filter are told apart from the new one by the generation
+        uint32_t generation;
+        atomic_t overflow_count;
+        RawCanFrameHandler handler;
+    };
+
+    static constexpr int FRAME_MSGQ_SIZE = CONFIG_EERIE_LEAP_CANBUS_RX_QUEUE_SIZE;
     char frame_msgq_buffer_[FRAME_MSGQ_SIZE * sizeof(IsrCanFrameWrapper)];
     k_msgq frame_msgq_;
 
     const device *canbus_dev_;
-    std::unordered_map<uint32_t, can_filter> can_filters_;
+    std::unordered_map<uint32_t, int> can_filter_ids_;
     std::unordered_map<uint32_t, std::unordered_map<int, CanFrameHandler>> handlers_;
+    std::unordered_map<int, std::unique_ptr<RawFrameFilter>> raw_frame_filters_;
+    // Held while raw handlers run, so once a filter is removed
+    // its handler is neither running nor called again
+    mutable k_mutex raw_frame_filters_mutex_;
+    uint32_t raw_filter_generation_ = 0;
 
     bool is_initialized_ = false;
     CanbusType type_;
@@ -45,12 +67,27 @@ private:
     uint32_t bitrate_;
     uint32_t data_bitrate_;
     bool bitrate_detected_ = false;
+    uint32_t bitrate_hint_ = 0;
+    can_mode_t can_mode_ = CAN_MODE_NORMAL;
+    bool is_listen_only_supported_ = false;
     atomic_t auto_detect_running_;
     std::function<void (uint32_t bitrate)> bitrate_detected_fn_;
 
+    // NOTE: While statistics are enabled, per-ID filters are replaced
+    // by catch-all filters which record every frame and then dispatch it
+    std::unique_ptr<CanbusStatistics> statistics_;
+    std::array<int, 2> statistics_filter_ids_ = {-1, -1};
+
     static constexpr k_timeout_t FRAME_SEND_TIMEOUT_MS = K_MSEC(2);
     static constexpr uint32_t AUTO_DETECT_TIMEOUT_MS = 500;
+    static constexpr uint32_t AUTO_DETECT_POLL_MS = 10;
     static constexpr uint32_t MIN_FRAMES_FOR_DETECTION = 3;
+    static constexpr uint8_t MAX_DETECTION_ERROR_DELTA = 8;
+
+    // NOTE: Given from the test RX filter, lets TestBitrate return
+    // as soon as enough valid frames arrived instead of sleeping
+    k_sem detect_frame_sem_;
+    atomic_t detect_frame_count_;
 
     // NOTE: Thread is used as a Bottom Half for IRQ processing
     // and should have highest priority, or have MetaIRQ priority level,
@@ -79,12 +116,19 @@ private:
     void StopActivityMonitoring();
     bool AutoDetectBitrate();
     bool TestBitrate(uint32_t bitrate, uint32_t &frame_count);
+    bool StartDetectedBitrate(uint32_t bitrate);
+    static void DetectFrameReceivedCallback(const device *dev, can_frame *frame, void *user_data);
 
     static void SendFrameCallback(const device* dev, int error, void* user_data);
     bool SetTiming(uint32_t bitrate);
     bool SetDataTiming(uint32_t bitrate);
     bool RegisterFilter(uint32_t can_id);
     static void CanFrameReceivedCallback(const device *dev, can_frame *frame, void *user_data);
+    static void StatisticsFrameReceivedCallback(const device *dev, can_frame *frame, void *user_data);
+    static void RawFrameReceivedCallback(const device *dev, can_frame *frame, void *user_data);
+    bool InstallStatisticsFilters();
+    void RemoveStatisticsFilters();
+    bool IsStatisticsFilterInstalled() const { return statistics_filter_ids_[0] >= 0; }
     void PrintCanLimits();
     void PrintCanFdLimits();
 
@@ -103,11 +147,28 @@ public:
     int RegisterFrameReceivedHandler(uint32_t can_id, CanFrameHandler handler);
     bool RemoveFrameReceivedHandler(uint32_t can_id, int handler_id);
 
+    // NOTE: Raw handlers get frames matching id/mask straight from the bottom half
+    // as driver frames, skipping CanFrame conversion, meant for low latency forwarding.
+    // Handler is not running anymore once RemoveRawFrameFilter returns.
+    int AddRawFrameFilter(uint32_t id, uint32_t mask, bool is_extended_id, RawCanFrameHandler handler);
+    bool RemoveRawFrameFilter(int filter_id);
+    uint32_t GetRawFrameFilterOverflowCount(int filter_id) const;
+
     CanbusType GetType() const { return type_; }
     void SendFrame(uint32_t frame_id, std::span<const uint8_t> frame_data);
+    bool SendRawFrame(const can_frame& frame);
     uint32_t GetDetectedBitrate() const { return bitrate_; }
     bool IsBitrateDetected() const { return bitrate_detected_; }
     void RegisterBitrateDetectedCallback(const BitrateDetectedCallback& callback);
+    // Bitrate tried first by auto-detection, usually the one detected on last boot
+    void SetBitrateHint(uint32_t bitrate) { bitrate_hint_ = bitrate; }
+
+    // Bus statistics
+    bool EnableStatistics(uint32_t window_ms = CONFIG_EERIE_LEAP_CANBUS_STATISTICS_WINDOW_MS);
+    void DisableStatistics();
+    bool IsStatisticsEnabled() const { return statistics_ != nullptr; }
+    std::optional<CanbusStatisticsReport> GetStatisticsReport(size_t top_n = 10);
+    void PrintStatisticsReport(size_t top_n = 10);
 
     static bool IsBitrateSupported(CanbusType type, uint32_t bitrate);
 };
@@ -0,0 +1,220 @@
+#include <algorithm>
+
+#include <zephyr/logging/log.h>
+
+#include "canbus_gateway.h"
+
+LOG_MODULE_REGISTER(canbus_gateway_logger);
+
+namespace eerie_leap::subsys::canbus {
+
+CanbusGateway::CanbusGateway(CanbusProvider canbus_provider)
+    : canbus_provider_(std::move(canbus_provider)) {}
+
+CanbusGateway::~CanbusGateway() {
+    Stop();
+}
+
+bool CanbusGateway::IsRouteValid(const CanbusGatewayRoute& route) {
+    uint32_t id_mask = route.is_extended_id ? CAN_EXT_ID_MASK : CAN_STD_ID_MASK;
+
+    if((route.source_id & ~id_mask) != 0 || (route.source_mask & ~id_mask) != 0)
+        return false;
+
+    if(route.destination_id.has_value() && (route.destination_id.value() & ~CAN_EXT_ID_MASK) != 0)
+        return false;
+
+    // Forwarding unchanged frames back to the source bus would loop
+    if(route.source_bus_channel == route.destination_bus_channel
+        && (!route.destination_id.has_value() || route.destination_id.value() == route.source_id))
+        return false;
+
+    return true;
+}
+
+bool CanbusGateway::Start(std::span<const CanbusGatewayRoute> routes) {
+    Stop();
+
+    for(const auto& route : routes) {
+        if(!IsRouteValid(route)) {
+            LOG_ERR("Invalid gateway route 0x%08X from bus %d to bus %d.",
+                route.source_id, route.source_bus_channel, route.destination_bus_channel);
+            Stop();
+
+            return false;
+        }
+
+        auto route_state = std::make_unique<RouteState>();
+        route_state->route = route;
+        route_state->source = canbus_provider_(route.source_bus_channel);
+        route_state->destination = canbus_provider_(route.destination_bus_channel);
+
+        if(route_state->source == nullptr || route_state->destination == nullptr) {
+            LOG_ERR("Gateway route bus %d to bus %d references unavailable channel.",
+                route.source_bus_channel, route.destination_bus_channel);
+            Stop();
+
+            return false;
+        }
+
+        RouteState* route_state_p = route_state.get();
+        route_state->filter_id = route_state->source->AddRawFrameFilter(
+            route.source_id,
+            route.source_mask,
+            route.is_extended_id,
+            [route_state_p](const can_frame& frame, uint32_t rx_cycles) {
+                ForwardFrame(*route_state_p, frame, rx_cycles);
+            });
+
+        if(route_state->filter_id < 0) {
+            LOG_ERR("Failed to add gateway filter for 0x%08X on bus %d.",
+                route.source_id, route.source_bus_channel);
+            Stop();
+
+            return false;
+        }
+
+        routes_.push_back(std::move(route_state));
+    }
+
+    LOG_INF("CANBus gateway started with %zu routes.", routes_.size());
+
+    return true;
+}
+
+void CanbusGateway::Stop() {
+    // Removal waits for a running handler and drops frames still queued
+    // for the filter, so route states are not referenced once freed
+    for(auto& route_state : routes_) {
+        if(route_state->filter_id >= 0)
+            route_state->source->RemoveRawFrameFilter(route_state->filter_id);
+    }
+
+    routes_.clear();
+}
+
+void CanbusGateway::ForwardFrame(RouteState& route_state, const can_frame& frame, uint32_t rx_cycles) {
+    const auto& route = route_state.route;
+    uint32_t now_ms = k_uptime_get_32();
+
+    if(route.min_interval_ms > 0
+        && route_state.has_forwarded
+        && now_ms - route_state.last_forwarded_ms < route.min_interval_ms) {
+
+        k_spinlock_key_t key = k_spin_lock(&route_state.lock);
+        route_state.rate_limited_count++;
+        k_spin_unlock(&route_state.lock, key);
+
+        return;
+    }
+
+    can_frame forwarded_frame = frame;
+
+    if(route.destination_id.has_value())
+        forwarded_frame.id = (frame.id & ~route.source_mask) | (route.destination_id.value() & route.source_mask);
+
+    if(forwarded_frame.id > CAN_STD_ID_MASK)
+        forwarded_frame.flags |= CAN_FRAME_IDE;
+
+    bool is_sent = false;
+
+    // CAN FD frames fit a classical bus only when their payload does
+    if(route_state.destination->GetType() == CanbusType::CANFD || frame.dlc <= CAN_MAX_DLC) {
+        if(route_state.destination->GetType() != CanbusType::CANFD)
+            forwarded_frame.flags &= ~(CAN_FRAME_FDF | CAN_FRAME_BRS);
+
+        is_sent = route_state.destination->SendRawFrame(forwarded_frame);
+    }
+
+    uint32_t latency_us = k_cyc_to_us_floor32(k_cycle_get_32() - rx_cycles);
+
+    k_spinlock_key_t key = k_spin_lock(&route_state.lock);
+
+    if(is_sent) {
+        route_state.forwarded_count++;
+        route_state.latency_sum_us += latency_us;
+        route_state.latency_min_us = std::min(route_state.latency_min_us, latency_us);
+        route_state.latency_max_us = std::max(route_state.latency_max_us, latency_us);
+        route_state.last_forwarded_ms = now_ms;
+        route_state.has_forwarded = true;
+    } else {
+        route_state.dropped_count++;
+    }
+
+    k_spin_unlock(&route_state.lock, key);
+}
+
+std::vector<CanbusGatewayRouteStatistics> CanbusGateway::GetStatistics() {
+    std::vector<CanbusGatewayRouteStatistics> statistics;
+    statistics.reserve(routes_.size());
+
+    for(auto& route_state : routes_) {
+        CanbusGatewayRouteStatistics route_statistics = { .route = route_state->route };
+
+        // RX queue overflows happen before the route sees the frame
+        uint32_t overflow_count = route_state->source->GetRawFrameFilterOverflowCount(route_state->filter_id);
+
+        k_spinlock_key_t key = k_spin_lock(&route_state->lock);
+
+        route_statistics.forwarded_count = route_state->forwarded_count;
+        route_statistics.dropped_count = route_state->dropped_count + overflow_count - route_state->overflow_count_base;
+        route_statistics.rate_limited_count = route_state->rate_limited_count;
+        route_statistics.latency_min_us = route_state->forwarded_count > 0 ? route_state->latency_min_us : 0;
+        route_statistics.latency_mean_us = route_state->forwarded_count > 0
+            ? static_cast<uint32_t>(route_state->latency_sum_us / route_state->forwarded_count)
+            : 0;
+        route_statistics.latency_max_us = route_state->latency_max_us;
+
+        k_spin_unlock(&route_state->lock, key);
+
+        statistics.push_back(route_statistics);
+    }
+
+    return statistics;
+}
+
+void CanbusGateway::ResetStatistics() {
+    for(auto& route_state : routes_) {
+        uint32_t overflow_count = route_state->source->GetRawFrameFilterOverflowCount(route_state->filter_id);
+
+        k_spinlock_key_t key = k_spin_lock(&route_state->lock);
+
+        route_state->overflow_count_base = overflow_count;
+        route_state->forwarded_count = 0;
+        route_state->dropped_count = 0;
+        route_state->rate_limited_count = 0;
+        route_state->latency_min_us = UINT32_MAX;
+        route_state->latency_max_us = 0;
+        route_state->latency_sum_us = 0;
+
+        k_spin_unlock(&route_state->lock, key);
+    }
+}
+
+void CanbusGateway::PrintStatistics() {
+    if(!IsRunning()) {
+        LOG_INF("CANBus gateway is not running.");
+        return;
+    }
+
+    LOG_INF("CANBus gateway statistics:");
+
+    for(const auto& route_statistics : GetStatistics()) {
+        const auto& route = route_statistics.route;
+
+        LOG_INF("  Bus %d 0x%08X/0x%08X -> bus %d 0x%08X: forwarded %u, dropped %u, rate limited %u, latency min/mean/max %u/%u/%u us",
+            route.source_bus_channel,
+            route.source_id,
+            route.source_mask,
+            route.destination_bus_channel,
+            route.destination_id.value_or(route.source_id),
+            route_statistics.forwarded_count,
+            route_statistics.dropped_count,
+            route_statistics.rate_limited_count,
+            route_statistics.latency_min_us,
+            route_statistics.latency_mean_us,
+            route_statistics.latency_max_us);
+    }
+}
+
+}  // namespace eerie_leap::subsys::canbus
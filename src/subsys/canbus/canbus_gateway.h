@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/drivers/can.h>
+
+#include "canbus.h"
+
+namespace eerie_leap::subsys::canbus {
+
+using CanbusProvider = std::function<std::shared_ptr<Canbus> (uint8_t bus_channel)>;
+
+struct CanbusGatewayRoute {
+    uint8_t source_bus_channel = 0;
+    uint32_t source_id = 0;
+    uint32_t source_mask = CAN_STD_ID_MASK;
+    bool is_extended_id = false;
+
+    uint8_t destination_bus_channel = 0;
+    // NOTE: Replaces the source_mask bits of the frame ID, so an exact
+    // route maps one ID and a masked route shifts a whole ID range.
+    // Frame ID is kept when not set.
+    std::optional<uint32_t> destination_id;
+
+    // Frames arriving sooner than this after the last forwarded one are dropped
+    uint32_t min_interval_ms = 0;
+};
+
+struct CanbusGatewayRouteStatistics {
+    CanbusGatewayRoute route;
+    uint32_t forwarded_count;
+    uint32_t dropped_count;
+    uint32_t rate_limited_count;
+    uint32_t latency_min_us;
+    uint32_t latency_mean_us;
+    uint32_t latency_max_us;
+};
+
+// Forwards frames between CAN channels.
+// Each route owns a raw RX filter on its source channel and is handled in
+// that channel's bottom half thread, frames go straight to the destination
+// TX queue without CanFrame conversion or the sensor pipeline.
+// Latency is measured from the RX callback to the frame being queued for TX.
+class CanbusGateway {
+private:
+    struct RouteState {
+        CanbusGatewayRoute route;
+        std::shared_ptr<Canbus> source;
+        std::shared_ptr<Canbus> destination;
+        int filter_id = -1;
+
+        k_spinlock lock;
+        uint32_t forwarded_count = 0;
+        uint32_t dropped_count = 0;
+        uint32_t rate_limited_count = 0;
+        uint32_t latency_min_us = UINT32_MAX;
+        uint32_t latency_max_us = 0;
+        uint64_t latency_sum_us = 0;
+        uint32_t overflow_count_base = 0;
+        uint32_t last_forwarded_ms = 0;
+        bool has_forwarded = false;
+    };
+
+    CanbusProvider canbus_provider_;
+    std::vector<std::unique_ptr<RouteState>> routes_;
+
+    static void ForwardFrame(RouteState& route_state, const can_frame& frame, uint32_t rx_cycles);
+    static bool IsRouteValid(const CanbusGatewayRoute& route);
+
+public:
+    explicit CanbusGateway(CanbusProvider canbus_provider);
+    ~CanbusGateway();
+
+    bool Start(std::span<const CanbusGatewayRoute> routes);
+    void Stop();
+    bool IsRunning() const { return !routes_.empty(); }
+
+    std::vector<CanbusGatewayRouteStatistics> GetStatistics();
+    void ResetStatistics();
+    void PrintStatistics();
+};
+
+}  // namespace eerie_leap::subsys::canbus
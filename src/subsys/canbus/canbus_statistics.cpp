@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <bit>
+
+#include "canbus_statistics.h"
+
+namespace eerie_leap::subsys::canbus {
+
+CanbusStatistics::CanbusStatistics(uint32_t bitrate, uint32_t data_bitrate, uint32_t window_ms)
+    : window_ms_(std::max<uint32_t>(window_ms, LOAD_SLOT_COUNT)),
+    slot_ms_(window_ms_ / LOAD_SLOT_COUNT),
+    bitrate_(bitrate),
+    data_bitrate_(data_bitrate == 0 ? bitrate : data_bitrate) {}
+
+void CanbusStatistics::SetBitrates(uint32_t bitrate, uint32_t data_bitrate) {
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+
+    bitrate_ = bitrate;
+    data_bitrate_ = data_bitrate == 0 ? bitrate : data_bitrate;
+
+    k_spin_unlock(&lock_, key);
+}
+
+void CanbusStatistics::Reset() {
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+
+    ids_.fill({});
+    load_slots_.fill({});
+    untracked_frame_counts_ = {};
+    untracked_windows_ = {UINT32_MAX, UINT32_MAX};
+
+    k_spin_unlock(&lock_, key);
+}
+
+CanbusStatistics::IdEntry* CanbusStatistics::FindOrInsert(uint32_t key) {
+    // Fibonacci hashing, linear probing
+    uint32_t index = (key * 2654435769U) >> (32 - std::countr_zero(static_cast<uint32_t>(MAX_TRACKED_IDS)));
+
+    for(int i = 0; i < MAX_TRACKED_IDS; ++i) {
+        auto& entry = ids_[(index + i) & (MAX_TRACKED_IDS - 1)];
+
+        if(entry.key == key)
+            return &entry;
+
+        if(entry.key == EMPTY_KEY) {
+            entry.key = key;
+            return &entry;
+        }
+    }
+
+    return nullptr;
+}
+
+CanbusStatistics::WindowCounters& CanbusStatistics::GetCounters(IdEntry& entry, uint32_t window) {
+    auto& counters = entry.windows[window & 1];
+    if(counters.window != window) {
+        counters = {};
+        counters.window = window;
+    }
+
+    return counters;
+}
+
+CanbusStatistics::LoadSlot& CanbusStatistics::GetLoadSlot(
+    std::array<LoadSlot, LOAD_SLOT_COUNT>& slots, uint32_t slot) {
+
+    auto& load_slot = slots[slot % LOAD_SLOT_COUNT];
+    if(load_slot.slot != slot) {
+        load_slot = {};
+        load_slot.slot = slot;
+    }
+
+    return load_slot;
+}
+
+// Frame length in bits including worst case bit stuffing.
+// For CAN FD frames with BRS, data_phase_bits holds the part of the frame
+// transmitted at the data bitrate (ESI up to CRC delimiter).
+uint32_t CanbusStatistics::CalculateFrameBits(
+    uint32_t flags,
+    uint8_t data_length,
+    uint32_t& data_phase_bits) {
+
+    bool is_extended_id = (flags & CAN_FRAME_IDE) != 0;
+    uint32_t data_bits = 8 * data_length;
+
+    if((flags & CAN_FRAME_FDF) == 0) {
+        data_phase_bits = 0;
+
+        if(flags & CAN_FRAME_RTR)
+            data_bits = 0;
+
+        // SOF..CRC is subject to stuffing, then CRC delimiter, ACK, EOF and IFS
+        uint32_t stuffed_bits = (is_extended_id ? 54 : 34) + data_bits;
+        return stuffed_bits + (stuffed_bits - 1) / 4 + 13;
+    }
+
+    // SOF, ID, (SRR, IDE, ID ext), RRS, IDE/FDF, res, BRS
+    uint32_t arbitration_bits = is_extended_id ? 36 : 17;
+    // ESI, DLC, data, stuff count with fixed stuff bits, CRC with fixed stuff bits, CRC delimiter
+    uint32_t crc_bits = data_length > 16 ? 21 : 17;
+    uint32_t data_field_bits = 1 + 4 + data_bits;
+    uint32_t dynamic_stuff_bits = (arbitration_bits + data_field_bits - 1) / 4;
+    uint32_t arbitration_stuff_bits = (arbitration_bits - 1) / 4;
+    uint32_t crc_field_bits = 4 + crc_bits + (4 + crc_bits + 3) / 4 + 1;
+
+    uint32_t nominal_bits = arbitration_bits + arbitration_stuff_bits + 12;
+    uint32_t data_rate_bits = data_field_bits + (dynamic_stuff_bits - arbitration_stuff_bits) + crc_field_bits;
+
+    data_phase_bits = (flags & CAN_FRAME_BRS) != 0 ? data_rate_bits : 0;
+
+    return nominal_bits + data_rate_bits;
+}
+
+uint32_t CanbusStatistics::CalculateFrameTimeNs(uint32_t flags, uint8_t data_length) const {
+    if(bitrate_ == 0)
+        return 0;
+
+    uint32_t data_phase_bits = 0;
+    uint32_t total_bits = CalculateFrameBits(flags, data_length, data_phase_bits);
+    uint32_t nominal_bits = total_bits - data_phase_bits;
+
+    return static_cast<uint32_t>(
+        static_cast<uint64_t>(nominal_bits) * 1000000000ULL / bitrate_
+        + static_cast<uint64_t>(data_phase_bits) * 1000000000ULL / data_bitrate_);
+}
+
+void CanbusStatistics::RecordFrame(const can_frame& frame) {
+    uint32_t now_cycles = k_cycle_get_32();
+    uint32_t now_ms = static_cast<uint32_t>(k_uptime_get());
+    uint32_t window = now_ms / window_ms_;
+    uint32_t slot = now_ms / slot_ms_;
+
+    uint8_t data_length = can_dlc_to_bytes(frame.dlc);
+    uint32_t key = (frame.flags & CAN_FRAME_IDE) ? (frame.id | EXTENDED_ID_FLAG) : frame.id;
+
+    k_spinlock_key_t lock_key = k_spin_lock(&lock_);
+
+    uint32_t frame_time_ns = CalculateFrameTimeNs(frame.flags, data_length);
+
+    auto& load_slot = GetLoadSlot(load_slots_, slot);
+    load_slot.busy_ns += frame_time_ns;
+    load_slot.frame_count++;
+    load_slot.byte_count += data_length;
+
+    IdEntry* entry = FindOrInsert(key);
+    if(entry == nullptr) {
+        if(untracked_windows_[window & 1] != window) {
+            untracked_windows_[window & 1] = window;
+            untracked_frame_counts_[window & 1] = 0;
+        }
+        untracked_frame_counts_[window & 1]++;
+
+        k_spin_unlock(&lock_, lock_key);
+        return;
+    }
+
+    auto& counters = GetCounters(*entry, window);
+    counters.frame_count++;
+    counters.byte_count += data_length;
+    counters.busy_ns += frame_time_ns;
+
+    // First frame of an ID has no previous arrival
+    if(entry->has_last_arrival) {
+        uint32_t inter_arrival_us = k_cyc_to_us_floor32(now_cycles - entry->last_arrival_cycles);
+
+        counters.inter_arrival_min_us = std::min(counters.inter_arrival_min_us, inter_arrival_us);
+        counters.inter_arrival_max_us = std::max(counters.inter_arrival_max_us, inter_arrival_us);
+        counters.inter_arrival_sum_us += inter_arrival_us;
+        counters.inter_arrival_count++;
+    }
+    entry->last_arrival_cycles = now_cycles;
+    entry->has_last_arrival = true;
+
+    k_spin_unlock(&lock_, lock_key);
+}
+
+CanbusStatisticsReport CanbusStatistics::GetReport(size_t top_n) {
+    CanbusStatisticsReport report = {
+        .window_ms = window_ms_
+    };
+    report.top_ids.reserve(MAX_TRACKED_IDS);
+
+    uint32_t now_ms = static_cast<uint32_t>(k_uptime_get());
+    uint32_t previous_window = now_ms / window_ms_ - 1;
+    uint32_t current_slot = now_ms / slot_ms_;
+
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+
+    uint64_t busy_ns = 0;
+    uint64_t peak_slot_busy_ns = 0;
+    for(const auto& load_slot : load_slots_) {
+        // Sliding over the last complete sub-windows
+        if(load_slot.slot >= current_slot || current_slot - load_slot.slot > LOAD_SLOT_COUNT)
+            continue;
+
+        busy_ns += load_slot.busy_ns;
+        peak_slot_busy_ns = std::max(peak_slot_busy_ns, load_slot.busy_ns);
+        report.frame_count += load_slot.frame_count;
+        report.byte_count += load_slot.byte_count;
+    }
+
+    for(const auto& entry : ids_) {
+        if(entry.key == EMPTY_KEY)
+            continue;
+
+        const auto& counters = entry.windows[previous_window & 1];
+        if(counters.window != previous_window || counters.frame_count == 0)
+            continue;
+
+        report.top_ids.push_back({
+            .id = entry.key & ~EXTENDED_ID_FLAG,
+            .is_extended_id = (entry.key & EXTENDED_ID_FLAG) != 0,
+            .frame_count = counters.frame_count,
+            .byte_count = counters.byte_count,
+            .inter_arrival_min_us = counters.inter_arrival_count > 0 ? counters.inter_arrival_min_us : 0,
+            .inter_arrival_mean_us = counters.inter_arrival_count > 0
+                ? counters.inter_arrival_sum_us / counters.inter_arrival_count
+                : 0,
+            .inter_arrival_max_us = counters.inter_arrival_max_us,
+            .bus_load_percent = static_cast<float>(counters.busy_ns) / (window_ms_ * 10000.0f)
+        });
+    }
+
+    if(untracked_windows_[previous_window & 1] == previous_window)
+        report.untracked_frame_count = untracked_frame_counts_[previous_window & 1];
+
+    k_spin_unlock(&lock_, key);
+
+    report.bus_load_percent = static_cast<float>(busy_ns) / (slot_ms_ * LOAD_SLOT_COUNT * 10000.0f);
+    report.peak_bus_load_percent = static_cast<float>(peak_slot_busy_ns) / (slot_ms_ * 10000.0f);
+
+    top_n = std::min(top_n, report.top_ids.size());
+    std::partial_sort(
+        report.top_ids.begin(),
+        report.top_ids.begin() + top_n,
+        report.top_ids.end(),
+        [](const CanbusIdStatistics& a, const CanbusIdStatistics& b) {
+            return a.bus_load_percent > b.bus_load_percent; });
+    report.top_ids.resize(top_n);
+
+    return report;
+}
+
+}  // namespace eerie_leap::subsys::canbus
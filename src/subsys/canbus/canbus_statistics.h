@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <vector>
+
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/drivers/can.h>
+
+namespace eerie_leap::subsys::canbus {
+
+struct CanbusIdStatistics {
+    uint32_t id;
+    bool is_extended_id;
+    uint32_t frame_count;
+    uint32_t byte_count;
+    uint32_t inter_arrival_min_us;
+    uint32_t inter_arrival_mean_us;
+    uint32_t inter_arrival_max_us;
+    float bus_load_percent;
+};
+
+struct CanbusStatisticsReport {
+    uint32_t window_ms;
+    uint32_t frame_count;
+    uint32_t byte_count;
+    uint32_t untracked_frame_count;
+    float bus_load_percent;
+    float peak_bus_load_percent;
+    std::vector<CanbusIdStatistics> top_ids;
+};
+
+// Bus load and per-ID rate statistics.
+// RecordFrame is ISR safe and O(1): counters are kept per window parity
+// and reset lazily on first use in a new window, so there is no periodic
+// rollover work. Per-ID figures are reported for the last complete window,
+// bus load is a sliding sum over LOAD_SLOT_COUNT sub-windows.
+class CanbusStatistics {
+private:
+    static constexpr int MAX_TRACKED_IDS = CONFIG_EERIE_LEAP_CANBUS_STATISTICS_MAX_IDS;
+    static constexpr int LOAD_SLOT_COUNT = 10;
+    static constexpr uint32_t EXTENDED_ID_FLAG = 1U << 31;
+    static constexpr uint32_t EMPTY_KEY = UINT32_MAX;
+
+    static_assert((MAX_TRACKED_IDS & (MAX_TRACKED_IDS - 1)) == 0,
+        "CONFIG_EERIE_LEAP_CANBUS_STATISTICS_MAX_IDS must be a power of two");
+    // Hash index takes log2(MAX_TRACKED_IDS) top bits, shifting by 32 otherwise
+    static_assert(MAX_TRACKED_IDS >= 2,
+        "CONFIG_EERIE_LEAP_CANBUS_STATISTICS_MAX_IDS must be at least 2");
+
+    struct WindowCounters {
+        uint32_t window = UINT32_MAX;
+        uint32_t frame_count = 0;
+        uint32_t byte_count = 0;
+        uint64_t busy_ns = 0;
+        uint32_t inter_arrival_min_us = UINT32_MAX;
+        uint32_t inter_arrival_max_us = 0;
+        uint32_t inter_arrival_sum_us = 0;
+        uint32_t inter_arrival_count = 0;
+    };
+
+    struct IdEntry {
+        uint32_t key = EMPTY_KEY;
+        uint32_t last_arrival_cycles = 0;
+        bool has_last_arrival = false;
+        std::array<WindowCounters, 2> windows;
+    };
+
+    struct LoadSlot {
+        uint32_t slot = UINT32_MAX;
+        uint64_t busy_ns = 0;
+        uint32_t frame_count = 0;
+        uint32_t byte_count = 0;
+    };
+
+    k_spinlock lock_;
+
+    uint32_t window_ms_;
+    uint32_t slot_ms_;
+    uint32_t bitrate_;
+    uint32_t data_bitrate_;
+
+    std::array<IdEntry, MAX_TRACKED_IDS> ids_;
+    std::array<LoadSlot, LOAD_SLOT_COUNT> load_slots_;
+    std::array<uint32_t, 2> untracked_frame_counts_ = {};
+    std::array<uint32_t, 2> untracked_windows_ = {UINT32_MAX, UINT32_MAX};
+
+    IdEntry* FindOrInsert(uint32_t key);
+    static WindowCounters& GetCounters(IdEntry& entry, uint32_t window);
+    static LoadSlot& GetLoadSlot(std::array<LoadSlot, LOAD_SLOT_COUNT>& slots, uint32_t slot);
+
+    uint32_t CalculateFrameTimeNs(uint32_t flags, uint8_t data_length) const;
+
+public:
+    CanbusStatistics(uint32_t bitrate, uint32_t data_bitrate, uint32_t window_ms);
+
+    void SetBitrates(uint32_t bitrate, uint32_t data_bitrate);
+    void Reset();
+
+    void RecordFrame(const can_frame& frame);
+
+    CanbusStatisticsReport GetReport(size_t top_n);
+
+    static uint32_t CalculateFrameBits(
+        uint32_t flags,
+        uint8_t data_length,
+        uint32_t& data_phase_bits);
+};
+
+}  // namespace eerie_leap::subsys::canbus
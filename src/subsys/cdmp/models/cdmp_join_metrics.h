@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+#include "subsys/cdmp/utilities/enums.h"
+
+namespace eerie_leap::subsys::cdmp::models {
+
+using namespace eerie_leap::subsys::cdmp::utilities;
+
+struct CdmpJoinMetrics {
+    CdmpJoinMode mode = CdmpJoinMode::SEQUENTIAL;
+    bool is_completed = false;
+    // Fast join fell back to sequential join due to concurrent joiners
+    bool is_fallback = false;
+
+    uint32_t discovery_time_ms = 0;
+    uint32_t claim_time_ms = 0;
+    uint32_t total_time_ms = 0;
+
+    uint8_t passive_device_count = 0;
+    uint8_t discovery_response_count = 0;
+    uint8_t claim_attempt_count = 0;
+};
+
+} // namespace eerie_leap::subsys::cdmp::models
@@ -54,6 +54,7 @@ void CdmpHeartbeatService::RegisterCanHandlers() {
     canbus_handler_id_ = canbus_->RegisterFrameReceivedHandler(
         can_id_manager_->GetHeartbeatCanId(),
         [this](const CanFrame& frame) {
+            network_service_->ObserveHeartbeatFrame(frame.data);
             work_queue_thread_->Run([this, frame]() { ProcessFrame(frame.data); }); });
 
     if(canbus_handler_id_ < 0) {
@@ -1,7 +1,8 @@
+#include <algorithm>
+
 #include <zephyr/logging/log.h>
 
 #include "subsys/cdmp/utilities/cdmp_status_machine.h"
-#include "subsys/cdmp/utilities/cdmp_helpers.h"
 
 #include "cdmp_network_service.h"
 
@@ -15,7 +16,8 @@ CdmpNetworkService::CdmpNetworkService(
     std::shared_ptr<CdmpDevice> device,
     std::shared_ptr<WorkQueueThread> work_queue_thread)
         : CdmpCanbusServiceBase(std::move(canbus), std::move(can_id_manager), std::move(device)),
-        work_queue_thread_(std::move(work_queue_thread)) {}
+        work_queue_thread_(std::move(work_queue_thread)),
+        join_observer_(device_->GetUniqueIdentifier()) {}
 
 CdmpNetworkService::~CdmpNetworkService() {
     Stop();
@@ -39,6 +41,7 @@ void CdmpNetworkService::Stop() {
         validation_task_.value().Cancel();
 
     ClearAllDevices();
+    join_observer_.Reset();
     UnregisterCanHandlers();
 
     LOG_INF("CDMP Network Service stopped");
@@ -55,6 +58,7 @@ void CdmpNetworkService::RegisterCanHandlers() {
     canbus_handler_id_ = canbus_->RegisterFrameReceivedHandler(
         can_id_manager_->GetManagementCanId(),
         [this](const CanFrame& frame) {
+            join_observer_.ObserveManagementFrame(frame.data);
             work_queue_thread_->Run([this, frame]() { ProcessFrame(frame.data); }); });
 
     if(canbus_handler_id_ < 0) {
@@ -75,15 +79,23 @@ void CdmpNetworkService::UnregisterCanHandlers() {
 void CdmpNetworkService::OnDeviceStatusChanged(CdmpDeviceStatus old_status, CdmpDeviceStatus new_status) {
     switch(new_status) {
         case CdmpDeviceStatus::INIT:
-            work_queue_thread_->Run([this]() { StartInitialization(); });
+            BeginJoinMetrics(join_mode_);
+            if(join_mode_ == CdmpJoinMode::FAST)
+                work_queue_thread_->Run([this]() { StartFastInitialization(); });
+            else
+                work_queue_thread_->Run([this]() { StartInitialization(); });
             break;
 
         case CdmpDeviceStatus::CLAIMING:
-            work_queue_thread_->Run([this]() { SendIdClaim(); });
+            if(join_metrics_.mode == CdmpJoinMode::FAST && !join_metrics_.is_fallback)
+                work_queue_thread_->Run([this]() { SendFastIdClaim(); });
+            else
+                work_queue_thread_->Run([this]() { SendIdClaim(); });
             break;
 
         case CdmpDeviceStatus::ONLINE:
             LOG_INF("Device %d is now online", device_->GetDeviceId());
+            CompleteJoinMetrics();
             StartValidationTask();
             break;
 
@@ -153,6 +165,58 @@ void CdmpNetworkService::StartInitialization() {
         }
     }
 
+    join_metrics_.discovery_time_ms = k_uptime_get() - join_started_at_;
+    join_metrics_.discovery_response_count = join_observer_.GetRespondedCount();
+    claim_started_at_ = k_uptime_get();
+
+    device_->ClaimId();
+}
+
+void CdmpNetworkService::StartFastInitialization() {
+    if(device_->GetStatus() != CdmpDeviceStatus::INIT)
+        return;
+
+    join_metrics_.passive_device_count = join_observer_.GetOccupiedCount();
+    join_observer_.ResetDiscovery();
+
+    SendDiscoveryRequest();
+    LOG_INF("Sending fast join discovery request, %d devices known", join_metrics_.passive_device_count);
+
+    // Wait for the staggered responses to settle rather than a full backoff,
+    // all devices seen heartbeating having answered means the network is stable
+    int64_t deadline = k_uptime_get() + CdmpConstants::FAST_JOIN_DISCOVERY_WINDOW_MS;
+    int64_t wait_ms = CdmpConstants::FAST_JOIN_DISCOVERY_WINDOW_MS;
+    while(device_->GetStatus() == CdmpDeviceStatus::INIT) {
+        int64_t remaining_ms = deadline - k_uptime_get();
+        if(remaining_ms <= 0)
+            break;
+
+        if(join_observer_.WaitForDiscoveryResponse(K_MSEC(std::min(remaining_ms, wait_ms)))) {
+            wait_ms = CdmpConstants::FAST_JOIN_SETTLE_MS;
+            continue;
+        }
+
+        if(join_observer_.HaveAllKnownDevicesResponded())
+            break;
+
+        wait_ms = remaining_ms;
+    }
+
+    if(device_->GetStatus() != CdmpDeviceStatus::INIT)
+        return;
+
+    join_metrics_.discovery_time_ms = k_uptime_get() - join_started_at_;
+    join_metrics_.discovery_response_count = join_observer_.GetRespondedCount();
+
+    if(join_observer_.GetDiscoveryRequestCount() > 0) {
+        LOG_INF("Concurrent join detected, falling back to sequential join");
+        join_metrics_.is_fallback = true;
+        StartInitialization();
+
+        return;
+    }
+
+    claim_started_at_ = k_uptime_get();
     device_->ClaimId();
 }
 
@@ -242,6 +306,7 @@ void CdmpNetworkService::SendIdClaim() {
         auto frame_data = message.ToCanFrame();
         uint32_t frame_id = can_id_manager_->GetIdClaimRequestCanId();
         canbus_->SendFrame(frame_id, frame_data);
+        join_metrics_.claim_attempt_count++;
         LOG_INF("Sent ID claim for device %d", message.claiming_device_id);
 
         k_msleep(CdmpConstants::ID_CLAIM_RESPONSE_TIMEOUT_MS);
@@ -272,6 +337,62 @@ void CdmpNetworkService::SendIdClaim() {
     claiming_device_id_ = 0;
 }
 
+void CdmpNetworkService::SendFastIdClaim() {
+    uint8_t claiming_device_id = 0;
+
+    for(int i = 0; i < CdmpConstants::ID_CLAIM_MAX_ATTEMPTS; ++i) {
+        if(device_->GetStatus() != CdmpDeviceStatus::CLAIMING)
+            return;
+
+        try {
+            claiming_device_id = GetLowestAvailableId(claiming_device_id);
+        } catch (const std::exception& e) {
+            LOG_ERR("Error getting lowest available ID: %s", e.what());
+            device_->EnterError();
+
+            return;
+        }
+
+        CdmpIdClaimRequestMessage message = {};
+        message.claiming_device_id = claiming_device_id;
+        message.uid = device_->GetUniqueIdentifier();
+        message.device_type = device_->GetDeviceType();
+        message.protocol_version = device_->GetProtocolVersion();
+
+        join_observer_.BeginClaim(claiming_device_id);
+
+        auto frame_data = message.ToCanFrame();
+        uint32_t frame_id = can_id_manager_->GetIdClaimRequestCanId();
+        canbus_->SendFrame(frame_id, frame_data);
+        join_metrics_.claim_attempt_count++;
+        LOG_INF("Sent fast ID claim for device %d", claiming_device_id);
+
+        auto result = join_observer_.WaitForClaimResult(
+            K_MSEC(CdmpConstants::ID_CLAIM_RESPONSE_TIMEOUT_MS),
+            K_MSEC(CdmpConstants::FAST_JOIN_SETTLE_MS));
+
+        // First or only device on the network, assign the ID
+        if(!result.has_value() || result.value() == CdmpIdClaimResult::ACCEPT) {
+            device_->SetDeviceId(claiming_device_id);
+            UpdateNetworkDevices();
+            device_->GoOnline();
+
+            return;
+        }
+
+        if(result.value() == CdmpIdClaimResult::VERSION_INCOMPATIBLE) {
+            device_->EnterVersionMismatch();
+            return;
+        }
+
+        // Rejected, the ID is taken by a device not seen yet, try the next one
+        join_observer_.SetOccupied(claiming_device_id);
+    }
+
+    LOG_ERR("All ID claims were rejected.");
+    device_->EnterError();
+}
+
 void CdmpNetworkService::ProcessIdClaimRequestFrame(std::span<const uint8_t> frame_data) {
     try {
         if(!device_->IsOnline())
@@ -341,89 +462,64 @@ void CdmpNetworkService::UpdateDeviceFromDiscovery(const CdmpDiscoveryResponseMe
 }
 
 void CdmpNetworkService::UpdateDeviceFromHeartbeat(const CdmpHeartbeatMessage& heartbeat) {
-    uint8_t device_id = heartbeat.device_id;
+    bool is_known = device_table_.UpdateFromHeartbeat(
+        heartbeat.device_id,
+        heartbeat.health_status,
+        heartbeat.sequence_number,
+        heartbeat.capability_flags,
+        k_uptime_get());
 
-    if(!network_devices_.contains(device_id)) {
-        LOG_DBG("Heartbeat from unknown device %d", device_id);
-        return;
-    }
+    if(!is_known)
+        LOG_DBG("Heartbeat from unknown device %d", heartbeat.device_id);
+}
 
-    AddOrUpdateDevice(
-        heartbeat.device_id,
-        network_devices_.at(device_id)->GetDeviceType(),
-        network_devices_.at(device_id)->GetUniqueIdentifier(),
-        heartbeat.capability_flags);
+void CdmpNetworkService::ObserveHeartbeatFrame(std::span<const uint8_t> frame_data) {
+    join_observer_.ObserveHeartbeatFrame(frame_data);
 }
 
 void CdmpNetworkService::AddOrUpdateDevice(
     uint8_t device_id,
     CdmpDeviceType device_type,
-    uint32_t uid,
-    uint32_t capability_flags) {
-
-    if(network_devices_.contains(device_id)) {
-        auto* device = network_devices_.at(device_id).get();
-
-        device->UpdateHeartbeat();
-        device->GoOnline(true);
-        if(capability_flags != 0)
-            device->SetCapabilityFlags(capability_flags);
+    uint32_t uid) {
 
+    if(!device_table_.AddOrUpdate(device_id, uid, device_type, k_uptime_get())) {
         LOG_DBG("Updated device %d.", device_id);
-    } else {
-        auto device = std::make_unique<CdmpDevice>(uid, device_type, CdmpDeviceStatus::ONLINE);
-        device->SetDeviceId(device_id);
-        if(capability_flags != 0)
-            device->SetCapabilityFlags(capability_flags);
+        return;
+    }
 
-        network_devices_.emplace(device_id, std::move(device));
-        UpdateNetworkDevices();
+    UpdateNetworkDevices();
 
-        LOG_INF("Added new device: ID=%d, Type=%d, UID=0x%08X", device_id, std::to_underlying(device_type), uid);
-    }
+    LOG_INF("Added new device: ID=%d, Type=%d, UID=0x%08X", device_id, std::to_underlying(device_type), uid);
 }
 
 void CdmpNetworkService::RemoveDevice(uint8_t device_id) {
-    if(network_devices_.contains(device_id)) {
-        network_devices_.erase(device_id);
+    if(device_table_.Remove(device_id)) {
+        UpdateNetworkDevices();
         LOG_INF("Removed device %d", device_id);
     }
 }
 
 void CdmpNetworkService::ClearAllDevices() {
-    network_devices_.clear();
+    device_table_.Clear();
     LOG_INF("Cleared all network devices");
 }
 
+// NOTE: Devices are dropped from the table on heartbeat timeout,
+// so every device present in the table is online
 std::vector<uint8_t> CdmpNetworkService::GetOnlineDeviceIds() const {
-    std::vector<uint8_t> online_devices;
-    for(const auto& [device_id, device] : network_devices_) {
-        if(device->GetStatus() == CdmpDeviceStatus::ONLINE)
-            online_devices.push_back(device_id);
-    }
-    return online_devices;
+    return device_table_.GetDeviceIds();
 }
 
 std::vector<uint8_t> CdmpNetworkService::GetAllDeviceIds() const {
-    std::vector<uint8_t> all_devices;
-    for(const auto& [device_id, device] : network_devices_)
-        all_devices.push_back(device_id);
-
-    return all_devices;
+    return device_table_.GetDeviceIds();
 }
 
-const CdmpDevice* CdmpNetworkService::GetDevice(uint8_t device_id) const {
-    if(!network_devices_.contains(device_id))
-        return nullptr;
-
-    return network_devices_.at(device_id).get();
+const CdmpDeviceTableEntry* CdmpNetworkService::GetDevice(uint8_t device_id) const {
+    return device_table_.Get(device_id);
 }
 
-CdmpDevice* CdmpNetworkService::GetDevice(uint8_t device_id) {
-    if(!network_devices_.contains(device_id))
-        return nullptr;
-
-    return network_devices_.at(device_id).get();
+const CdmpDeviceTable::DeviceIdSet& CdmpNetworkService::GetDevicesWithCapability(uint8_t capability_bit) const {
+    return device_table_.GetDevicesWithCapability(capability_bit);
 }
 
 void CdmpNetworkService::SetAutoDiscovery(bool enabled) {
@@ -431,6 +527,38 @@ void CdmpNetworkService::SetAutoDiscovery(bool enabled) {
     LOG_INF("Auto discovery %s", enabled ? "enabled" : "disabled");
 }
 
+void CdmpNetworkService::SetJoinMode(CdmpJoinMode join_mode) {
+    join_mode_ = join_mode;
+    LOG_INF("Join mode set to %s", join_mode == CdmpJoinMode::FAST ? "fast" : "sequential");
+}
+
+void CdmpNetworkService::BeginJoinMetrics(CdmpJoinMode mode) {
+    join_metrics_ = {};
+    join_metrics_.mode = mode;
+    join_started_at_ = k_uptime_get();
+    claim_started_at_ = 0;
+}
+
+void CdmpNetworkService::CompleteJoinMetrics() {
+    if(join_started_at_ == 0)
+        return;
+
+    int64_t now = k_uptime_get();
+    if(claim_started_at_ != 0)
+        join_metrics_.claim_time_ms = now - claim_started_at_;
+    join_metrics_.total_time_ms = now - join_started_at_;
+    join_metrics_.is_completed = true;
+
+    join_started_at_ = 0;
+    claim_started_at_ = 0;
+
+    LOG_INF("Joined network as device %d in %u ms (discovery: %u ms, claim: %u ms)",
+        device_->GetDeviceId(),
+        join_metrics_.total_time_ms,
+        join_metrics_.discovery_time_ms,
+        join_metrics_.claim_time_ms);
+}
+
 WorkQueueTaskResult CdmpNetworkService::ProcessPeriodicValidation(CdmpNetworkService* instance) {
     if(!instance->is_validation_task_running_) {
         return {
@@ -438,29 +566,37 @@ WorkQueueTaskResult CdmpNetworkService::ProcessPeriodicValidation(CdmpNetworkSer
         };
     }
 
-    instance->RemoveOfflineDevices();
-    instance->UpdateNetworkDevices();
+    if(instance->RemoveOfflineDevices())
+        instance->UpdateNetworkDevices();
+
+    // Wake up when the least recently heard device is due to expire
+    int64_t delay_ms = CdmpConstants::NETWORK_VALIDATION_INTERVAL_MS;
+    auto next_deadline = instance->device_table_.GetNextDeadline(CdmpConstants::HEARTBEAT_TIMEOUT_MS);
+    if(next_deadline.has_value())
+        delay_ms = std::clamp<int64_t>(
+            next_deadline.value() - k_uptime_get() + 1,
+            CdmpConstants::STAGGERED_MESSAGE_TIME_OFFSET_MS,
+            CdmpConstants::NETWORK_VALIDATION_INTERVAL_MS);
 
     return {
         .reschedule = instance->is_validation_task_running_,
-        .delay = K_MSEC(CdmpConstants::NETWORK_VALIDATION_INTERVAL_MS)
+        .delay = K_MSEC(delay_ms)
     };
 }
 
 bool CdmpNetworkService::IsDeviceOnline(uint8_t device_id) const {
-    const auto* device = GetDevice(device_id);
-    return device && device->GetStatus() == CdmpDeviceStatus::ONLINE;
+    return device_table_.Contains(device_id);
 }
 
-void CdmpNetworkService::RemoveOfflineDevices() {
-    std::vector<uint8_t> offline_devices;
-    for(const auto& [device_id, device] : network_devices_) {
-        if(device->GetLastHeartbeatDeltaMs() > CdmpConstants::HEARTBEAT_TIMEOUT_MS)
-            offline_devices.push_back(device_id);
-    }
+bool CdmpNetworkService::RemoveOfflineDevices() {
+    int removed_count = device_table_.RemoveExpired(
+        k_uptime_get(),
+        CdmpConstants::HEARTBEAT_TIMEOUT_MS,
+        [](uint8_t device_id, const CdmpDeviceTableEntry&) {
+            LOG_INF("Removed device %d, heartbeat timeout", device_id);
+        });
 
-    for(auto device_id : offline_devices)
-        RemoveDevice(device_id);
+    return removed_count > 0;
 }
 
 void CdmpNetworkService::UpdateNetworkDevices() {
@@ -469,34 +605,23 @@ void CdmpNetworkService::UpdateNetworkDevices() {
 }
 
 void CdmpNetworkService::UpdateLowestIdOnNetwork() {
-    uint8_t lowest_id_on_network = device_->GetDeviceId();
-    for(const auto& [id, _] : network_devices_) {
-        if(id < lowest_id_on_network)
-            lowest_id_on_network = std::min(lowest_id_on_network, id);
-    }
+    uint8_t lowest_id_on_network = device_table_.GetLowestDeviceId();
 
-    device_->SetIsLowestIdOnNetwork(device_->GetDeviceId() == lowest_id_on_network);
-    for(const auto& [id, device] : network_devices_)
-        device->SetIsLowestIdOnNetwork(id == lowest_id_on_network);
+    device_->SetIsLowestIdOnNetwork(
+        lowest_id_on_network == CdmpDevice::DEVICE_ID_UNASSIGNED
+        || device_->GetDeviceId() < lowest_id_on_network);
 }
 
 void CdmpNetworkService::UpdateStaggeredMessageDelay() {
-    uint8_t lowest_id_on_network = device_->GetDeviceId();
-    for(const auto& [id, _] : network_devices_) {
-        if(id < lowest_id_on_network)
-            lowest_id_on_network = std::min(lowest_id_on_network, id);
-    }
-
-    device_->SetStaggeredMessageDelay(CdmpHelpers::CalculateStaggeredMessageTimeOffset(
-        GetAllDeviceIds(), device_->GetDeviceId()));
-    for(const auto& [id, device] : network_devices_)
-        device->SetStaggeredMessageDelay(CdmpHelpers::CalculateStaggeredMessageTimeOffset(
-            GetAllDeviceIds(), id));
+    // Same as CdmpHelpers::CalculateStaggeredMessageTimeOffset, rank is taken from the ID bitmap
+    device_->SetStaggeredMessageDelay(
+        device_table_.CountDevicesBelow(device_->GetDeviceId())
+        * CdmpConstants::STAGGERED_MESSAGE_TIME_OFFSET_MS);
 }
 
 uint8_t CdmpNetworkService::GetLowestAvailableId(uint8_t after) const {
     for(uint8_t i = after + 1; i < 255; ++i) {
-        if(!network_devices_.contains(i))
+        if(!device_table_.Contains(i) && !join_observer_.IsOccupied(i))
             return i;
     }
 
@@ -504,13 +629,26 @@ uint8_t CdmpNetworkService::GetLowestAvailableId(uint8_t after) const {
 }
 
 void CdmpNetworkService::PrintNetworkStatus() const {
-    LOG_INF("Network Status: %zu devices total", network_devices_.size());
+    LOG_INF("Network Status: %d devices total", device_table_.GetDeviceCount());
 
-    for(const auto& [device_id, device] : network_devices_) {
-        LOG_INF("  Device %d: Type=%d, Status=%d, UID=0x%08X",
-            device_id, std::to_underlying(device->GetDeviceType()),
-            std::to_underlying(device->GetStatus()), device->GetUniqueIdentifier());
+    for(auto device_id : device_table_.GetDeviceIds()) {
+        const auto* device = device_table_.Get(device_id);
+        LOG_INF("  Device %d: Type=%d, Health=%d, UID=0x%08X, Capabilities=0x%08X",
+            device_id, std::to_underlying(device->device_type),
+            std::to_underlying(device->health_status), device->uid, device->capability_flags);
     }
 }
 
+void CdmpNetworkService::PrintJoinMetrics() const {
+    LOG_INF("Join Metrics:");
+    LOG_INF("  Mode: %s%s",
+        join_metrics_.mode == CdmpJoinMode::FAST ? "fast" : "sequential",
+        join_metrics_.is_fallback ? " (fallback)" : "");
+    LOG_INF("  Completed: %s", join_metrics_.is_completed ? "Yes" : "No");
+    LOG_INF("  Total: %u ms", join_metrics_.total_time_ms);
+    LOG_INF("  Discovery: %u ms, %d responses", join_metrics_.discovery_time_ms, join_metrics_.discovery_response_count);
+    LOG_INF("  Claim: %u ms, %d attempts", join_metrics_.claim_time_ms, join_metrics_.claim_attempt_count);
+    LOG_INF("  Passively known devices: %d", join_metrics_.passive_device_count);
+}
+
 } // namespace eerie_leap::subsys::cdmp::services
@@ -1,6 +1,5 @@
 #pragma once
 
-#include <unordered_map>
 #include <vector>
 #include <memory>
 #include <span>
@@ -8,6 +7,10 @@
 
 #include "subsys/threading/work_queue_thread.h"
 
+#include "subsys/cdmp/utilities/cdmp_device_table.h"
+#include "subsys/cdmp/utilities/cdmp_join_observer.h"
+#include "subsys/cdmp/models/cdmp_join_metrics.h"
+
 #include "cdmp_canbus_service_base.h"
 
 
@@ -25,7 +28,7 @@ private:
 
     int canbus_handler_id_ = -1;
 
-    std::unordered_map<uint8_t, std::unique_ptr<CdmpDevice>> network_devices_;
+    CdmpDeviceTable device_table_;
 
     // Discovery and tracking
     bool auto_discovery_enabled_ = true;
@@ -34,6 +37,15 @@ private:
     uint8_t claiming_device_id_ = 0;
     std::optional<CdmpIdClaimResult> id_claim_result_ = std::nullopt;
 
+    // Join
+    CdmpJoinMode join_mode_ = IS_ENABLED(CONFIG_EERIE_LEAP_CDMP_FAST_JOIN)
+        ? CdmpJoinMode::FAST
+        : CdmpJoinMode::SEQUENTIAL;
+    CdmpJoinObserver join_observer_;
+    CdmpJoinMetrics join_metrics_;
+    int64_t join_started_at_ = 0;
+    int64_t claim_started_at_ = 0;
+
     void RegisterCanHandlers();
     void UnregisterCanHandlers();
 
@@ -47,22 +59,25 @@ private:
     void SendDiscoveryResponse();
 
     void SendIdClaim();
+    void SendFastIdClaim();
     void ProcessIdClaimRequestFrame(std::span<const uint8_t> frame_data);
     void ProcessIdClaimResponseFrame(std::span<const uint8_t> frame_data);
 
     void AddOrUpdateDevice(
         uint8_t device_id,
         CdmpDeviceType device_type,
-        uint32_t uid,
-        uint32_t capability_flags = 0);
+        uint32_t uid);
     void UpdateDeviceFromDiscovery(const CdmpDiscoveryResponseMessage& discovery);
 
-    void RemoveOfflineDevices();
+    bool RemoveOfflineDevices();
     void UpdateNetworkDevices();
     void UpdateLowestIdOnNetwork();
     void UpdateStaggeredMessageDelay();
     uint8_t GetLowestAvailableId(uint8_t after = 0) const;
 
+    void BeginJoinMetrics(CdmpJoinMode mode);
+    void CompleteJoinMetrics();
+
 public:
     CdmpNetworkService(
         std::shared_ptr<Canbus> canbus,
@@ -78,6 +93,10 @@ public:
 
     void ProcessFrame(std::span<const uint8_t> frame_data);
     void StartInitialization();
+    void StartFastInitialization();
+
+    // Called from the CAN bottom half, before frames are queued for processing
+    void ObserveHeartbeatFrame(std::span<const uint8_t> frame_data);
 
     // Network device management
     void UpdateDeviceFromHeartbeat(const CdmpHeartbeatMessage& heartbeat);
@@ -87,20 +106,26 @@ public:
     // Device queries
     std::vector<uint8_t> GetOnlineDeviceIds() const;
     std::vector<uint8_t> GetAllDeviceIds() const;
-    size_t GetDeviceCount() const { return network_devices_.size(); }
-    const CdmpDevice* GetDevice(uint8_t device_id) const;
-    CdmpDevice* GetDevice(uint8_t device_id); // Non-const version for modifications
+    size_t GetDeviceCount() const { return device_table_.GetDeviceCount(); }
+    const CdmpDeviceTableEntry* GetDevice(uint8_t device_id) const;
+    const CdmpDeviceTable::DeviceIdSet& GetDevicesWithCapability(uint8_t capability_bit) const;
 
     // Discovery management
     void SetAutoDiscovery(bool enabled);
     bool IsAutoDiscoveryEnabled() const { return auto_discovery_enabled_; }
     void ProcessPeriodicTasks();
 
+    // Join management
+    void SetJoinMode(CdmpJoinMode join_mode);
+    CdmpJoinMode GetJoinMode() const { return join_mode_; }
+    CdmpJoinMetrics GetJoinMetrics() const { return join_metrics_; }
+
     // Network status
     bool IsDeviceOnline(uint8_t device_id) const;
 
     // Diagnostics
     void PrintNetworkStatus() const;
+    void PrintJoinMetrics() const;
 };
 
 } // namespace eerie_leap::subsys::cdmp::services
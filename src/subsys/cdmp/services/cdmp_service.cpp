@@ -35,12 +35,12 @@ CdmpService::CdmpService(
         CONFIG_EERIE_LEAP_CDMP_WORK_QUEUE_STACK_SIZE,
         CONFIG_EERIE_LEAP_CDMP_WORK_QUEUE_PRIORITY);
 
-    auto network_service = std::make_shared<CdmpNetworkService>(
+    network_service_ = std::make_shared<CdmpNetworkService>(
         canbus_, can_id_manager_, device_, work_queue_thread_);
-    canbus_services_.push_back(network_service);
+    canbus_services_.push_back(network_service_);
 
     canbus_services_.emplace_back(std::make_shared<CdmpHeartbeatService>(
-        canbus_, can_id_manager_, device_, work_queue_thread_, network_service));
+        canbus_, can_id_manager_, device_, work_queue_thread_, network_service_));
 
     command_service_ = std::make_shared<CdmpCommandService>(
         canbus_, can_id_manager_, device_, work_queue_thread_);
@@ -108,6 +108,10 @@ void CdmpService::SetAutoDiscovery(bool enabled) {
     auto_discovery_enabled_ = enabled;
 }
 
+void CdmpService::SetJoinMode(CdmpJoinMode join_mode) {
+    network_service_->SetJoinMode(join_mode);
+}
+
 void CdmpService::PrintDeviceStatus() const {
     if(!device_) {
         LOG_INF("Device not initialized");
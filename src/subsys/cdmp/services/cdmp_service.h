@@ -16,7 +16,7 @@
 
 #include "i_cdmp_canbus_service.h"
 #include "cdmp_command_service.h"
-#include "cdmp_service.h"
+#include "cdmp_network_service.h"
 
 namespace eerie_leap::subsys::cdmp::services {
 
@@ -33,6 +33,7 @@ private:
     std::shared_ptr<CdmpDevice> device_;
     std::shared_ptr<Canbus> canbus_;
     std::shared_ptr<CdmpCanIdManager> can_id_manager_;
+    std::shared_ptr<CdmpNetworkService> network_service_;
     std::shared_ptr<CdmpCommandService> command_service_;
 
     std::vector<std::shared_ptr<ICdmpCanbusService>> canbus_services_;
@@ -61,8 +62,10 @@ public:
     // Configuration
     void SetAutoDiscovery(bool enabled);
     void SetDeviceType(CdmpDeviceType device_type);
+    void SetJoinMode(CdmpJoinMode join_mode);
 
     std::shared_ptr<CdmpDevice> GetDevice() const { return device_; }
+    std::shared_ptr<CdmpNetworkService> GetNetworkService() const { return network_service_; }
     std::shared_ptr<CdmpCommandService> GetCommandService() const { return command_service_; }
 
     // Diagnostics
@@ -0,0 +1,213 @@
+#include <bit>
+#include <stdexcept>
+
+#include "cdmp_device_table.h"
+
+namespace eerie_leap::subsys::cdmp::utilities {
+
+CdmpDeviceTable::CdmpDeviceTable() {
+    Clear();
+}
+
+bool CdmpDeviceTable::IsValidId(uint8_t device_id) {
+    return device_id != CdmpDevice::DEVICE_ID_UNASSIGNED
+        && device_id != CdmpDevice::DEVICE_ID_BROADCAST;
+}
+
+void CdmpDeviceTable::LinkTail(uint8_t device_id) {
+    auto& head = entries_[LIST_HEAD];
+    auto& entry = entries_[device_id];
+
+    entry.prev = head.prev;
+    entry.next = LIST_HEAD;
+    entries_[head.prev].next = device_id;
+    head.prev = device_id;
+}
+
+void CdmpDeviceTable::Unlink(uint8_t device_id) {
+    auto& entry = entries_[device_id];
+
+    entries_[entry.prev].next = entry.next;
+    entries_[entry.next].prev = entry.prev;
+    entry.prev = LIST_HEAD;
+    entry.next = LIST_HEAD;
+}
+
+void CdmpDeviceTable::SetCapabilities(uint8_t device_id, uint32_t capability_flags) {
+    auto& entry = entries_[device_id];
+
+    uint32_t changed = entry.capability_flags ^ capability_flags;
+    while(changed != 0) {
+        int bit = std::countr_zero(changed);
+        capability_devices_[bit].set(device_id, (capability_flags >> bit) & 1);
+        changed &= changed - 1;
+    }
+
+    entry.capability_flags = capability_flags;
+}
+
+bool CdmpDeviceTable::AddOrUpdate(uint8_t device_id, uint32_t uid, CdmpDeviceType device_type, int64_t now) {
+    if(!IsValidId(device_id))
+        throw std::invalid_argument("Invalid device ID");
+
+    auto& entry = entries_[device_id];
+    bool is_new = !Contains(device_id);
+
+    if(is_new) {
+        entry = {};
+        atomic_set_bit(live_ids_, device_id);
+        device_count_++;
+    } else {
+        Unlink(device_id);
+    }
+
+    entry.uid = uid;
+    entry.device_type = device_type;
+    entry.last_heartbeat = now;
+    LinkTail(device_id);
+
+    return is_new;
+}
+
+bool CdmpDeviceTable::UpdateFromHeartbeat(
+    uint8_t device_id,
+    CdmpHealthStatus health_status,
+    uint8_t sequence_number,
+    uint32_t capability_flags,
+    int64_t now) {
+
+    if(!Contains(device_id))
+        return false;
+
+    auto& entry = entries_[device_id];
+    entry.health_status = health_status;
+    entry.sequence_number = sequence_number;
+    entry.last_heartbeat = now;
+    if(entry.capability_flags != capability_flags)
+        SetCapabilities(device_id, capability_flags);
+
+    // Already the most recent one when devices heartbeat in order
+    if(entries_[LIST_HEAD].prev != device_id) {
+        Unlink(device_id);
+        LinkTail(device_id);
+    }
+
+    return true;
+}
+
+bool CdmpDeviceTable::Remove(uint8_t device_id) {
+    if(!Contains(device_id))
+        return false;
+
+    Unlink(device_id);
+    SetCapabilities(device_id, 0);
+    atomic_clear_bit(live_ids_, device_id);
+    device_count_--;
+
+    return true;
+}
+
+void CdmpDeviceTable::Clear() {
+    for(int i = 0; i < ATOMIC_BITMAP_SIZE(MAX_DEVICES + 2); ++i)
+        atomic_clear(&live_ids_[i]);
+
+    for(auto& capability_devices : capability_devices_)
+        capability_devices.reset();
+
+    entries_.fill({});
+    device_count_ = 0;
+}
+
+int CdmpDeviceTable::RemoveExpired(int64_t now, int64_t timeout_ms, const ExpiredCallback& callback) {
+    int removed_count = 0;
+
+    uint8_t device_id = entries_[LIST_HEAD].next;
+    while(device_id != LIST_HEAD && now - entries_[device_id].last_heartbeat > timeout_ms) {
+        uint8_t next_device_id = entries_[device_id].next;
+
+        if(callback)
+            callback(device_id, entries_[device_id]);
+
+        Remove(device_id);
+        removed_count++;
+
+        device_id = next_device_id;
+    }
+
+    return removed_count;
+}
+
+std::optional<int64_t> CdmpDeviceTable::GetNextDeadline(int64_t timeout_ms) const {
+    uint8_t device_id = entries_[LIST_HEAD].next;
+    if(device_id == LIST_HEAD)
+        return std::nullopt;
+
+    return entries_[device_id].last_heartbeat + timeout_ms;
+}
+
+bool CdmpDeviceTable::Contains(uint8_t device_id) const {
+    return IsValidId(device_id) && atomic_test_bit(live_ids_, device_id);
+}
+
+const CdmpDeviceTableEntry* CdmpDeviceTable::Get(uint8_t device_id) const {
+    if(!Contains(device_id))
+        return nullptr;
+
+    return &entries_[device_id];
+}
+
+std::vector<uint8_t> CdmpDeviceTable::GetDeviceIds() const {
+    std::vector<uint8_t> device_ids;
+    device_ids.reserve(device_count_);
+
+    for(int i = 0; i < ATOMIC_BITMAP_SIZE(MAX_DEVICES + 2); ++i) {
+        auto word = static_cast<unsigned long>(atomic_get(&live_ids_[i]));
+        while(word != 0) {
+            device_ids.push_back(i * ATOMIC_BITS + std::countr_zero(word));
+            word &= word - 1;
+        }
+    }
+
+    return device_ids;
+}
+
+uint8_t CdmpDeviceTable::GetLowestDeviceId() const {
+    for(int i = 0; i < ATOMIC_BITMAP_SIZE(MAX_DEVICES + 2); ++i) {
+        auto word = static_cast<unsigned long>(atomic_get(&live_ids_[i]));
+        if(word != 0)
+            return i * ATOMIC_BITS + std::countr_zero(word);
+    }
+
+    return CdmpDevice::DEVICE_ID_UNASSIGNED;
+}
+
+int CdmpDeviceTable::CountDevicesBelow(uint8_t device_id) const {
+    int count = 0;
+
+    for(int i = 0; i < ATOMIC_BITMAP_SIZE(MAX_DEVICES + 2); ++i) {
+        auto word = static_cast<unsigned long>(atomic_get(&live_ids_[i]));
+        int word_start = i * ATOMIC_BITS;
+
+        if(device_id >= word_start + static_cast<int>(ATOMIC_BITS)) {
+            count += std::popcount(word);
+            continue;
+        }
+
+        int bits = device_id - word_start;
+        if(bits > 0)
+            count += std::popcount(word & ((1UL << bits) - 1));
+
+        break;
+    }
+
+    return count;
+}
+
+const CdmpDeviceTable::DeviceIdSet& CdmpDeviceTable::GetDevicesWithCapability(uint8_t capability_bit) const {
+    if(capability_bit >= CAPABILITY_COUNT)
+        throw std::invalid_argument("capability_bit out of range");
+
+    return capability_devices_[capability_bit];
+}
+
+} // namespace eerie_leap::subsys::cdmp::utilities
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <bitset>
+#include <vector>
+#include <optional>
+#include <functional>
+
+#include <zephyr/sys/atomic.h>
+
+#include "subsys/cdmp/models/cdmp_device.h"
+#include "subsys/cdmp/utilities/enums.h"
+
+namespace eerie_leap::subsys::cdmp::utilities {
+
+using namespace eerie_leap::subsys::cdmp::models;
+
+struct CdmpDeviceTableEntry {
+    uint32_t uid = 0;
+    uint32_t capability_flags = 0;
+    int64_t last_heartbeat = 0;
+    CdmpDeviceType device_type = CdmpDeviceType::NONE;
+    CdmpHealthStatus health_status = CdmpHealthStatus::OK;
+    uint8_t sequence_number = 0;
+
+    // Expiry list links, entries are kept ordered by last heartbeat
+    uint8_t prev = 0;
+    uint8_t next = 0;
+};
+
+// Flat table of remote devices indexed by device ID.
+// Valid IDs are 1-254, slot 0 (DEVICE_ID_UNASSIGNED) is the expiry list head.
+// Heartbeats move the device to the list tail, so the list is ordered by
+// deadline and the expiry scan stops at the first device still alive.
+class CdmpDeviceTable {
+public:
+    static constexpr int MAX_DEVICES = 254;
+    static constexpr int CAPABILITY_COUNT = 32;
+
+    using DeviceIdSet = std::bitset<MAX_DEVICES + 2>;
+    using ExpiredCallback = std::function<void(uint8_t device_id, const CdmpDeviceTableEntry& entry)>;
+
+private:
+    static constexpr uint8_t LIST_HEAD = CdmpDevice::DEVICE_ID_UNASSIGNED;
+
+    std::array<CdmpDeviceTableEntry, MAX_DEVICES + 1> entries_;
+    ATOMIC_DEFINE(live_ids_, MAX_DEVICES + 2);
+    std::array<DeviceIdSet, CAPABILITY_COUNT> capability_devices_;
+    int device_count_ = 0;
+
+    static bool IsValidId(uint8_t device_id);
+
+    void LinkTail(uint8_t device_id);
+    void Unlink(uint8_t device_id);
+    void SetCapabilities(uint8_t device_id, uint32_t capability_flags);
+
+public:
+    CdmpDeviceTable();
+
+    bool AddOrUpdate(uint8_t device_id, uint32_t uid, CdmpDeviceType device_type, int64_t now);
+    bool UpdateFromHeartbeat(
+        uint8_t device_id,
+        CdmpHealthStatus health_status,
+        uint8_t sequence_number,
+        uint32_t capability_flags,
+        int64_t now);
+    bool Remove(uint8_t device_id);
+    void Clear();
+
+    int RemoveExpired(int64_t now, int64_t timeout_ms, const ExpiredCallback& callback = nullptr);
+    std::optional<int64_t> GetNextDeadline(int64_t timeout_ms) const;
+
+    bool Contains(uint8_t device_id) const;
+    const CdmpDeviceTableEntry* Get(uint8_t device_id) const;
+    int GetDeviceCount() const { return device_count_; }
+    std::vector<uint8_t> GetDeviceIds() const;
+
+    uint8_t GetLowestDeviceId() const;
+    int CountDevicesBelow(uint8_t device_id) const;
+
+    const DeviceIdSet& GetDevicesWithCapability(uint8_t capability_bit) const;
+};
+
+} // namespace eerie_leap::subsys::cdmp::utilities
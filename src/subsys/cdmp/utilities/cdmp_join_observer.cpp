@@ -0,0 +1,199 @@
+#include <bit>
+#include <utility>
+
+#include "subsys/cdmp/models/cdmp_device.h"
+
+#include "cdmp_join_observer.h"
+
+namespace eerie_leap::subsys::cdmp::utilities {
+
+using namespace eerie_leap::subsys::cdmp::models;
+
+CdmpJoinObserver::CdmpJoinObserver(uint32_t own_uid)
+    : own_uid_(own_uid),
+    discovery_request_count_(ATOMIC_INIT(0)),
+    claiming_device_id_(ATOMIC_INIT(CdmpDevice::DEVICE_ID_UNASSIGNED)),
+    claim_result_(ATOMIC_INIT(NO_CLAIM_RESULT)) {
+
+    k_sem_init(&discovery_response_sem_, 0, K_SEM_MAX_LIMIT);
+    k_sem_init(&claim_response_sem_, 0, 1);
+
+    Reset();
+}
+
+void CdmpJoinObserver::ClearBitmap(atomic_t* bitmap) {
+    for(int i = 0; i < ATOMIC_BITMAP_SIZE(DEVICE_ID_COUNT); ++i)
+        atomic_clear(&bitmap[i]);
+}
+
+int CdmpJoinObserver::CountBits(const atomic_t* bitmap) {
+    int count = 0;
+    for(int i = 0; i < ATOMIC_BITMAP_SIZE(DEVICE_ID_COUNT); ++i)
+        count += std::popcount(static_cast<unsigned long>(atomic_get(&bitmap[i])));
+
+    return count;
+}
+
+void CdmpJoinObserver::Reset() {
+    ClearBitmap(occupied_ids_);
+    ClearBitmap(heartbeat_ids_);
+    ResetDiscovery();
+}
+
+void CdmpJoinObserver::ResetDiscovery() {
+    ClearBitmap(responded_ids_);
+    atomic_clear(&discovery_request_count_);
+    atomic_set(&claiming_device_id_, CdmpDevice::DEVICE_ID_UNASSIGNED);
+    atomic_set(&claim_result_, NO_CLAIM_RESULT);
+
+    k_sem_reset(&discovery_response_sem_);
+    k_sem_reset(&claim_response_sem_);
+}
+
+void CdmpJoinObserver::ObserveHeartbeatFrame(std::span<const uint8_t> frame_data) {
+    if(frame_data.empty())
+        return;
+
+    uint8_t device_id = frame_data[0];
+    if(device_id == CdmpDevice::DEVICE_ID_UNASSIGNED || device_id == CdmpDevice::DEVICE_ID_BROADCAST)
+        return;
+
+    atomic_set_bit(heartbeat_ids_, device_id);
+    atomic_set_bit(occupied_ids_, device_id);
+}
+
+void CdmpJoinObserver::ObserveManagementFrame(std::span<const uint8_t> frame_data) {
+    if(frame_data.empty())
+        return;
+
+    switch(static_cast<CdmpManagementMessageType>(frame_data[0])) {
+        case CdmpManagementMessageType::DISCOVERY_REQUEST:
+            ObserveDiscoveryRequest(frame_data);
+            break;
+
+        case CdmpManagementMessageType::DISCOVERY_RESPONSE:
+            ObserveDiscoveryResponse(frame_data);
+            break;
+
+        case CdmpManagementMessageType::ID_CLAIM:
+            ObserveIdClaimRequest(frame_data);
+            break;
+
+        case CdmpManagementMessageType::ID_CLAIM_RESPONSE:
+            ObserveIdClaimResponse(frame_data);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void CdmpJoinObserver::ObserveDiscoveryRequest(std::span<const uint8_t> frame_data) {
+    if(frame_data.size() < 5)
+        return;
+
+    uint32_t uid = frame_data[1]
+        | (static_cast<uint32_t>(frame_data[2]) << 8)
+        | (static_cast<uint32_t>(frame_data[3]) << 16)
+        | (static_cast<uint32_t>(frame_data[4]) << 24);
+
+    if(uid != own_uid_)
+        atomic_inc(&discovery_request_count_);
+}
+
+void CdmpJoinObserver::ObserveDiscoveryResponse(std::span<const uint8_t> frame_data) {
+    if(frame_data.size() < 2)
+        return;
+
+    uint8_t device_id = frame_data[1];
+    SetOccupied(device_id);
+    atomic_set_bit(responded_ids_, device_id);
+
+    k_sem_give(&discovery_response_sem_);
+}
+
+void CdmpJoinObserver::ObserveIdClaimRequest(std::span<const uint8_t> frame_data) {
+    if(frame_data.size() < 6)
+        return;
+
+    uint32_t uid = frame_data[2]
+        | (static_cast<uint32_t>(frame_data[3]) << 8)
+        | (static_cast<uint32_t>(frame_data[4]) << 16)
+        | (static_cast<uint32_t>(frame_data[5]) << 24);
+
+    if(uid != own_uid_)
+        SetOccupied(frame_data[1]);
+}
+
+void CdmpJoinObserver::ObserveIdClaimResponse(std::span<const uint8_t> frame_data) {
+    if(frame_data.size() < 4)
+        return;
+
+    SetOccupied(frame_data[1]);
+
+    atomic_val_t claiming_device_id = atomic_get(&claiming_device_id_);
+    if(claiming_device_id == CdmpDevice::DEVICE_ID_UNASSIGNED || frame_data[2] != claiming_device_id)
+        return;
+
+    // Keep the most restrictive result: VERSION_INCOMPATIBLE > REJECT > ACCEPT
+    atomic_val_t result = frame_data[3];
+    atomic_val_t current = atomic_get(&claim_result_);
+    while(result > current) {
+        if(atomic_cas(&claim_result_, current, result))
+            break;
+        current = atomic_get(&claim_result_);
+    }
+
+    k_sem_give(&claim_response_sem_);
+}
+
+bool CdmpJoinObserver::WaitForDiscoveryResponse(k_timeout_t timeout) {
+    return k_sem_take(&discovery_response_sem_, timeout) == 0;
+}
+
+void CdmpJoinObserver::BeginClaim(uint8_t claiming_device_id) {
+    atomic_set(&claim_result_, NO_CLAIM_RESULT);
+    k_sem_reset(&claim_response_sem_);
+    atomic_set(&claiming_device_id_, claiming_device_id);
+}
+
+std::optional<CdmpIdClaimResult> CdmpJoinObserver::WaitForClaimResult(k_timeout_t timeout, k_timeout_t settle) {
+    if(k_sem_take(&claim_response_sem_, timeout) != 0) {
+        atomic_set(&claiming_device_id_, CdmpDevice::DEVICE_ID_UNASSIGNED);
+        return std::nullopt;
+    }
+
+    // Lowest ID device accepts while the current owner of the ID rejects,
+    // give the owner a moment to object before trusting an ACCEPT
+    if(atomic_get(&claim_result_) == std::to_underlying(CdmpIdClaimResult::ACCEPT))
+        k_sleep(settle);
+
+    atomic_set(&claiming_device_id_, CdmpDevice::DEVICE_ID_UNASSIGNED);
+
+    return static_cast<CdmpIdClaimResult>(atomic_get(&claim_result_));
+}
+
+bool CdmpJoinObserver::IsOccupied(uint8_t device_id) const {
+    return atomic_test_bit(occupied_ids_, device_id);
+}
+
+void CdmpJoinObserver::SetOccupied(uint8_t device_id) {
+    if(device_id == CdmpDevice::DEVICE_ID_UNASSIGNED || device_id == CdmpDevice::DEVICE_ID_BROADCAST)
+        return;
+
+    atomic_set_bit(occupied_ids_, device_id);
+}
+
+bool CdmpJoinObserver::HaveAllKnownDevicesResponded() const {
+    if(GetRespondedCount() == 0)
+        return false;
+
+    for(int i = 0; i < ATOMIC_BITMAP_SIZE(DEVICE_ID_COUNT); ++i) {
+        if((atomic_get(&heartbeat_ids_[i]) & ~atomic_get(&responded_ids_[i])) != 0)
+            return false;
+    }
+
+    return true;
+}
+
+} // namespace eerie_leap::subsys::cdmp::utilities
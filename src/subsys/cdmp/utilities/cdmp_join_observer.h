@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <optional>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+#include "subsys/cdmp/utilities/enums.h"
+
+namespace eerie_leap::subsys::cdmp::utilities {
+
+// NOTE: Observe* methods are called directly from the CAN bottom half,
+// so state is kept in atomic bitmaps and waiters are woken via semaphores.
+// Management frames queued to the work queue are not processed while
+// the join sequence sleeps on that same queue.
+class CdmpJoinObserver {
+private:
+    static constexpr int DEVICE_ID_COUNT = 256;
+    static constexpr int NO_CLAIM_RESULT = -1;
+
+    // IDs in use by other devices: heartbeats, discovery responses, claims
+    ATOMIC_DEFINE(occupied_ids_, DEVICE_ID_COUNT);
+    // IDs seen sending heartbeats, used to tell when discovery is complete
+    ATOMIC_DEFINE(heartbeat_ids_, DEVICE_ID_COUNT);
+    ATOMIC_DEFINE(responded_ids_, DEVICE_ID_COUNT);
+
+    uint32_t own_uid_;
+    atomic_t discovery_request_count_;
+    atomic_t claiming_device_id_;
+    atomic_t claim_result_;
+
+    k_sem discovery_response_sem_;
+    k_sem claim_response_sem_;
+
+    static void ClearBitmap(atomic_t* bitmap);
+    static int CountBits(const atomic_t* bitmap);
+
+    void ObserveDiscoveryRequest(std::span<const uint8_t> frame_data);
+    void ObserveDiscoveryResponse(std::span<const uint8_t> frame_data);
+    void ObserveIdClaimRequest(std::span<const uint8_t> frame_data);
+    void ObserveIdClaimResponse(std::span<const uint8_t> frame_data);
+
+public:
+    explicit CdmpJoinObserver(uint32_t own_uid);
+
+    void Reset();
+    void ResetDiscovery();
+
+    void ObserveHeartbeatFrame(std::span<const uint8_t> frame_data);
+    void ObserveManagementFrame(std::span<const uint8_t> frame_data);
+
+    bool WaitForDiscoveryResponse(k_timeout_t timeout);
+    void BeginClaim(uint8_t claiming_device_id);
+    std::optional<CdmpIdClaimResult> WaitForClaimResult(k_timeout_t timeout, k_timeout_t settle);
+
+    bool IsOccupied(uint8_t device_id) const;
+    void SetOccupied(uint8_t device_id);
+    bool HaveAllKnownDevicesResponded() const;
+
+    int GetOccupiedCount() const { return CountBits(occupied_ids_); }
+    int GetRespondedCount() const { return CountBits(responded_ids_); }
+    int GetDiscoveryRequestCount() const { return atomic_get(&discovery_request_count_); }
+};
+
+} // namespace eerie_leap::subsys::cdmp::utilities
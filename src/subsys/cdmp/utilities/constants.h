@@ -16,6 +16,10 @@ struct CdmpConstants {
     static constexpr int NETWORK_VALIDATION_INTERVAL_MS = 5000;
     static constexpr int STAGGERED_MESSAGE_TIME_OFFSET_MS = 5;
 
+    // Fast join: single discovery round, finished early once the network goes quiet
+    static constexpr int FAST_JOIN_DISCOVERY_WINDOW_MS = 100;
+    static constexpr int FAST_JOIN_SETTLE_MS = STAGGERED_MESSAGE_TIME_OFFSET_MS * 2;
+
     static constexpr int USER_COMMAND_CODE_MIN = 0x20;
     static constexpr int USER_COMMAND_CODE_MAX = 0xFF;
     static constexpr int COMMAND_BROADCAST_ID = 0xFF;
@@ -20,6 +20,11 @@ enum class CdmpHealthStatus : uint8_t {
     ERROR = 0x02
 };
 
+enum class CdmpJoinMode : uint8_t {
+    SEQUENTIAL = 0x00,
+    FAST = 0x01
+};
+
 // Result codes for Command Response (Base + 3)
 enum class CdmpResultCode : uint8_t {
     SUCCESS = 0x00,
@@ -13,4 +13,94 @@ menu "EerieLeap FS config"
     config EERIE_LEAP_SD_CHECK_INTERVAL_MS
         int "SD check interval ms"
         default 1000
+
+    config EERIE_LEAP_FS_STREAM_BUFFER_SIZE
+        int "FS stream buffer size"
+        default 4096
+        help
+          Write-back and read-ahead buffer size of file streams, rounded
+          up to a multiple of the 512 byte sector size. Best set to the
+          cluster size of the card, 0 writes through.
+
+    config EERIE_LEAP_FS_STREAM_FLUSH_INTERVAL_MS
+        int "FS stream flush interval ms"
+        default 1000
+        help
+          Age of the oldest buffered byte written out by streams using
+          the time flush policy.
+
+    config EERIE_LEAP_FS_LOG_PREALLOCATE_SIZE_KB
+        int "Log file preallocation size KB"
+        default 65536
+        help
+          Extent reserved for each log file when it is created, so the
+          file doesn't allocate clusters as it grows. Should cover the
+          rotation size of the logger, 0 disables preallocation.
+
+    config EERIE_LEAP_FS_LOG_QUOTA_MB
+        int "Log directory quota MB"
+        default 0
+        help
+          Disk usage of log sessions, oldest sessions are deleted to make
+          room for new files once it is reached. 0 only keeps the card
+          from running out of space.
+
+    config EERIE_LEAP_FS_ASYNC_QUEUE_SIZE
+        int "Async FS request queue size"
+        default 32
+        help
+          Requests waiting for the async FS thread, requests submitted
+          without waiting are rejected once the queue is full.
+
+    config EERIE_LEAP_FS_ASYNC_OPEN_FILES
+        int "Async FS open files"
+        default 4
+        help
+          Files kept open between requests, least recently used file is
+          closed to open another one.
+
+    config EERIE_LEAP_FS_ASYNC_COALESCE_SIZE
+        int "Async FS append coalesce size"
+        default 4096
+        help
+          Largest write queued appends to the same file are combined into.
+
+    config EERIE_LEAP_FS_ASYNC_SYNC_INTERVAL_MS
+        int "Async FS sync interval ms"
+        default 1000
+
+    config EERIE_LEAP_FS_ASYNC_THREAD_STACK_SIZE
+        int "Async FS thread stack size"
+        default 3072
+
+    config EERIE_LEAP_FS_ASYNC_THREAD_PRIORITY
+        int "Async FS thread priority"
+        default 7
+
+    config EERIE_LEAP_FS_RESOURCE_LOADER_WORKERS
+        int "Resource loader workers"
+        default 2
+        help
+          Threads parsing resources loaded at startup, e.g. scripts and
+          DBC files, while the next file is read.
+
+    config EERIE_LEAP_FS_RESOURCE_LOADER_PENDING
+        int "Resource loader pending files"
+        default 4
+        help
+          Files read ahead of parsing, limits memory taken by their content.
+
+    config EERIE_LEAP_FS_RESOURCE_LOADER_STACK_SIZE
+        int "Resource loader worker stack size"
+        default 8192
+
+    config EERIE_LEAP_FS_RESOURCE_LOADER_PRIORITY
+        int "Resource loader worker priority"
+        default 7
+
+    config EERIE_LEAP_FS_STREAM_BENCHMARK
+        bool "FS stream benchmark"
+        help
+          Build FsStreamBenchmark, measuring file stream throughput for
+          buffer and chunk sizes. Meant for development builds only.
 endmenu
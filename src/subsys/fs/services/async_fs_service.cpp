@@ -0,0 +1,550 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+#include <zephyr/logging/log.h>
+
+#include "async_fs_service.h"
+
+namespace eerie_leap::subsys::fs::services {
+
+LOG_MODULE_REGISTER(async_fs_service_logger);
+
+AsyncFsFuture::AsyncFsFuture()
+    : is_completed_(ATOMIC_INIT(0)), result_({ .rc = 0, .size_bytes = 0 }) {
+
+    k_sem_init(&completed_sem_, 0, 1);
+}
+
+AsyncFsCallback AsyncFsFuture::GetCallback(std::shared_ptr<AsyncFsFuture> future) {
+    return [future = std::move(future)](const AsyncFsResult& result) {
+        future->Complete(result);
+    };
+}
+
+void AsyncFsFuture::Complete(const AsyncFsResult& result) {
+    result_ = result;
+    atomic_set(&is_completed_, 1);
+    k_sem_give(&completed_sem_);
+}
+
+bool AsyncFsFuture::Wait(k_timeout_t timeout) {
+    if(IsCompleted())
+        return true;
+
+    return k_sem_take(&completed_sem_, timeout) == 0 || IsCompleted();
+}
+
+AsyncFsService::AsyncFsService(
+    std::shared_ptr<IFsService> fs_service,
+    size_t queue_size,
+    size_t open_file_count,
+    size_t coalesce_size,
+    std::pmr::memory_resource* mr)
+        : fs_service_(std::move(fs_service)),
+        mr_(mr),
+        coalesce_size_(coalesce_size),
+        sync_interval_ms_(CONFIG_EERIE_LEAP_FS_ASYNC_SYNC_INTERVAL_MS),
+        msgq_buffer_(std::max<size_t>(queue_size, 1), mr),
+        is_stopping_(ATOMIC_INIT(0)),
+        submitting_count_(ATOMIC_INIT(0)),
+        files_(std::max<size_t>(open_file_count, 1)),
+        use_count_(0),
+        last_sync_time_ms_(0),
+        coalesce_buffer_(mr) {
+
+    if(!fs_service_)
+        throw std::invalid_argument("fs_service cannot be null");
+
+    k_msgq_init(
+        &msgq_,
+        reinterpret_cast<char*>(msgq_buffer_.data()),
+        sizeof(Request*),
+        msgq_buffer_.size());
+
+    for(auto& file : files_) {
+        fs_file_t_init(&file.file);
+        file.is_open = false;
+        file.is_dirty = false;
+        file.is_at_end = false;
+        file.last_used = 0;
+    }
+
+    thread_ = std::make_unique<Thread>(
+        "async_fs",
+        this,
+        k_stack_size_,
+        k_priority_);
+    thread_->Initialize();
+}
+
+AsyncFsService::~AsyncFsService() {
+    Stop();
+}
+
+void AsyncFsService::Start() {
+    if(thread_->IsRunning())
+        return;
+
+    atomic_set(&is_stopping_, 0);
+    thread_->Start();
+}
+
+void AsyncFsService::Stop() {
+    if(!thread_->IsRunning())
+        return;
+
+    atomic_set(&is_stopping_, 1);
+
+    auto* request = new Request{ .type = RequestType::Stop, .data = std::pmr::vector<uint8_t>(mr_) };
+    k_msgq_put(&msgq_, &request, K_FOREVER);
+
+    thread_->Join();
+
+    // NOTE: Requests queued behind the stop request are never processed.
+    // Cancelling them also frees queue space for submitters still blocked.
+    while(true) {
+        bool is_submitting = atomic_get(&submitting_count_) > 0;
+        CancelQueuedRequests();
+
+        if(!is_submitting)
+            break;
+
+        k_sleep(K_MSEC(1));
+    }
+}
+
+void AsyncFsService::CancelQueuedRequests() {
+    Request* request = nullptr;
+
+    while(k_msgq_get(&msgq_, &request, K_NO_WAIT) == 0) {
+        if(request->type == RequestType::Stop)
+            delete request;
+        else
+            Complete(request, { .rc = -ECANCELED, .size_bytes = 0 });
+    }
+}
+
+bool AsyncFsService::Submit(Request* request, k_timeout_t timeout) {
+    if(!thread_->IsRunning()) {
+        LOG_ERR("Async FS thread is not running.");
+        delete request;
+
+        return false;
+    }
+
+    atomic_inc(&submitting_count_);
+
+    if(atomic_get(&is_stopping_)) {
+        atomic_dec(&submitting_count_);
+        LOG_ERR("Async FS service is stopping.");
+        delete request;
+
+        return false;
+    }
+
+    bool is_queued = k_msgq_put(&msgq_, &request, timeout) == 0;
+    atomic_dec(&submitting_count_);
+
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+
+    if(is_queued)
+        queue_high_water_mark_ = std::max(queue_high_water_mark_, k_msgq_num_used_get(&msgq_));
+    else
+        rejected_count_++;
+
+    k_spin_unlock(&lock_, key);
+
+    if(!is_queued)
+        delete request;
+
+    return is_queued;
+}
+
+bool AsyncFsService::Write(std::string_view relative_path, std::span<const uint8_t> data, AsyncFsCallback callback, k_timeout_t timeout) {
+    return Write(relative_path, std::pmr::vector<uint8_t>(data.begin(), data.end(), mr_), std::move(callback), timeout);
+}
+
+bool AsyncFsService::Write(std::string_view relative_path, std::pmr::vector<uint8_t>&& data, AsyncFsCallback callback, k_timeout_t timeout) {
+    auto* request = new Request{
+        .type = RequestType::Write,
+        .path = std::string(relative_path),
+        .data = std::move(data),
+        .offset = 0,
+        .callback = std::move(callback) };
+
+    return Submit(request, timeout);
+}
+
+bool AsyncFsService::Append(std::string_view relative_path, std::span<const uint8_t> data, AsyncFsCallback callback, k_timeout_t timeout) {
+    return Append(relative_path, std::pmr::vector<uint8_t>(data.begin(), data.end(), mr_), std::move(callback), timeout);
+}
+
+bool AsyncFsService::Append(std::string_view relative_path, std::pmr::vector<uint8_t>&& data, AsyncFsCallback callback, k_timeout_t timeout) {
+    auto* request = new Request{
+        .type = RequestType::Append,
+        .path = std::string(relative_path),
+        .data = std::move(data),
+        .offset = 0,
+        .callback = std::move(callback) };
+
+    return Submit(request, timeout);
+}
+
+bool AsyncFsService::Read(std::string_view relative_path, std::span<uint8_t> buffer, size_t offset, AsyncFsCallback callback, k_timeout_t timeout) {
+    auto* request = new Request{
+        .type = RequestType::Read,
+        .path = std::string(relative_path),
+        .data = std::pmr::vector<uint8_t>(mr_),
+        .read_buffer = buffer,
+        .offset = offset,
+        .callback = std::move(callback) };
+
+    return Submit(request, timeout);
+}
+
+bool AsyncFsService::Close(std::string_view relative_path, AsyncFsCallback callback, k_timeout_t timeout) {
+    auto* request = new Request{
+        .type = RequestType::Close,
+        .path = std::string(relative_path),
+        .data = std::pmr::vector<uint8_t>(mr_),
+        .offset = 0,
+        .callback = std::move(callback) };
+
+    return Submit(request, timeout);
+}
+
+bool AsyncFsService::Flush(k_timeout_t timeout) {
+    auto future = std::make_shared<AsyncFsFuture>();
+
+    auto* request = new Request{
+        .type = RequestType::Sync,
+        .data = std::pmr::vector<uint8_t>(mr_),
+        .offset = 0,
+        .callback = AsyncFsFuture::GetCallback(future) };
+
+    if(!Submit(request, timeout))
+        return false;
+
+    return future->Wait(timeout) && future->GetResult().rc == 0;
+}
+
+void AsyncFsService::Complete(Request* request, const AsyncFsResult& result) {
+    if(request->callback)
+        request->callback(result);
+
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+
+    completed_count_++;
+    if(result.rc < 0) {
+        error_count_++;
+    } else if(request->type == RequestType::Write || request->type == RequestType::Append) {
+        bytes_written_ += result.size_bytes;
+    } else if(request->type == RequestType::Read) {
+        bytes_read_ += result.size_bytes;
+    }
+
+    k_spin_unlock(&lock_, key);
+
+    delete request;
+}
+
+AsyncFsService::CachedFile* AsyncFsService::OpenFile(const std::string& path, bool is_created, int& rc) {
+    rc = 0;
+
+    auto it = std::find_if(files_.begin(), files_.end(), [&path](const CachedFile& file) {
+        return file.is_open && file.path == path;
+    });
+
+    if(it != files_.end()) {
+        it->last_used = ++use_count_;
+        return &*it;
+    }
+
+    auto* file = &*std::min_element(files_.begin(), files_.end(), [](const CachedFile& a, const CachedFile& b) {
+        if(a.is_open != b.is_open)
+            return !a.is_open;
+
+        return a.last_used < b.last_used;
+    });
+
+    if(file->is_open)
+        CloseFile(*file);
+
+    std::filesystem::path full_path(fs_service_->GetMountpoint().mnt_point);
+    full_path /= path;
+
+    fs_mode_t open_mode = FS_O_RDWR | (is_created ? FS_O_CREATE : 0);
+
+    fs_file_t_init(&file->file);
+    rc = fs_open(&file->file, full_path.string().c_str(), open_mode);
+
+    if(rc == -ENOENT && is_created) {
+        auto parent = std::filesystem::path(path).parent_path();
+        if(!parent.empty() && fs_service_->CreateDirectory(parent.string()))
+            rc = fs_open(&file->file, full_path.string().c_str(), open_mode);
+    }
+
+    if(rc < 0) {
+        LOG_ERR("Failed to open %s: %d.", path.c_str(), rc);
+        return nullptr;
+    }
+
+    file->path = path;
+    file->is_open = true;
+    file->is_dirty = false;
+    file->is_at_end = false;
+    file->last_used = ++use_count_;
+
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+    open_count_++;
+    k_spin_unlock(&lock_, key);
+
+    return file;
+}
+
+void AsyncFsService::CloseFile(CachedFile& file) {
+    if(!file.is_open)
+        return;
+
+    int rc = fs_close(&file.file);
+    if(rc < 0)
+        LOG_ERR("Failed to close %s: %d.", file.path.c_str(), rc);
+
+    file.is_open = false;
+    file.is_dirty = false;
+    file.path.clear();
+}
+
+void AsyncFsService::CloseFiles() {
+    for(auto& file : files_)
+        CloseFile(file);
+}
+
+int AsyncFsService::SyncFiles() {
+    int result = 0;
+
+    for(auto& file : files_) {
+        if(!file.is_open || !file.is_dirty)
+            continue;
+
+        int rc = fs_sync(&file.file);
+        if(rc < 0) {
+            LOG_ERR("Failed to sync %s: %d.", file.path.c_str(), rc);
+            result = rc;
+        }
+
+        file.is_dirty = false;
+    }
+
+    last_sync_time_ms_ = k_uptime_get();
+
+    return result;
+}
+
+bool AsyncFsService::HasDirtyFiles() const {
+    return std::any_of(files_.begin(), files_.end(), [](const CachedFile& file) {
+        return file.is_open && file.is_dirty;
+    });
+}
+
+bool AsyncFsService::IsSyncDue() const {
+    return k_uptime_get() - last_sync_time_ms_ >= sync_interval_ms_;
+}
+
+void AsyncFsService::ProcessWrite(Request* request) {
+    int rc = 0;
+    CachedFile* file = OpenFile(request->path, true, rc);
+
+    if(file != nullptr) {
+        rc = fs_truncate(&file->file, 0);
+        if(rc == 0)
+            rc = fs_seek(&file->file, 0, FS_SEEK_SET);
+        if(rc == 0)
+            rc = fs_write(&file->file, request->data.data(), request->data.size());
+
+        CloseFile(*file);
+    }
+
+    if(rc >= 0 && static_cast<size_t>(rc) != request->data.size())
+        rc = -ENOSPC;
+
+    Complete(request, { .rc = std::min(rc, 0), .size_bytes = rc < 0 ? 0 : request->data.size() });
+}
+
+void AsyncFsService::ProcessAppend(Request* request) {
+    coalesced_requests_.clear();
+    coalesced_requests_.push_back(request);
+
+    size_t size_bytes = request->data.size();
+    Request* next = nullptr;
+
+    // NOTE: Only this thread takes requests off the queue, so the peeked
+    // request is still the next one.
+    while(k_msgq_peek(&msgq_, &next) == 0
+        && next->type == RequestType::Append
+        && next->path == request->path
+        && size_bytes + next->data.size() <= coalesce_size_) {
+
+        k_msgq_get(&msgq_, &next, K_NO_WAIT);
+        coalesced_requests_.push_back(next);
+        size_bytes += next->data.size();
+    }
+
+    const uint8_t* data = request->data.data();
+
+    if(coalesced_requests_.size() > 1) {
+        coalesce_buffer_.clear();
+        coalesce_buffer_.reserve(coalesce_size_);
+
+        for(auto* coalesced_request : coalesced_requests_)
+            coalesce_buffer_.insert(coalesce_buffer_.end(), coalesced_request->data.begin(), coalesced_request->data.end());
+
+        data = coalesce_buffer_.data();
+
+        k_spinlock_key_t key = k_spin_lock(&lock_);
+        coalesced_count_ += coalesced_requests_.size() - 1;
+        k_spin_unlock(&lock_, key);
+    }
+
+    int rc = 0;
+    CachedFile* file = OpenFile(request->path, true, rc);
+
+    if(file != nullptr) {
+        if(!file->is_at_end)
+            rc = fs_seek(&file->file, 0, FS_SEEK_END);
+        if(rc == 0)
+            rc = fs_write(&file->file, data, size_bytes);
+
+        file->is_dirty = true;
+        file->is_at_end = rc >= 0;
+    }
+
+    if(rc >= 0 && static_cast<size_t>(rc) != size_bytes)
+        rc = -ENOSPC;
+
+    for(auto* coalesced_request : coalesced_requests_) {
+        Complete(coalesced_request, {
+            .rc = std::min(rc, 0),
+            .size_bytes = rc < 0 ? 0 : coalesced_request->data.size() });
+    }
+
+    coalesced_requests_.clear();
+}
+
+void AsyncFsService::ProcessRead(Request* request) {
+    int rc = 0;
+    CachedFile* file = OpenFile(request->path, false, rc);
+
+    if(file != nullptr) {
+        rc = fs_seek(&file->file, static_cast<off_t>(request->offset), FS_SEEK_SET);
+        if(rc == 0)
+            rc = fs_read(&file->file, request->read_buffer.data(), request->read_buffer.size());
+
+        file->is_at_end = false;
+    }
+
+    Complete(request, { .rc = std::min(rc, 0), .size_bytes = rc < 0 ? 0 : static_cast<size_t>(rc) });
+}
+
+void AsyncFsService::ThreadEntry() {
+    Request* request = nullptr;
+    last_sync_time_ms_ = k_uptime_get();
+
+    while(true) {
+        k_timeout_t timeout = K_FOREVER;
+        if(HasDirtyFiles()) {
+            int64_t remaining_ms = last_sync_time_ms_ + sync_interval_ms_ - k_uptime_get();
+            timeout = K_MSEC(std::max<int64_t>(remaining_ms, 0));
+        }
+
+        if(k_msgq_get(&msgq_, &request, timeout) != 0) {
+            SyncFiles();
+            continue;
+        }
+
+        if(request->type == RequestType::Stop) {
+            delete request;
+            break;
+        }
+
+        // Handles don't survive the card being removed, closing them
+        // releases the file objects held by the mount
+        if(!fs_service_->IsAvailable()) {
+            CloseFiles();
+
+            Complete(request, { .rc = -ENODEV, .size_bytes = 0 });
+            continue;
+        }
+
+        switch(request->type) {
+            case RequestType::Write:
+                ProcessWrite(request);
+                break;
+            case RequestType::Append:
+                ProcessAppend(request);
+                break;
+            case RequestType::Read:
+                ProcessRead(request);
+                break;
+            case RequestType::Sync:
+                Complete(request, { .rc = SyncFiles(), .size_bytes = 0 });
+                break;
+            case RequestType::Close: {
+                auto it = std::find_if(files_.begin(), files_.end(), [request](const CachedFile& file) {
+                    return file.is_open && file.path == request->path;
+                });
+                if(it != files_.end())
+                    CloseFile(*it);
+
+                Complete(request, { .rc = 0, .size_bytes = 0 });
+                break;
+            }
+            default:
+                delete request;
+                break;
+        }
+
+        if(HasDirtyFiles() && IsSyncDue())
+            SyncFiles();
+    }
+
+    CloseFiles();
+}
+
+AsyncFsServiceStatistics AsyncFsService::GetStatistics() {
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+
+    AsyncFsServiceStatistics statistics = {
+        .queue_size = static_cast<uint32_t>(msgq_buffer_.size()),
+        .queue_high_water_mark = queue_high_water_mark_,
+        .rejected_count = rejected_count_,
+        .completed_count = completed_count_,
+        .coalesced_count = coalesced_count_,
+        .error_count = error_count_,
+        .open_count = open_count_,
+        .bytes_written = bytes_written_,
+        .bytes_read = bytes_read_
+    };
+
+    k_spin_unlock(&lock_, key);
+
+    return statistics;
+}
+
+void AsyncFsService::ResetStatistics() {
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+
+    queue_high_water_mark_ = 0;
+    rejected_count_ = 0;
+    completed_count_ = 0;
+    coalesced_count_ = 0;
+    error_count_ = 0;
+    open_count_ = 0;
+    bytes_written_ = 0;
+    bytes_read_ = 0;
+
+    k_spin_unlock(&lock_, key);
+}
+
+} // namespace eerie_leap::subsys::fs::services
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <zephyr/kernel.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/sys/atomic.h>
+
+#include "utilities/memory/memory_resource_manager.h"
+#include "subsys/threading/thread.h"
+#include "i_fs_service.h"
+
+namespace eerie_leap::subsys::fs::services {
+
+using namespace eerie_leap::utilities::memory;
+using namespace eerie_leap::subsys::threading;
+
+struct AsyncFsResult {
+    // Negative errno on failure
+    int rc;
+    size_t size_bytes;
+};
+
+// NOTE: Called on the I/O thread, should return quickly
+using AsyncFsCallback = std::function<void(const AsyncFsResult& result)>;
+
+// Completion of a request the caller can wait on, e.g.
+// auto future = std::make_shared<AsyncFsFuture>();
+// async_fs_service->Append(path, data, AsyncFsFuture::GetCallback(future));
+class AsyncFsFuture {
+private:
+    k_sem completed_sem_;
+    atomic_t is_completed_;
+    AsyncFsResult result_;
+
+public:
+    AsyncFsFuture();
+
+    AsyncFsFuture(const AsyncFsFuture&) = delete;
+    AsyncFsFuture& operator=(const AsyncFsFuture&) = delete;
+
+    // Callback keeps the future alive until the request is completed
+    static AsyncFsCallback GetCallback(std::shared_ptr<AsyncFsFuture> future);
+
+    void Complete(const AsyncFsResult& result);
+    bool Wait(k_timeout_t timeout = K_FOREVER);
+    bool IsCompleted() const { return atomic_get(&is_completed_) != 0; }
+    // Only valid once completed
+    const AsyncFsResult& GetResult() const { return result_; }
+};
+
+struct AsyncFsServiceStatistics {
+    uint32_t queue_size;
+    uint32_t queue_high_water_mark;
+    uint32_t rejected_count;
+    uint32_t completed_count;
+    uint32_t coalesced_count;
+    uint32_t error_count;
+    uint32_t open_count;
+    uint64_t bytes_written;
+    uint64_t bytes_read;
+};
+
+// Performs file I/O on a dedicated thread, so threads submitting requests
+// don't wait for the card. Requests are queued in a bounded queue and
+// completed in submission order, submitting doesn't block by default and
+// fails once the queue is full.
+// Appends to the same file queued one after another are written with a
+// single write. Files are kept open between requests, least recently used
+// file is closed once all handles are taken, written files are synced
+// after the sync interval, on Flush and when closed.
+// NOTE: Files kept open shouldn't be opened elsewhere at the same time,
+// Close releases the handle of a file.
+class AsyncFsService : public IThread {
+private:
+    enum class RequestType {
+        Write,
+        Append,
+        Read,
+        Sync,
+        Close,
+        Stop
+    };
+
+    struct Request {
+        RequestType type;
+        std::string path;
+        std::pmr::vector<uint8_t> data;
+        std::span<uint8_t> read_buffer;
+        size_t offset;
+        AsyncFsCallback callback;
+    };
+
+    struct CachedFile {
+        std::string path;
+        fs_file_t file;
+        bool is_open;
+        bool is_dirty;
+        bool is_at_end;
+        uint32_t last_used;
+    };
+
+    static constexpr int k_stack_size_ = CONFIG_EERIE_LEAP_FS_ASYNC_THREAD_STACK_SIZE;
+    static constexpr int k_priority_ = CONFIG_EERIE_LEAP_FS_ASYNC_THREAD_PRIORITY;
+    std::unique_ptr<Thread> thread_;
+
+    std::shared_ptr<IFsService> fs_service_;
+    std::pmr::memory_resource* mr_;
+    size_t coalesce_size_;
+    uint32_t sync_interval_ms_;
+
+    std::pmr::vector<Request*> msgq_buffer_;
+    k_msgq msgq_;
+
+    // Requests are rejected once stopping, those being queued meanwhile
+    // are counted so Stop can cancel them after the thread is joined
+    atomic_t is_stopping_;
+    atomic_t submitting_count_;
+
+    std::vector<CachedFile> files_;
+    uint32_t use_count_;
+    int64_t last_sync_time_ms_;
+    std::pmr::vector<uint8_t> coalesce_buffer_;
+    std::vector<Request*> coalesced_requests_;
+
+    k_spinlock lock_;
+    uint32_t queue_high_water_mark_ = 0;
+    uint32_t rejected_count_ = 0;
+    uint32_t completed_count_ = 0;
+    uint32_t coalesced_count_ = 0;
+    uint32_t error_count_ = 0;
+    uint32_t open_count_ = 0;
+    uint64_t bytes_written_ = 0;
+    uint64_t bytes_read_ = 0;
+
+    void ThreadEntry() override;
+
+    bool Submit(Request* request, k_timeout_t timeout);
+    void Complete(Request* request, const AsyncFsResult& result);
+    void CancelQueuedRequests();
+
+    void ProcessWrite(Request* request);
+    void ProcessAppend(Request* request);
+    void ProcessRead(Request* request);
+
+    CachedFile* OpenFile(const std::string& path, bool is_created, int& rc);
+    void CloseFile(CachedFile& file);
+    void CloseFiles();
+    int SyncFiles();
+    bool IsSyncDue() const;
+    bool HasDirtyFiles() const;
+
+public:
+    AsyncFsService(
+        std::shared_ptr<IFsService> fs_service,
+        size_t queue_size = CONFIG_EERIE_LEAP_FS_ASYNC_QUEUE_SIZE,
+        size_t open_file_count = CONFIG_EERIE_LEAP_FS_ASYNC_OPEN_FILES,
+        size_t coalesce_size = CONFIG_EERIE_LEAP_FS_ASYNC_COALESCE_SIZE,
+        std::pmr::memory_resource* mr = Mrm::GetExtPmr());
+    ~AsyncFsService();
+
+    AsyncFsService(const AsyncFsService&) = delete;
+    AsyncFsService& operator=(const AsyncFsService&) = delete;
+
+    void Start();
+    // Completes all submitted requests, closes files and stops the thread.
+    // Requests submitted while stopping are completed with -ECANCELED.
+    void Stop();
+
+    void SetSyncInterval(uint32_t sync_interval_ms) { sync_interval_ms_ = sync_interval_ms; }
+
+    // Replaces the content of the file, the file is closed once written.
+    // Data is copied, the vector overloads take the data as is.
+    bool Write(std::string_view relative_path, std::span<const uint8_t> data, AsyncFsCallback callback = nullptr, k_timeout_t timeout = K_NO_WAIT);
+    bool Write(std::string_view relative_path, std::pmr::vector<uint8_t>&& data, AsyncFsCallback callback = nullptr, k_timeout_t timeout = K_NO_WAIT);
+    bool Append(std::string_view relative_path, std::span<const uint8_t> data, AsyncFsCallback callback = nullptr, k_timeout_t timeout = K_NO_WAIT);
+    bool Append(std::string_view relative_path, std::pmr::vector<uint8_t>&& data, AsyncFsCallback callback = nullptr, k_timeout_t timeout = K_NO_WAIT);
+    // NOTE: Buffer has to stay valid until the request is completed,
+    // result size is the number of bytes read.
+    bool Read(std::string_view relative_path, std::span<uint8_t> buffer, size_t offset = 0, AsyncFsCallback callback = nullptr, k_timeout_t timeout = K_NO_WAIT);
+    bool Close(std::string_view relative_path, AsyncFsCallback callback = nullptr, k_timeout_t timeout = K_NO_WAIT);
+
+    // Waits for requests submitted before to complete and open files to be synced
+    bool Flush(k_timeout_t timeout = K_FOREVER);
+
+    AsyncFsServiceStatistics GetStatistics();
+    void ResetStatistics();
+};
+
+} // namespace eerie_leap::subsys::fs::services
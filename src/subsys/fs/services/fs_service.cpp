@@ -146,6 +146,27 @@ bool FsService::DeleteFile(std::string_view relative_path) {
     return true;
 }
 
+bool FsService::RenameFile(std::string_view relative_path, std::string_view new_relative_path) {
+    if(!IsMounted()) {
+        LOG_ERR("Filesystem not mounted.");
+        return false;
+    }
+
+    std::filesystem::path full_path(mountpoint_.mnt_point);
+    full_path /= relative_path;
+
+    std::filesystem::path new_full_path(mountpoint_.mnt_point);
+    new_full_path /= new_relative_path;
+
+    int rc = fs_rename(full_path.string().c_str(), new_full_path.string().c_str());
+    if(rc < 0) {
+        LOG_ERR("fs_rename failed: %d.", rc);
+        return false;
+    }
+
+    return true;
+}
+
 bool FsService::DeleteRecursive(std::string_view relative_path) {
     if(!IsMounted()) {
         LOG_ERR("Filesystem not mounted.");
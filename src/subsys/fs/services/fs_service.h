@@ -28,6 +28,7 @@ public:
     bool CreateDirectory(std::string_view relative_path) override;
     bool Exists(std::string_view relative_path) override;
     bool DeleteFile(std::string_view relative_path) override;
+    bool RenameFile(std::string_view relative_path, std::string_view new_relative_path) override;
     bool DeleteRecursive(std::string_view relative_path = "") override;
     std::vector<std::string> ListFiles(std::string_view relative_path = "") const override;
     size_t GetFileSize(std::string_view relative_path) const override;
@@ -1,9 +1,32 @@
+#include <algorithm>
+#include <cstring>
+
+#include <zephyr/kernel.h>
+
 #include "fs_service_stream_buf.h"
 
 namespace eerie_leap::subsys::fs::services {
 
-FsServiceStreamBuf::FsServiceStreamBuf(IFsService* fs_service, const std::string& relative_path, OpenMode mode)
-    : fs_service_(fs_service), relative_path_(relative_path), file_opened_(false), input_buffer_(BUFFER_SIZE) {
+FsServiceStreamBuf::FsServiceStreamBuf(
+    IFsService* fs_service,
+    const std::string& relative_path,
+    OpenMode mode,
+    size_t buffer_size,
+    FlushPolicy flush_policy,
+    std::pmr::memory_resource* mr)
+        : fs_service_(fs_service),
+        relative_path_(relative_path),
+        file_opened_(false),
+        is_trimmed_on_close_(false),
+        write_end_(0),
+        buffer_size_((buffer_size + SECTOR_SIZE - 1) / SECTOR_SIZE * SECTOR_SIZE),
+        flush_policy_(flush_policy),
+        flush_interval_ms_(CONFIG_EERIE_LEAP_FS_STREAM_FLUSH_INTERVAL_MS),
+        first_buffered_time_ms_(0),
+        is_read_ahead_(mode == OpenMode::Read && buffer_size_ > 0),
+        is_write_failed_(false),
+        input_buffer_(mr),
+        output_buffer_(mr) {
 
     if(!fs_service_)
         throw std::invalid_argument("fs_service cannot be null");
@@ -31,6 +54,9 @@ FsServiceStreamBuf::FsServiceStreamBuf(IFsService* fs_service, const std::string
         case OpenMode::Append:
             open_mode = FS_O_WRITE | FS_O_CREATE | FS_O_APPEND;
             break;
+        case OpenMode::ReadWrite:
+            open_mode = FS_O_RDWR;
+            break;
     }
 
     fs_file_t_init(&file_);
@@ -42,6 +68,7 @@ FsServiceStreamBuf::FsServiceStreamBuf(IFsService* fs_service, const std::string
     file_opened_ = true;
 
     setg(nullptr, nullptr, nullptr);
+    setp(nullptr, nullptr);
 }
 
 FsServiceStreamBuf::~FsServiceStreamBuf() {
@@ -50,9 +77,18 @@ FsServiceStreamBuf::~FsServiceStreamBuf() {
 
 bool FsServiceStreamBuf::close() {
     if(file_opened_) {
+        bool is_flushed = FlushOutput();
+
+        if(is_trimmed_on_close_)
+            fs_truncate(&file_, write_end_);
+
         int rc = fs_close(&file_);
         file_opened_ = false;
-        return rc == 0;
+
+        setg(nullptr, nullptr, nullptr);
+        setp(nullptr, nullptr);
+
+        return rc == 0 && is_flushed;
     }
 
     return true;
@@ -62,36 +98,207 @@ bool FsServiceStreamBuf::is_open() const {
     return file_opened_;
 }
 
-std::streamsize FsServiceStreamBuf::xsputn(const char* s, std::streamsize n) {
-    if(!file_opened_)
-        return 0;
+bool FsServiceStreamBuf::Preallocate(size_t size_bytes, bool is_trimmed_on_close) {
+    if(!file_opened_ || !FlushOutput())
+        return false;
+
+    DiscardInput();
+
+    off_t position = fs_tell(&file_);
+    if(position < 0 || fs_seek(&file_, 0, FS_SEEK_END) != 0)
+        return false;
+
+    off_t file_size = fs_tell(&file_);
+    int rc = 0;
+
+    if(file_size >= 0 && static_cast<size_t>(file_size) < size_bytes)
+        rc = fs_truncate(&file_, static_cast<off_t>(size_bytes));
 
+    fs_seek(&file_, position, FS_SEEK_SET);
+
+    if(rc < 0)
+        return false;
+
+    is_trimmed_on_close_ = is_trimmed_on_close;
+    write_end_ = position;
+
+    return true;
+}
+
+std::streamsize FsServiceStreamBuf::WriteDirect(const char* s, std::streamsize n) {
     ssize_t rc = fs_write(&file_, s, static_cast<size_t>(n));
+    if(rc < 0) {
+        is_write_failed_ = true;
+        return 0;
+    }
+
+    if(is_trimmed_on_close_)
+        write_end_ = std::max(write_end_, fs_tell(&file_));
+
+    return rc;
+}
+
+std::streamsize FsServiceStreamBuf::ReadDirect(char* s, std::streamsize n) {
+    ssize_t rc = fs_read(&file_, s, static_cast<size_t>(n));
     if(rc < 0)
         return 0;
 
     return rc;
 }
 
+// Put area ends on the next sector boundary past a buffer worth of data
+void FsServiceStreamBuf::ResetOutput() {
+    if(buffer_size_ == 0) {
+        setp(nullptr, nullptr);
+        return;
+    }
+
+    if(output_buffer_.empty())
+        output_buffer_.resize(buffer_size_);
+
+    off_t position = fs_tell(&file_);
+    size_t size = buffer_size_;
+    if(position > 0)
+        size -= static_cast<size_t>(position) % SECTOR_SIZE;
+
+    setp(output_buffer_.data(), output_buffer_.data() + size);
+}
+
+bool FsServiceStreamBuf::FlushOutput() {
+    if(pbase() == nullptr)
+        return true;
+
+    auto size = static_cast<std::streamsize>(pptr() - pbase());
+    bool is_written = size == 0 || WriteDirect(pbase(), size) == size;
+
+    ResetOutput();
+
+    return is_written;
+}
+
+// Moves the file position back to the first byte not consumed yet
+void FsServiceStreamBuf::DiscardInput() {
+    if(gptr() != nullptr && gptr() < egptr())
+        fs_seek(&file_, -static_cast<off_t>(egptr() - gptr()), FS_SEEK_CUR);
+
+    setg(nullptr, nullptr, nullptr);
+}
+
+void FsServiceStreamBuf::ApplyFlushPolicy() {
+    if(flush_policy_ == FlushPolicy::Sync) {
+        FlushOutput();
+        fs_sync(&file_);
+    } else if(flush_policy_ == FlushPolicy::Time
+        && pptr() > pbase()
+        && k_uptime_get() - first_buffered_time_ms_ >= flush_interval_ms_) {
+
+        FlushOutput();
+    }
+}
+
+std::streamsize FsServiceStreamBuf::xsputn(const char* s, std::streamsize n) {
+    if(!file_opened_ || n <= 0)
+        return 0;
+
+    is_write_failed_ = false;
+
+    if(pbase() == nullptr) {
+        DiscardInput();
+        ResetOutput();
+    }
+
+    std::streamsize written = 0;
+
+    while(written < n) {
+        if(pbase() == nullptr) {
+            written += WriteDirect(s + written, n - written);
+            break;
+        }
+
+        // Whole sectors from an aligned position skip the buffer
+        bool is_aligned = pptr() == pbase()
+            && static_cast<size_t>(epptr() - pbase()) == buffer_size_;
+        if(is_aligned && static_cast<size_t>(n - written) >= buffer_size_) {
+            auto size = static_cast<std::streamsize>((n - written) / SECTOR_SIZE * SECTOR_SIZE);
+            auto direct_written = WriteDirect(s + written, size);
+            written += direct_written;
+
+            if(direct_written != size)
+                break;
+
+            ResetOutput();
+            continue;
+        }
+
+        if(pptr() == pbase())
+            first_buffered_time_ms_ = k_uptime_get();
+
+        auto size = std::min(n - written, static_cast<std::streamsize>(epptr() - pptr()));
+        std::memcpy(pptr(), s + written, size);
+        pbump(static_cast<int>(size));
+        written += size;
+
+        if(pptr() == epptr() && !FlushOutput())
+            break;
+    }
+
+    ApplyFlushPolicy();
+
+    return is_write_failed_ ? 0 : written;
+}
+
 std::streambuf::int_type FsServiceStreamBuf::overflow(std::streambuf::int_type c) {
-    if(c != traits_type::eof()) {
-        char ch = traits_type::to_char_type(c);
-        if(xsputn(&ch, 1) == 1)
-            return c;
+    if(!file_opened_)
+        return traits_type::eof();
+
+    if(pbase() == nullptr) {
+        DiscardInput();
+        ResetOutput();
+    } else if(!FlushOutput()) {
+        return traits_type::eof();
     }
 
-    return traits_type::eof();
+    if(c == traits_type::eof())
+        return traits_type::not_eof(c);
+
+    char ch = traits_type::to_char_type(c);
+    if(xsputn(&ch, 1) != 1)
+        return traits_type::eof();
+
+    return c;
 }
 
 std::streamsize FsServiceStreamBuf::xsgetn(char* s, std::streamsize n) {
-    if(!file_opened_)
+    if(!file_opened_ || !FlushOutput())
         return 0;
 
-    ssize_t rc = fs_read(&file_, s, static_cast<size_t>(n));
-    if(rc < 0)
-        return 0;
+    setp(nullptr, nullptr);
 
-    return rc;
+    std::streamsize read = 0;
+
+    while(read < n) {
+        if(gptr() != nullptr && gptr() < egptr()) {
+            auto size = std::min(n - read, static_cast<std::streamsize>(egptr() - gptr()));
+            std::memcpy(s + read, gptr(), size);
+            gbump(static_cast<int>(size));
+            read += size;
+
+            continue;
+        }
+
+        // Large reads don't benefit from going through the buffer
+        if(!is_read_ahead_ || static_cast<size_t>(n - read) >= buffer_size_) {
+            setg(nullptr, nullptr, nullptr);
+            read += ReadDirect(s + read, n - read);
+
+            break;
+        }
+
+        if(underflow() == traits_type::eof())
+            break;
+    }
+
+    return read;
 }
 
 std::streambuf::int_type FsServiceStreamBuf::underflow() {
@@ -101,10 +308,20 @@ std::streambuf::int_type FsServiceStreamBuf::underflow() {
     if(gptr() < egptr())
         return traits_type::to_int_type(*gptr());
 
+    if(!FlushOutput())
+        return traits_type::eof();
+
+    setp(nullptr, nullptr);
+
+    if(input_buffer_.empty())
+        input_buffer_.resize(std::max(buffer_size_, SECTOR_SIZE));
+
     ssize_t bytes_read = fs_read(&file_, input_buffer_.data(), input_buffer_.size());
 
-    if(bytes_read <= 0)
+    if(bytes_read <= 0) {
+        setg(nullptr, nullptr, nullptr);
         return traits_type::eof();
+    }
 
     setg(input_buffer_.data(), input_buffer_.data(), input_buffer_.data() + bytes_read);
 
@@ -112,10 +329,13 @@ std::streambuf::int_type FsServiceStreamBuf::underflow() {
 }
 
 int FsServiceStreamBuf::sync() {
-    if(file_opened_)
-        return fs_sync(&file_);
+    if(!file_opened_)
+        return -1;
 
-    return -1;
+    if(!FlushOutput())
+        return -1;
+
+    return fs_sync(&file_);
 }
 
 std::streambuf::pos_type FsServiceStreamBuf::seekoff(
@@ -126,11 +346,40 @@ std::streambuf::pos_type FsServiceStreamBuf::seekoff(
     if(!file_opened_)
         return std::streambuf::pos_type(std::streambuf::off_type(-1));
 
+    // Position queries don't flush
+    if(way == std::ios_base::cur && off == 0) {
+        off_t pos = fs_tell(&file_);
+        if(pos < 0)
+            return std::streambuf::pos_type(std::streambuf::off_type(-1));
+
+        if(pbase() != nullptr)
+            pos += pptr() - pbase();
+        if(gptr() != nullptr)
+            pos -= egptr() - gptr();
+
+        return std::streambuf::pos_type(static_cast<std::streambuf::off_type>(pos));
+    }
+
+    if(!FlushOutput())
+        return std::streambuf::pos_type(std::streambuf::off_type(-1));
+
     int whence = FS_SEEK_SET;
-    if(way == std::ios_base::cur)
+    if(way == std::ios_base::cur) {
         whence = FS_SEEK_CUR;
-    else if(way == std::ios_base::end)
-        whence = FS_SEEK_END;
+
+        // File position is past the input not consumed yet
+        if(gptr() != nullptr)
+            off -= egptr() - gptr();
+    } else if(way == std::ios_base::end) {
+        // Reserved space past the data isn't part of the stream
+        if(is_trimmed_on_close_)
+            off += write_end_;
+        else
+            whence = FS_SEEK_END;
+    }
+
+    setg(nullptr, nullptr, nullptr);
+    setp(nullptr, nullptr);
 
     int rc = fs_seek(&file_, static_cast<off_t>(off), whence);
     if(rc != 0)
@@ -140,8 +389,6 @@ std::streambuf::pos_type FsServiceStreamBuf::seekoff(
     if(pos < 0)
         return std::streambuf::pos_type(std::streambuf::off_type(-1));
 
-    setg(nullptr, nullptr, nullptr);
-
     return std::streambuf::pos_type(static_cast<std::streambuf::off_type>(pos));
 }
 
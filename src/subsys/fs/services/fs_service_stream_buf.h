@@ -1,22 +1,72 @@
 #pragma once
 
+#include <cstdint>
+#include <memory_resource>
 #include <streambuf>
 #include <filesystem>
 #include <string>
+#include <vector>
 
+#include "utilities/memory/memory_resource_manager.h"
 #include "i_fs_service.h"
 
 namespace eerie_leap::subsys::fs::services {
 
+using namespace eerie_leap::utilities::memory;
+
+// Writes are collected in a write-back buffer and handed to the file
+// system in sector aligned chunks, the first chunk after a seek is cut
+// short so the following ones start on a sector boundary. Writes of at
+// least a buffer from an aligned position go to the file directly.
+// Read-ahead fills the input buffer for small sequential reads, without
+// it reads go to the file directly and only single characters are buffered.
+// NOTE: Buffer size of zero writes through, as every write used to.
 class FsServiceStreamBuf : public std::streambuf {
+public:
+    enum class OpenMode {
+        Read,
+        Write,
+        Append,
+        // Existing file, for patching in place
+        ReadWrite
+    };
+
+    enum class FlushPolicy {
+        // Buffer is written once full, on sync, seek and close
+        Size,
+        // As Size, and on the next write once the oldest buffered byte
+        // is older than the flush interval
+        Time,
+        // Every write is written and synced
+        Sync
+    };
+
 private:
+    static constexpr size_t SECTOR_SIZE = 512;
+
     IFsService* fs_service_;
     std::string relative_path_;
     struct fs_file_t file_;
     bool file_opened_;
+    bool is_trimmed_on_close_;
+    off_t write_end_;
 
-    static constexpr size_t BUFFER_SIZE = 4096;
-    std::vector<char> input_buffer_;
+    size_t buffer_size_;
+    FlushPolicy flush_policy_;
+    uint32_t flush_interval_ms_;
+    int64_t first_buffered_time_ms_;
+    bool is_read_ahead_;
+    bool is_write_failed_;
+
+    std::pmr::vector<char> input_buffer_;
+    std::pmr::vector<char> output_buffer_;
+
+    bool FlushOutput();
+    void ResetOutput();
+    void DiscardInput();
+    void ApplyFlushPolicy();
+    std::streamsize WriteDirect(const char* s, std::streamsize n);
+    std::streamsize ReadDirect(char* s, std::streamsize n);
 
 protected:
     std::streamsize xsputn(const char* s, std::streamsize n) override;
@@ -31,18 +81,29 @@ protected:
     std::streambuf::pos_type seekpos(std::streambuf::pos_type sp, std::ios_base::openmode which) override;
 
 public:
-    enum class OpenMode {
-        Read,
-        Write,
-        Append
-    };
-
-    FsServiceStreamBuf(IFsService* fs_service, const std::string& relative_path, OpenMode mode);
+    // NOTE: Buffer size is rounded up to a multiple of the sector size,
+    // read-ahead is enabled for files opened for reading.
+    FsServiceStreamBuf(
+        IFsService* fs_service,
+        const std::string& relative_path,
+        OpenMode mode,
+        size_t buffer_size = CONFIG_EERIE_LEAP_FS_STREAM_BUFFER_SIZE,
+        FlushPolicy flush_policy = FlushPolicy::Size,
+        std::pmr::memory_resource* mr = Mrm::GetExtPmr());
     ~FsServiceStreamBuf();
 
     bool close();
     bool is_open() const;
 
+    void SetFlushInterval(uint32_t flush_interval_ms) { flush_interval_ms_ = flush_interval_ms; }
+    void SetReadAhead(bool is_read_ahead) { is_read_ahead_ = is_read_ahead && buffer_size_ > 0; }
+
+    // Extends the file to the size given, so clusters are allocated before
+    // writing rather than as the file grows. Position is kept.
+    // NOTE: With trimming, space past the last byte written is released on
+    // close and seeking relative to the end uses the last byte written.
+    bool Preallocate(size_t size_bytes, bool is_trimmed_on_close = true);
+
     FsServiceStreamBuf(const FsServiceStreamBuf&) = delete;
     FsServiceStreamBuf& operator=(const FsServiceStreamBuf&) = delete;
 };
@@ -19,6 +19,8 @@ public:
     virtual bool CreateDirectory(std::string_view relative_path) = 0;
     virtual bool Exists(std::string_view relative_path) = 0;
     virtual bool DeleteFile(std::string_view relative_path) = 0;
+    // NOTE: Existing file at the new path is replaced
+    virtual bool RenameFile(std::string_view relative_path, std::string_view new_relative_path) = 0;
     virtual bool DeleteRecursive(std::string_view relative_path = "") = 0;
     virtual std::vector<std::string> ListFiles(std::string_view relative_path = "") const = 0;
     virtual size_t GetFileSize(std::string_view relative_path) const = 0;
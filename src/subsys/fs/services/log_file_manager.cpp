@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+
+#include <zephyr/logging/log.h>
+
+#include "log_file_manager.h"
+
+namespace eerie_leap::subsys::fs::services {
+
+LOG_MODULE_REGISTER(log_file_manager_logger);
+
+LogFileManager::LogFileManager(
+    std::shared_ptr<IFsService> fs_service,
+    std::string directory,
+    std::string extension,
+    size_t preallocate_size_bytes,
+    uint64_t quota_bytes)
+        : fs_service_(std::move(fs_service)),
+        directory_(std::move(directory)),
+        extension_(std::move(extension)),
+        preallocate_size_bytes_(preallocate_size_bytes),
+        quota_bytes_(quota_bytes),
+        session_index_(std::nullopt),
+        file_index_(0),
+        is_next_file_reserved_(false) {
+
+    if(!fs_service_)
+        throw std::invalid_argument("fs_service cannot be null");
+
+    k_mutex_init(&mutex_);
+}
+
+std::string LogFileManager::GetSessionPath(uint32_t session_index) const {
+    char name[16];
+    snprintf(name, sizeof(name), "%04u", session_index);
+
+    return (std::filesystem::path(directory_) / name).string();
+}
+
+std::string LogFileManager::GetFilePath(uint32_t file_index) const {
+    char name[16];
+    snprintf(name, sizeof(name), "%04u.", file_index);
+
+    return (std::filesystem::path(GetSessionPath(session_index_.value())) / (name + extension_)).string();
+}
+
+std::vector<uint32_t> LogFileManager::ListSessionIndexes() const {
+    std::vector<uint32_t> session_indexes;
+
+    for(const auto& name : fs_service_->ListFiles(directory_)) {
+        uint32_t session_index = 0;
+        auto [end, ec] = std::from_chars(name.data(), name.data() + name.size(), session_index);
+
+        if(ec == std::errc() && end == name.data() + name.size())
+            session_indexes.push_back(session_index);
+    }
+
+    std::sort(session_indexes.begin(), session_indexes.end());
+
+    return session_indexes;
+}
+
+std::vector<std::string> LogFileManager::ListSessions() const {
+    std::vector<std::string> sessions;
+
+    for(uint32_t session_index : ListSessionIndexes())
+        sessions.push_back(GetSessionPath(session_index));
+
+    return sessions;
+}
+
+uint64_t LogFileManager::GetSessionSize(uint32_t session_index) const {
+    auto session_path = std::filesystem::path(GetSessionPath(session_index));
+    uint64_t size_bytes = 0;
+
+    for(const auto& file_name : fs_service_->ListFiles(session_path.string()))
+        size_bytes += fs_service_->GetFileSize((session_path / file_name).string());
+
+    return size_bytes;
+}
+
+bool LogFileManager::DeleteSession(uint32_t session_index) {
+    auto session_path = GetSessionPath(session_index);
+
+    if(!fs_service_->DeleteRecursive(session_path) || !fs_service_->DeleteFile(session_path)) {
+        LOG_ERR("Failed to delete log session %s.", session_path.c_str());
+        return false;
+    }
+
+    LOG_INF("Deleted log session %s.", session_path.c_str());
+
+    return true;
+}
+
+bool LogFileManager::EnforceQuota(uint64_t required_bytes) {
+    auto session_indexes = ListSessionIndexes();
+
+    uint64_t used_bytes = 0;
+    if(quota_bytes_ > 0) {
+        for(uint32_t session_index : session_indexes)
+            used_bytes += GetSessionSize(session_index);
+    }
+
+    for(uint32_t session_index : session_indexes) {
+        uint64_t free_bytes = fs_service_->GetTotalSpace() - fs_service_->GetUsedSpace();
+        bool is_over_quota = quota_bytes_ > 0 && used_bytes + required_bytes > quota_bytes_;
+
+        if(!is_over_quota && free_bytes >= required_bytes)
+            return true;
+
+        if(session_index_.has_value() && session_index == session_index_.value())
+            break;
+
+        uint64_t session_size = quota_bytes_ > 0 ? GetSessionSize(session_index) : 0;
+        if(!DeleteSession(session_index))
+            return false;
+
+        used_bytes -= std::min(used_bytes, session_size);
+    }
+
+    uint64_t free_bytes = fs_service_->GetTotalSpace() - fs_service_->GetUsedSpace();
+    bool is_over_quota = quota_bytes_ > 0 && used_bytes + required_bytes > quota_bytes_;
+    if(is_over_quota || free_bytes < required_bytes) {
+        LOG_ERR("Not enough space for the next log file.");
+        return false;
+    }
+
+    return true;
+}
+
+bool LogFileManager::StartSession() {
+    k_mutex_lock(&mutex_, K_FOREVER);
+
+    auto session_indexes = ListSessionIndexes();
+    uint32_t session_index = session_indexes.empty() ? 1 : session_indexes.back() + 1;
+
+    bool is_created = fs_service_->CreateDirectory(GetSessionPath(session_index));
+    if(is_created) {
+        session_index_ = session_index;
+        file_index_ = 0;
+        is_next_file_reserved_ = false;
+
+        LOG_INF("Started log session %s.", GetSessionPath(session_index).c_str());
+    }
+
+    k_mutex_unlock(&mutex_);
+
+    return is_created;
+}
+
+bool LogFileManager::ReserveNextFileLocked() {
+    if(!session_index_.has_value())
+        return false;
+
+    if(is_next_file_reserved_)
+        return true;
+
+    if(!EnforceQuota(preallocate_size_bytes_))
+        return false;
+
+    if(preallocate_size_bytes_ == 0)
+        return true;
+
+    try {
+        FsServiceStreamBuf stream(fs_service_.get(), GetFilePath(file_index_ + 1), FsServiceStreamBuf::OpenMode::Write);
+        if(!stream.Preallocate(preallocate_size_bytes_, false)) {
+            LOG_ERR("Failed to preallocate log file.");
+            return false;
+        }
+    } catch(const std::exception& e) {
+        LOG_ERR("Failed to create log file: %s", e.what());
+        return false;
+    }
+
+    is_next_file_reserved_ = true;
+
+    return true;
+}
+
+bool LogFileManager::ReserveNextFile() {
+    k_mutex_lock(&mutex_, K_FOREVER);
+    bool is_reserved = ReserveNextFileLocked();
+    k_mutex_unlock(&mutex_);
+
+    return is_reserved;
+}
+
+std::unique_ptr<FsServiceStreamBuf> LogFileManager::OpenNextFile() {
+    if(!session_index_.has_value() && !StartSession())
+        throw std::runtime_error("Failed to start log session");
+
+    k_mutex_lock(&mutex_, K_FOREVER);
+
+    // NOTE: Preallocation zero-fills the extent on FAT, so it is only done
+    // ahead by ReserveNextFile. Without a reserved file the next one is
+    // opened without its extent reserved, as it is while the quota can't
+    // be met, so logging goes on.
+    bool is_reserved = is_next_file_reserved_;
+    if(!is_reserved)
+        EnforceQuota(preallocate_size_bytes_);
+    file_index_++;
+    is_next_file_reserved_ = false;
+
+    std::unique_ptr<FsServiceStreamBuf> stream;
+
+    try {
+        stream = std::make_unique<FsServiceStreamBuf>(
+            fs_service_.get(),
+            GetFilePath(file_index_),
+            is_reserved
+                ? FsServiceStreamBuf::OpenMode::ReadWrite
+                : FsServiceStreamBuf::OpenMode::Write);
+
+        if(is_reserved)
+            stream->Preallocate(preallocate_size_bytes_);
+    } catch(...) {
+        k_mutex_unlock(&mutex_);
+        throw;
+    }
+
+    LOG_INF("Opened log file %s.", GetFilePath(file_index_).c_str());
+
+    k_mutex_unlock(&mutex_);
+
+    return stream;
+}
+
+std::string LogFileManager::GetCurrentFilePath() const {
+    if(!session_index_.has_value() || file_index_ == 0)
+        return "";
+
+    return GetFilePath(file_index_);
+}
+
+} // namespace eerie_leap::subsys::fs::services
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <zephyr/kernel.h>
+
+#include "i_fs_service.h"
+#include "fs_service_stream_buf.h"
+
+namespace eerie_leap::subsys::fs::services {
+
+// Hands out log files of a logging session. Sessions are numbered
+// directories of numbered files, e.g. logs/0003/0012.mf4.
+// Files are created with their extent reserved up front, so cluster
+// allocation and FAT updates don't happen while logging, unused space is
+// released once the file is closed. ReserveNextFile creates the next file
+// ahead, off the logging thread, so rotation only has to open it. Files
+// opened without one reserved ahead are not preallocated.
+// With a quota set, oldest sessions are deleted until the next file fits,
+// the current session is never deleted.
+class LogFileManager {
+private:
+    std::shared_ptr<IFsService> fs_service_;
+    std::string directory_;
+    std::string extension_;
+    size_t preallocate_size_bytes_;
+    uint64_t quota_bytes_;
+
+    std::optional<uint32_t> session_index_;
+    uint32_t file_index_;
+    bool is_next_file_reserved_;
+
+    k_mutex mutex_;
+
+    std::string GetSessionPath(uint32_t session_index) const;
+    std::string GetFilePath(uint32_t file_index) const;
+    std::vector<uint32_t> ListSessionIndexes() const;
+    uint64_t GetSessionSize(uint32_t session_index) const;
+    bool DeleteSession(uint32_t session_index);
+    bool EnforceQuota(uint64_t required_bytes);
+    bool ReserveNextFileLocked();
+
+public:
+    LogFileManager(
+        std::shared_ptr<IFsService> fs_service,
+        std::string directory,
+        std::string extension,
+        size_t preallocate_size_bytes = CONFIG_EERIE_LEAP_FS_LOG_PREALLOCATE_SIZE_KB * 1024,
+        uint64_t quota_bytes = static_cast<uint64_t>(CONFIG_EERIE_LEAP_FS_LOG_QUOTA_MB) * 1024 * 1024);
+
+    LogFileManager(const LogFileManager&) = delete;
+    LogFileManager& operator=(const LogFileManager&) = delete;
+
+    // Creates the directory of the session numbered after the last one
+    bool StartSession();
+    std::optional<uint32_t> GetSessionIndex() const { return session_index_; }
+    // Relative paths of session directories, oldest first
+    std::vector<std::string> ListSessions() const;
+
+    bool ReserveNextFile();
+    // Opens the next file of the session for writing, starting a session
+    // if there is none. Throws if the file can't be opened.
+    std::unique_ptr<FsServiceStreamBuf> OpenNextFile();
+    std::string GetCurrentFilePath() const;
+};
+
+} // namespace eerie_leap::subsys::fs::services
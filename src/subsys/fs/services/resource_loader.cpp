@@ -0,0 +1,190 @@
+#include <algorithm>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "subsys/threading/work_queue_thread.h"
+#include "subsys/threading/work_queue_load_balancer.h"
+
+#include "resource_loader.h"
+
+namespace eerie_leap::subsys::fs::services {
+
+using namespace eerie_leap::subsys::threading;
+
+LOG_MODULE_REGISTER(resource_loader_logger);
+
+ResourceLoader::ResourceLoader(
+    std::shared_ptr<IFsService> fs_service,
+    std::string name,
+    size_t worker_count,
+    size_t pending_count,
+    std::pmr::memory_resource* mr)
+        : fs_service_(std::move(fs_service)),
+        name_(std::move(name)),
+        worker_count_(std::max<size_t>(worker_count, 1)),
+        pending_count_(std::max<size_t>(pending_count, 1)),
+        mr_(mr),
+        total_time_ms_(0) {}
+
+void ResourceLoader::Add(std::string_view relative_path, ResourceParser parser) {
+    auto resource = std::make_unique<Resource>(Resource{
+        .path = std::string(relative_path),
+        .parser = std::move(parser),
+        .content = std::pmr::vector<uint8_t>(mr_),
+        .timing = {
+            .path = std::string(relative_path),
+            .size_bytes = 0,
+            .read_time_ms = 0,
+            .parse_time_ms = 0,
+            .is_loaded = false },
+        .error = nullptr });
+
+    resources_.push_back(std::move(resource));
+}
+
+bool ResourceLoader::Read(Resource& resource) {
+    int64_t start_time = k_uptime_get();
+
+    if(!fs_service_->Exists(resource.path))
+        return false;
+
+    size_t size = fs_service_->GetFileSize(resource.path);
+    resource.content.resize(size);
+
+    size_t out_len = 0;
+    if(size != 0 && !fs_service_->ReadFile(resource.path, resource.content.data(), size, out_len)) {
+        LOG_ERR("Failed to read %s.", resource.path.c_str());
+        return false;
+    }
+
+    resource.content.resize(out_len);
+    resource.timing.size_bytes = out_len;
+    resource.timing.read_time_ms = static_cast<uint32_t>(k_uptime_get() - start_time);
+
+    return true;
+}
+
+void ResourceLoader::Parse(Resource& resource) {
+    int64_t start_time = k_uptime_get();
+
+    try {
+        resource.parser(resource.content);
+        resource.timing.is_loaded = true;
+    } catch(...) {
+        resource.error = std::current_exception();
+    }
+
+    resource.timing.parse_time_ms = static_cast<uint32_t>(k_uptime_get() - start_time);
+
+    resource.content.clear();
+    resource.content.shrink_to_fit();
+}
+
+void ResourceLoader::Load() {
+    timings_.clear();
+    total_time_ms_ = 0;
+
+    if(resources_.empty())
+        return;
+
+    int64_t start_time = k_uptime_get();
+
+    if(fs_service_ != nullptr && fs_service_->IsAvailable()) {
+        // Bounds memory taken by files read but not parsed yet
+        k_sem pending_sem;
+        k_sem_init(&pending_sem, pending_count_, pending_count_);
+        k_sem parsed_sem;
+        k_sem_init(&parsed_sem, 0, K_SEM_MAX_LIMIT);
+
+        // Workers are owned by the balancer and stopped along with it
+        WorkQueueLoadBalancer load_balancer;
+
+        size_t worker_count = std::min(worker_count_, resources_.size());
+        for(size_t i = 0; i < worker_count; i++) {
+            auto worker = std::make_shared<WorkQueueThread>(
+                name_ + "_loader_" + std::to_string(i),
+                k_stack_size_,
+                k_priority_);
+            worker->Initialize();
+
+            load_balancer.AddThread(std::move(worker));
+        }
+
+        size_t submitted_count = 0;
+        for(auto& resource : resources_) {
+            k_sem_take(&pending_sem, K_FOREVER);
+
+            if(!Read(*resource)) {
+                k_sem_give(&pending_sem);
+                continue;
+            }
+
+            auto worker = load_balancer.GetLeastLoadedQueue();
+            worker->Run([&load_balancer, &pending_sem, &parsed_sem, resource = resource.get(), worker = worker.get()]() {
+                Parse(*resource);
+
+                load_balancer.OnWorkComplete(*worker, resource->timing.parse_time_ms);
+                k_sem_give(&pending_sem);
+                k_sem_give(&parsed_sem);
+            });
+
+            submitted_count++;
+        }
+
+        for(size_t i = 0; i < submitted_count; i++)
+            k_sem_take(&parsed_sem, K_FOREVER);
+    }
+
+    total_time_ms_ = static_cast<uint32_t>(k_uptime_get() - start_time);
+
+    std::exception_ptr error = nullptr;
+    timings_.reserve(resources_.size());
+
+    for(auto& resource : resources_) {
+        timings_.push_back(std::move(resource->timing));
+
+        if(error == nullptr && resource->error != nullptr)
+            error = resource->error;
+    }
+
+    resources_.clear();
+
+    LogTimings();
+
+    if(error != nullptr)
+        std::rethrow_exception(error);
+}
+
+void ResourceLoader::LogTimings() const {
+    uint32_t read_time_ms = 0;
+    uint32_t parse_time_ms = 0;
+    size_t size_bytes = 0;
+
+    for(const auto& timing : timings_) {
+        if(!timing.is_loaded) {
+            LOG_INF("%s: not loaded", timing.path.c_str());
+            continue;
+        }
+
+        LOG_INF("%s: %zu bytes, read %u ms, parse %u ms",
+            timing.path.c_str(),
+            timing.size_bytes,
+            timing.read_time_ms,
+            timing.parse_time_ms);
+
+        read_time_ms += timing.read_time_ms;
+        parse_time_ms += timing.parse_time_ms;
+        size_bytes += timing.size_bytes;
+    }
+
+    LOG_INF("Loaded %s resources in %u ms, %zu files, %zu bytes, read %u ms, parse %u ms.",
+        name_.c_str(),
+        total_time_ms_,
+        timings_.size(),
+        size_bytes,
+        read_time_ms,
+        parse_time_ms);
+}
+
+} // namespace eerie_leap::subsys::fs::services
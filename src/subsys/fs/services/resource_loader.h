@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "utilities/memory/memory_resource_manager.h"
+#include "i_fs_service.h"
+
+namespace eerie_leap::subsys::fs::services {
+
+using namespace eerie_leap::utilities::memory;
+
+struct ResourceLoadTiming {
+    std::string path;
+    size_t size_bytes;
+    uint32_t read_time_ms;
+    uint32_t parse_time_ms;
+    bool is_loaded;
+};
+
+// Called on a worker thread, content is released once it returns
+using ResourceParser = std::function<void(std::span<const uint8_t> content)>;
+
+// Loads files referenced by configuration, e.g. scripts and DBC files.
+// Files are read one after another on the calling thread, as the card
+// serves a single request at a time, while files already read are parsed
+// on a pool of workers, so reading and parsing overlap.
+// NOTE: Parsers of different resources run concurrently, they shouldn't
+// share state unless it is synchronized.
+class ResourceLoader {
+private:
+    struct Resource {
+        std::string path;
+        ResourceParser parser;
+        std::pmr::vector<uint8_t> content;
+        ResourceLoadTiming timing;
+        std::exception_ptr error;
+    };
+
+    static constexpr int k_stack_size_ = CONFIG_EERIE_LEAP_FS_RESOURCE_LOADER_STACK_SIZE;
+    static constexpr int k_priority_ = CONFIG_EERIE_LEAP_FS_RESOURCE_LOADER_PRIORITY;
+
+    std::shared_ptr<IFsService> fs_service_;
+    std::string name_;
+    size_t worker_count_;
+    size_t pending_count_;
+    std::pmr::memory_resource* mr_;
+
+    std::vector<std::unique_ptr<Resource>> resources_;
+    std::vector<ResourceLoadTiming> timings_;
+    uint32_t total_time_ms_;
+
+    bool Read(Resource& resource);
+    static void Parse(Resource& resource);
+
+public:
+    ResourceLoader(
+        std::shared_ptr<IFsService> fs_service,
+        std::string name,
+        size_t worker_count = CONFIG_EERIE_LEAP_FS_RESOURCE_LOADER_WORKERS,
+        size_t pending_count = CONFIG_EERIE_LEAP_FS_RESOURCE_LOADER_PENDING,
+        std::pmr::memory_resource* mr = Mrm::GetExtPmr());
+
+    ResourceLoader(const ResourceLoader&) = delete;
+    ResourceLoader& operator=(const ResourceLoader&) = delete;
+
+    // Resources are read in the order added, missing files are skipped
+    void Add(std::string_view relative_path, ResourceParser parser);
+    // Blocks until all resources are parsed, rethrows the first
+    // exception thrown by a parser
+    void Load();
+
+    const std::vector<ResourceLoadTiming>& GetTimings() const { return timings_; }
+    uint32_t GetTotalTimeMs() const { return total_time_ms_; }
+    void LogTimings() const;
+};
+
+} // namespace eerie_leap::subsys::fs::services
@@ -0,0 +1,51 @@
+#include <filesystem>
+#include <memory_resource>
+#include <vector>
+
+#include <zephyr/fs/fs.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/crc.h>
+
+#include "utilities/memory/memory_resource_manager.h"
+#include "fs_checksum.h"
+
+namespace eerie_leap::subsys::fs::utilities {
+
+LOG_MODULE_REGISTER(fs_checksum_logger);
+
+using namespace eerie_leap::utilities::memory;
+
+std::optional<uint32_t> FsChecksum::GetFileChecksum(IFsService& fs_service, std::string_view relative_path) {
+    if(!fs_service.IsAvailable())
+        return std::nullopt;
+
+    std::filesystem::path full_path(fs_service.GetMountpoint().mnt_point);
+    full_path /= relative_path;
+
+    struct fs_file_t file;
+    fs_file_t_init(&file);
+
+    int rc = fs_open(&file, full_path.string().c_str(), FS_O_READ);
+    if(rc < 0) {
+        LOG_ERR("Failed to open %s: %d.", full_path.string().c_str(), rc);
+        return std::nullopt;
+    }
+
+    std::pmr::vector<uint8_t> chunk(CHUNK_SIZE, Mrm::GetExtPmr());
+    uint32_t crc = 0;
+    ssize_t read = 0;
+
+    while((read = fs_read(&file, chunk.data(), chunk.size())) > 0)
+        crc = crc32_ieee_update(crc, chunk.data(), static_cast<size_t>(read));
+
+    fs_close(&file);
+
+    if(read < 0) {
+        LOG_ERR("Failed to read %s: %d.", full_path.string().c_str(), static_cast<int>(read));
+        return std::nullopt;
+    }
+
+    return crc;
+}
+
+} // namespace eerie_leap::subsys::fs::utilities
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "subsys/fs/services/i_fs_service.h"
+
+namespace eerie_leap::subsys::fs::utilities {
+
+using namespace eerie_leap::subsys::fs::services;
+
+// CRC32 (IEEE) of file content, read in chunks, so files of any size
+// only take a chunk of memory.
+class FsChecksum {
+private:
+    static constexpr size_t CHUNK_SIZE = 1024;
+
+public:
+    // Returns std::nullopt if the FS is unavailable or the file can't be read
+    static std::optional<uint32_t> GetFileChecksum(IFsService& fs_service, std::string_view relative_path);
+};
+
+} // namespace eerie_leap::subsys::fs::utilities
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <memory>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "subsys/fs/services/fs_service_stream_buf.h"
+#include "fs_stream_benchmark.h"
+
+namespace eerie_leap::subsys::fs::utilities {
+
+LOG_MODULE_REGISTER(fs_stream_benchmark_logger);
+
+FsStreamBenchmarkResult FsStreamBenchmark::RunOne(
+    IFsService& fs_service,
+    const std::string& relative_path,
+    size_t total_size_bytes,
+    size_t chunk_size,
+    size_t buffer_size) {
+
+    std::vector<char> chunk(chunk_size);
+    for(size_t i = 0; i < chunk.size(); i++)
+        chunk[i] = static_cast<char>(i);
+
+    FsStreamBenchmarkResult result = {
+        .buffer_size = buffer_size,
+        .chunk_size = chunk_size,
+        .write_time_ms = 0,
+        .read_time_ms = 0,
+        .write_kbps = 0,
+        .read_kbps = 0
+    };
+
+    int64_t start_time_ms = k_uptime_get();
+    {
+        FsServiceStreamBuf stream(&fs_service, relative_path, FsServiceStreamBuf::OpenMode::Write, buffer_size);
+
+        for(size_t written = 0; written < total_size_bytes; written += chunk_size)
+            stream.sputn(chunk.data(), std::min(chunk_size, total_size_bytes - written));
+
+        stream.pubsync();
+    }
+    result.write_time_ms = static_cast<uint32_t>(k_uptime_get() - start_time_ms);
+
+    start_time_ms = k_uptime_get();
+    {
+        FsServiceStreamBuf stream(&fs_service, relative_path, FsServiceStreamBuf::OpenMode::Read, buffer_size);
+
+        while(stream.sgetn(chunk.data(), chunk_size) > 0) {}
+    }
+    result.read_time_ms = static_cast<uint32_t>(k_uptime_get() - start_time_ms);
+
+    result.write_kbps = static_cast<uint32_t>(total_size_bytes / std::max<uint32_t>(result.write_time_ms, 1));
+    result.read_kbps = static_cast<uint32_t>(total_size_bytes / std::max<uint32_t>(result.read_time_ms, 1));
+
+    return result;
+}
+
+std::vector<FsStreamBenchmarkResult> FsStreamBenchmark::Run(
+    IFsService& fs_service,
+    const std::string& relative_path,
+    size_t total_size_bytes,
+    std::span<const size_t> chunk_sizes,
+    std::span<const size_t> buffer_sizes) {
+
+    std::vector<FsStreamBenchmarkResult> results;
+
+    for(size_t chunk_size : chunk_sizes) {
+        if(chunk_size == 0)
+            continue;
+
+        for(size_t buffer_size : buffer_sizes) {
+            try {
+                results.push_back(RunOne(fs_service, relative_path, total_size_bytes, chunk_size, buffer_size));
+            } catch(const std::exception& e) {
+                LOG_ERR("FS stream benchmark failed: %s", e.what());
+            }
+        }
+    }
+
+    fs_service.DeleteFile(relative_path);
+
+    return results;
+}
+
+void FsStreamBenchmark::Print(std::span<const FsStreamBenchmarkResult> results) {
+    LOG_INF("FS stream benchmark, buffer / chunk: write, read");
+
+    for(const auto& result : results) {
+        LOG_INF("  %6zu / %5zu B: %6u KB/s (%u ms), %6u KB/s (%u ms)",
+            result.buffer_size,
+            result.chunk_size,
+            result.write_kbps,
+            result.write_time_ms,
+            result.read_kbps,
+            result.read_time_ms);
+    }
+}
+
+} // namespace eerie_leap::subsys::fs::utilities
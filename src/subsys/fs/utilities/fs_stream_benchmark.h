@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "subsys/fs/services/i_fs_service.h"
+
+namespace eerie_leap::subsys::fs::utilities {
+
+using namespace eerie_leap::subsys::fs::services;
+
+struct FsStreamBenchmarkResult {
+    size_t buffer_size;
+    size_t chunk_size;
+    uint32_t write_time_ms;
+    uint32_t read_time_ms;
+    uint32_t write_kbps;
+    uint32_t read_kbps;
+};
+
+// Measures FsServiceStreamBuf throughput, e.g. on native_sim's host backed
+// FS. A file is written in chunks and read back for every buffer and chunk
+// size pair, buffer size 0 writes through as streams did unbuffered.
+class FsStreamBenchmark {
+private:
+    static FsStreamBenchmarkResult RunOne(
+        IFsService& fs_service,
+        const std::string& relative_path,
+        size_t total_size_bytes,
+        size_t chunk_size,
+        size_t buffer_size);
+
+public:
+    static std::vector<FsStreamBenchmarkResult> Run(
+        IFsService& fs_service,
+        const std::string& relative_path,
+        size_t total_size_bytes,
+        std::span<const size_t> chunk_sizes,
+        std::span<const size_t> buffer_sizes);
+
+    static void Print(std::span<const FsStreamBenchmarkResult> results);
+};
+
+} // namespace eerie_leap::subsys::fs::utilities
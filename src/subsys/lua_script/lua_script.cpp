@@ -36,7 +36,7 @@ LuaScript LuaScript::CreateExt() {
     return {lua_newstate(ExtMemoryAllocator, nullptr)};
 }
 
-void LuaScript::Load(const std::span<const uint8_t>& script) {
+void LuaScript::Load(const std::span<const uint8_t>& script, std::pmr::vector<uint8_t>* bytecode) {
 	if(state_ == nullptr) {
 		LOG_ERR("Cannot load script: Lua state is null");
 		return;
@@ -49,6 +49,16 @@ void LuaScript::Load(const std::span<const uint8_t>& script) {
 		return;
 	}
 
+	// NOTE: Debug information is stripped, errors of scripts loaded from
+	// bytecode don't report line numbers.
+	if(bytecode != nullptr) {
+		bytecode->clear();
+		if(lua_dump(state_, DumpWriter, bytecode, 1) != 0) {
+			LOG_ERR("Failed to dump script bytecode.");
+			bytecode->clear();
+		}
+	}
+
 	if(lua_pcall(state_, 0, 0, 0) != LUA_OK) {
 		LOG_ERR("Error executing script: %s", lua_tostring(state_, -1));
 		lua_pop(state_, 1);
@@ -56,6 +66,15 @@ void LuaScript::Load(const std::span<const uint8_t>& script) {
 	}
 }
 
+int LuaScript::DumpWriter(lua_State *state, const void* data, size_t size, void* user_data) {
+	auto* bytecode = static_cast<std::pmr::vector<uint8_t>*>(user_data);
+	auto* bytes = static_cast<const uint8_t*>(data);
+
+	bytecode->insert(bytecode->end(), bytes, bytes + size);
+
+	return 0;
+}
+
 void LuaScript::RegisterGlobalFunction(const std::string& name, lua_CFunction func, void* object) {
 	global_functions_.insert({name, func});
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <memory_resource>
 #include <string>
 #include <vector>
 #include <span>
@@ -18,6 +19,7 @@ private:
 
     static int sleep_ms_func(lua_State *state);
     static int print_func(lua_State *state);
+    static int DumpWriter(lua_State *state, const void* data, size_t size, void* user_data);
 
     static const luaL_Reg lua_std_libs_[];
     static const luaL_Reg static_global_functions_[];
@@ -44,7 +46,9 @@ public:
     static LuaScript CreateExt();
 
     lua_State* GetState() { return state_; }
-    void Load(const std::span<const uint8_t>& script);
+    // Script may be source or bytecode. Compiled chunk is dumped into
+    // bytecode when given, loading it later skips parsing the source.
+    void Load(const std::span<const uint8_t>& script, std::pmr::vector<uint8_t>* bytecode = nullptr);
     void RegisterGlobalFunction(const std::string& name, lua_CFunction func, void* object = nullptr);
 
     size_t GetMemoryUsedKb() const;
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace eerie_leap::subsys::mdf {
+
+struct Mdf4DataBlockInfo {
+    uint64_t address;
+    uint64_t size_bytes;
+    // Record bytes held by the block, before compression
+    uint64_t data_size_bytes;
+    uint32_t writer_id;
+};
+
+enum class Mdf4CompressionType : uint8_t {
+    None,
+    Deflate,
+    // NOTE: Requires record_size_bytes, bytes of equal record offset are
+    // grouped before deflate, which suits fixed length records.
+    TranspositionDeflate
+};
+
+struct Mdf4BlockOptions {
+    // Tags the block, so writers of different data groups can share one sink
+    uint32_t writer_id = 0;
+    Mdf4CompressionType compression = Mdf4CompressionType::None;
+    uint32_t record_size_bytes = 0;
+};
+
+// Destination for DT blocks built by Mdf4RecordWriter.
+// Buffers are owned by the sink, the writer fills a buffer past the block
+// header and hands it back, the sink completes the header and writes it.
+// NOTE: Writer ID is written in a trailer right after the block, outside
+// of it, so blocks can be assigned to their data group when recovering
+// a file. The last BLOCK_TRAILER_SIZE bytes of a buffer are left for it.
+class IMdf4BlockSink {
+public:
+    static constexpr size_t BLOCK_HEADER_SIZE = 24;
+    static constexpr size_t BLOCK_TRAILER_SIZE = 8;
+    static constexpr char BLOCK_TRAILER_ID[4] = { 'E', 'L', 'W', 'R' };
+
+    virtual ~IMdf4BlockSink() = default;
+
+    virtual size_t GetBufferSize() const = 0;
+    // Each writer holds at most one acquired buffer, so the sink keeps
+    // enough buffers for writer_count writers acquiring at once.
+    virtual void ReserveBuffers(size_t writer_count) = 0;
+    virtual uint8_t* AcquireBuffer() = 0;
+    // NOTE: size_bytes includes BLOCK_HEADER_SIZE, buffer is owned by
+    // the sink again after the call.
+    virtual void SubmitBuffer(uint8_t* buffer, size_t size_bytes, const Mdf4BlockOptions& options) = 0;
+    virtual void Flush() = 0;
+
+    virtual uint64_t GetStreamAddress() const = 0;
+    virtual std::vector<Mdf4DataBlockInfo> GetDataBlocks() const = 0;
+
+    // Blocks of the writer get linked from DL blocks written as data grows,
+    // link_address is the already written link the first DL is patched into.
+    virtual void EnableDataList(uint32_t writer_id, uint64_t link_address) = 0;
+    // Writes DL blocks for blocks not yet listed
+    virtual void FlushDataLists() = 0;
+};
+
+} // namespace eerie_leap::subsys::mdf
@@ -2,8 +2,11 @@
 
 #include <cstdint>
 #include <memory>
+#include <streambuf>
 #include <vector>
 
+#include "subsys/mdf/utilities/block_stream_writer.h"
+
 namespace eerie_leap::subsys::mdf {
 
 class ISerializableBlock {
@@ -11,10 +14,13 @@ public:
     virtual ~ISerializableBlock() = default;
 
     virtual uint64_t GetBlockSize() const = 0;
+    virtual void WriteTo(utilities::BlockStreamWriter& writer) const = 0;
     virtual std::unique_ptr<uint8_t[]> Serialize() const = 0;
     virtual uint64_t WriteToStream(std::streambuf& stream) = 0;
     virtual uint64_t GetAddress() const = 0;
+    virtual void SetAddress(uint64_t address) = 0;
     virtual bool IsSerialized() const = 0;
+    virtual void SetSerialized(bool is_serialized) = 0;
     virtual void Reset() = 0;
     virtual uint64_t ResolveAddress(uint64_t parent_address) = 0;
 
@@ -21,7 +21,7 @@ public:
 
     std::string GetId() const override;
     uint64_t GetBaseSize() const;
-    std::unique_ptr<uint8_t[]> SerializeBase() const;
+    void WriteBase(BlockStreamWriter& writer) const;
     const IBlockLinks* GetBlockLinks() const override;
 };
 
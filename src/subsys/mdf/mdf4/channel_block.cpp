@@ -86,61 +86,26 @@ uint64_t ChannelBlock::GetBlockSize() const {
     return GetBaseSize() + 1 + 1 + 1 + 1 + 4 + 4 + 4 + 4 + 1 + 1 + 2 + 8 + 8 + 8 + 8 + 8 + 8;
 }
 
-std::unique_ptr<uint8_t[]> ChannelBlock::Serialize() const {
-    auto buffer = SerializeBase();
-    uint64_t offset = GetBaseSize();
-
-    std::memcpy(buffer.get() + offset, &type_, sizeof(uint8_t));
-    offset += sizeof(uint8_t);
-
-    std::memcpy(buffer.get() + offset, &sync_type_, sizeof(uint8_t));
-    offset += sizeof(uint8_t);
-
-    std::memcpy(buffer.get() + offset, &data_type_, sizeof(uint8_t));
-    offset += sizeof(uint8_t);
-
-    std::memcpy(buffer.get() + offset, &bit_offset_, sizeof(bit_offset_));
-    offset += sizeof(bit_offset_);
-
-    std::memcpy(buffer.get() + offset, &byte_offset_, sizeof(byte_offset_));
-    offset += sizeof(byte_offset_);
-
-    std::memcpy(buffer.get() + offset, &bit_count_, sizeof(bit_count_));
-    offset += sizeof(bit_count_);
-
-    std::memcpy(buffer.get() + offset, &flags_, sizeof(flags_));
-    offset += sizeof(flags_);
-
-    std::memcpy(buffer.get() + offset, &invalidation_bit_pos_, sizeof(invalidation_bit_pos_));
-    offset += sizeof(invalidation_bit_pos_);
-
-    std::memcpy(buffer.get() + offset, &precision_, sizeof(precision_));
-    offset += sizeof(precision_);
-
-    offset += 1; // reserved_1_
-
-    std::memcpy(buffer.get() + offset, &attachment_count_, sizeof(attachment_count_));
-    offset += sizeof(attachment_count_);
-
-    std::memcpy(buffer.get() + offset, &val_range_min_, sizeof(val_range_min_));
-    offset += sizeof(val_range_min_);
-
-    std::memcpy(buffer.get() + offset, &val_range_max_, sizeof(val_range_max_));
-    offset += sizeof(val_range_max_);
-
-    std::memcpy(buffer.get() + offset, &limit_min_, sizeof(limit_min_));
-    offset += sizeof(limit_min_);
-
-    std::memcpy(buffer.get() + offset, &limit_max_, sizeof(limit_max_));
-    offset += sizeof(limit_max_);
-
-    std::memcpy(buffer.get() + offset, &limit_ext_min_, sizeof(limit_ext_min_));
-    offset += sizeof(limit_ext_min_);
-
-    std::memcpy(buffer.get() + offset, &limit_ext_max_, sizeof(limit_ext_max_));
-    offset += sizeof(limit_ext_max_);
-
-    return buffer;
+void ChannelBlock::WriteTo(BlockStreamWriter& writer) const {
+    WriteBase(writer);
+
+    writer.WriteValue(type_);
+    writer.WriteValue(sync_type_);
+    writer.WriteValue(data_type_);
+    writer.WriteValue(bit_offset_);
+    writer.WriteValue(byte_offset_);
+    writer.WriteValue(bit_count_);
+    writer.WriteValue(flags_);
+    writer.WriteValue(invalidation_bit_pos_);
+    writer.WriteValue(precision_);
+    writer.WriteZeros(1); // reserved_1_
+    writer.WriteValue(attachment_count_);
+    writer.WriteValue(val_range_min_);
+    writer.WriteValue(val_range_max_);
+    writer.WriteValue(limit_min_);
+    writer.WriteValue(limit_max_);
+    writer.WriteValue(limit_ext_min_);
+    writer.WriteValue(limit_ext_max_);
 }
 
 } // namespace eerie_leap::subsys::mdf::mdf4
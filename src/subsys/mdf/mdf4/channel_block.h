@@ -99,12 +99,12 @@ private:
     uint8_t precision_;                 // 1 byte, Precision
     // uint8_t reserved_1_[1];          // 1 bytes, Reserved
     uint16_t attachment_count_;         // 2 bytes, Number of attachments
-    float val_range_min_;               // 8 bytes, Minimum value of raw range
-    float val_range_max_;               // 8 bytes, Maximum value of raw range
-    float limit_min_;                   // 8 bytes, Lower limit
-    float limit_max_;                   // 8 bytes, Upper limit
-    float limit_ext_min_;               // 8 bytes, Lower extended limit
-    float limit_ext_max_;               // 8 bytes, Upper extended limit
+    double val_range_min_;              // 8 bytes, Minimum value of raw range
+    double val_range_max_;              // 8 bytes, Maximum value of raw range
+    double limit_min_;                  // 8 bytes, Lower limit
+    double limit_max_;                  // 8 bytes, Upper limit
+    double limit_ext_min_;              // 8 bytes, Lower extended limit
+    double limit_ext_max_;              // 8 bytes, Upper extended limit
 
 public:
     ChannelBlock(Type type, SyncType sync_type, DataType data_type, uint32_t bit_count);
@@ -116,7 +116,7 @@ public:
     void SetConversion(std::shared_ptr<ChannelConversionBlock> conversion);
 
     uint64_t GetBlockSize() const override;
-    std::unique_ptr<uint8_t[]> Serialize() const override;
+    void WriteTo(BlockStreamWriter& writer) const override;
     const IBlockLinks* GetBlockLinks() const override { return &links_; }
     std::vector<std::shared_ptr<ISerializableBlock>> GetChildren() const override {
         return {
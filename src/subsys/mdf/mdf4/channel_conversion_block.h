@@ -119,7 +119,7 @@ public:
     static ChannelConversionBlock CreateAlgebraicConversion(const std::string& formula);
 
     uint64_t GetBlockSize() const override;
-    std::unique_ptr<uint8_t[]> Serialize() const override;
+    void WriteTo(BlockStreamWriter& writer) const override;
     const IBlockLinks* GetBlockLinks() const override { return &links_; }
     std::vector<std::shared_ptr<ISerializableBlock>> GetChildren() const override {
         return links_.GetLinks();
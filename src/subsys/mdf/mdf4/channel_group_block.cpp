@@ -1,3 +1,4 @@
+#include <cstring>
 #include <set>
 
 #include "text_block.h"
@@ -56,6 +57,13 @@ std::vector<uint8_t> ChannelGroupBlock::GetRecordIdData() const {
     return buffer;
 }
 
+// Little-endian record ID without allocation, returns bytes copied
+size_t ChannelGroupBlock::CopyRecordIdData(uint8_t* buffer) const {
+    std::memcpy(buffer, &record_id_, record_id_size_bytes_);
+
+    return record_id_size_bytes_;
+}
+
 uint32_t ChannelGroupBlock::GetDataSizeBytes() const {
     return data_bytes_;
 }
@@ -113,31 +121,16 @@ uint64_t ChannelGroupBlock::GetBlockSize() const {
     return GetBaseSize() + 8 + 8 + 2 + 2 + 4 + 4 + 4;
 }
 
-std::unique_ptr<uint8_t[]> ChannelGroupBlock::Serialize() const {
-    auto buffer = SerializeBase();
-    uint64_t offset = GetBaseSize();
-
-    std::memcpy(buffer.get() + offset, &record_id_, sizeof(record_id_));
-    offset += sizeof(record_id_);
-
-    std::memcpy(buffer.get() + offset, &cycle_count_, sizeof(cycle_count_));
-    offset += sizeof(cycle_count_);
+void ChannelGroupBlock::WriteTo(BlockStreamWriter& writer) const {
+    WriteBase(writer);
 
-    std::memcpy(buffer.get() + offset, &flags_, sizeof(flags_));
-    offset += sizeof(flags_);
-
-    std::memcpy(buffer.get() + offset, &path_separator_, sizeof(path_separator_));
-    offset += sizeof(path_separator_);
-
-    offset += 4; // reserved_1_
-
-    std::memcpy(buffer.get() + offset, &data_bytes_, sizeof(data_bytes_));
-    offset += sizeof(data_bytes_);
-
-    std::memcpy(buffer.get() + offset, &invalidation_bytes_, sizeof(invalidation_bytes_));
-    offset += sizeof(invalidation_bytes_);
-
-    return buffer;
+    writer.WriteValue(record_id_);
+    writer.WriteValue(cycle_count_);
+    writer.WriteValue(flags_);
+    writer.WriteValue(path_separator_);
+    writer.WriteZeros(4); // reserved_1_
+    writer.WriteValue(data_bytes_);
+    writer.WriteValue(invalidation_bytes_);
 }
 
 
@@ -56,11 +56,19 @@ public:
     uint64_t GetRecordId() const;
     uint8_t GetRecordIdSizeBytes() const;
     std::vector<uint8_t> GetRecordIdData() const;
+    size_t CopyRecordIdData(uint8_t* buffer) const;
     uint32_t GetDataSizeBytes() const;
     std::vector<std::shared_ptr<ChannelBlock>> GetChannels() const;
 
+    // NOTE: Counted as records are written, patched into the
+    // serialized block when the file is finalized.
+    void AddCycles(uint64_t count = 1) { cycle_count_ += count; }
+    uint64_t GetCycleCount() const { return cycle_count_; }
+    void ResetCycleCount() { cycle_count_ = 0; }
+    uint64_t GetCycleCountAddress() const { return GetAddress() + GetBaseSize() + sizeof(record_id_); }
+
     uint64_t GetBlockSize() const override;
-    std::unique_ptr<uint8_t[]> Serialize() const override;
+    void WriteTo(BlockStreamWriter& writer) const override;
     const IBlockLinks* GetBlockLinks() const override { return &links_; }
     std::vector<std::shared_ptr<ISerializableBlock>> GetChildren() const override {
         return {
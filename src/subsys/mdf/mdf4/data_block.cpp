@@ -11,8 +11,9 @@ uint64_t DataBlock::GetBlockSize() const {
     return GetBaseSize() + size_bytes_;
 }
 
-std::unique_ptr<uint8_t[]> DataBlock::Serialize() const {
-    return SerializeBase();
+void DataBlock::WriteTo(BlockStreamWriter& writer) const {
+    WriteBase(writer);
+    writer.WriteZeros(size_bytes_);
 }
 
 } // namespace eerie_leap::subsys::mdf::mdf4
@@ -12,6 +12,11 @@ uint8_t DataGroupBlock::GetRecordIdSizeBytes() const {
     return record_id_size_bytes_;
 }
 
+// Data link is patched to point to a DL block once data is written
+uint64_t DataGroupBlock::GetDataLinkAddress() const {
+    return GetAddress() + GetBaseSize() - GetBlockLinks()->GetLinksSizeBytes() + std::to_underlying(LinkType::Data) * 8;
+}
+
 void DataGroupBlock::AddChannelGroup(std::shared_ptr<ChannelGroupBlock> channel_group) {
     if(links_.GetLink(LinkType::ChannelGroupFirst)) {
         auto channel_group_first = std::dynamic_pointer_cast<ChannelGroupBlock>(links_.GetLink(LinkType::ChannelGroupFirst));
@@ -34,16 +39,11 @@ uint64_t DataGroupBlock::GetBlockSize() const {
     return GetBaseSize() + 1 + 7;
 }
 
-std::unique_ptr<uint8_t[]> DataGroupBlock::Serialize() const {
-    auto buffer = SerializeBase();
-    uint64_t offset = GetBaseSize();
-
-    std::memcpy(buffer.get() + offset, &record_id_size_bytes_, sizeof(record_id_size_bytes_));
-    offset += sizeof(record_id_size_bytes_);
-
-    offset += 7; // reserved_1_
+void DataGroupBlock::WriteTo(BlockStreamWriter& writer) const {
+    WriteBase(writer);
 
-    return buffer;
+    writer.WriteValue(record_id_size_bytes_);
+    writer.WriteZeros(7); // reserved_1_
 }
 
 
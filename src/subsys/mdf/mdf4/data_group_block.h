@@ -33,9 +33,10 @@ public:
     virtual ~DataGroupBlock() = default;
 
     uint8_t GetRecordIdSizeBytes() const;
+    uint64_t GetDataLinkAddress() const;
 
     uint64_t GetBlockSize() const override;
-    std::unique_ptr<uint8_t[]> Serialize() const override;
+    void WriteTo(BlockStreamWriter& writer) const override;
     const IBlockLinks* GetBlockLinks() const override { return &links_; }
     std::vector<std::shared_ptr<ISerializableBlock>> GetChildren() const override {
         return {
@@ -0,0 +1,53 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "data_list_block.h"
+
+namespace eerie_leap::subsys::mdf::mdf4 {
+
+uint64_t DataListBlock::GetBlockSize(size_t block_count) {
+    return 24                       // Block header
+        + 8 + 8 * block_count       // Next link and data links
+        + 1 + 3 + 4                 // Flags, reserved, block count
+        + 8 * block_count;          // Data offsets
+}
+
+uint64_t DataListBlock::Serialize(
+    std::span<const Mdf4DataBlockInfo> data_blocks,
+    uint64_t data_offset,
+    std::span<uint8_t> buffer) {
+
+    const uint64_t size = GetBlockSize(data_blocks.size());
+    if(buffer.size() < size)
+        throw std::runtime_error("Data list exceeds buffer size");
+
+    std::memset(buffer.data(), 0, size);
+
+    uint64_t link_count = 1 + data_blocks.size();
+    std::memcpy(buffer.data(), "##DL", 4);
+    std::memcpy(buffer.data() + 8, &size, sizeof(size));
+    std::memcpy(buffer.data() + 16, &link_count, sizeof(link_count));
+
+    uint64_t offset = NEXT_LINK_OFFSET + 8;
+    for(const auto& data_block : data_blocks) {
+        std::memcpy(buffer.data() + offset, &data_block.address, sizeof(data_block.address));
+        offset += 8;
+    }
+
+    offset += 1; // flags, offsets are listed
+    offset += 3; // reserved_1_
+
+    uint32_t block_count = data_blocks.size();
+    std::memcpy(buffer.data() + offset, &block_count, sizeof(block_count));
+    offset += sizeof(block_count);
+
+    for(const auto& data_block : data_blocks) {
+        std::memcpy(buffer.data() + offset, &data_offset, sizeof(data_offset));
+        data_offset += data_block.data_size_bytes;
+        offset += 8;
+    }
+
+    return size;
+}
+
+} // namespace eerie_leap::subsys::mdf::mdf4
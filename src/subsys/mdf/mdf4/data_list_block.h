@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "subsys/mdf/i_mdf4_block_sink.h"
+
+namespace eerie_leap::subsys::mdf::mdf4 {
+
+// Data list block, links data blocks written by the record writer.
+// Unlike other blocks it references already written blocks by address,
+// so it is serialized straight from the data block info.
+class DataListBlock {
+public:
+    static constexpr uint64_t NEXT_LINK_OFFSET = 24;
+
+    // Fills a block with a link and a data offset per data block,
+    // offsets start at data_offset, next link is left empty.
+    static uint64_t GetBlockSize(size_t block_count);
+    static uint64_t Serialize(
+        std::span<const Mdf4DataBlockInfo> data_blocks,
+        uint64_t data_offset,
+        std::span<uint8_t> buffer);
+};
+
+} // namespace eerie_leap::subsys::mdf::mdf4
@@ -42,6 +42,8 @@ uint64_t DataRecord::WriteToStream(std::streambuf& stream, const std::vector<voi
     if(ret != GetRecordSizeBytes())
         throw std::ios_base::failure("End of stream reached (EOF).");
 
+    channel_group_->AddCycles();
+
     return ret;
 }
 
@@ -62,7 +64,21 @@ uint64_t DataRecord::WriteToStream(std::streambuf& stream, const std::span<uint8
     if(ret != data.size())
         throw std::ios_base::failure("End of stream reached (EOF).");
 
+    channel_group_->AddCycles();
+
     return ret;
 }
 
+uint64_t DataRecord::WriteToWriter(Mdf4RecordWriter& writer, const std::span<const uint8_t>& data) const {
+    uint8_t id_data[8];
+    size_t id_size = channel_group_->CopyRecordIdData(id_data);
+
+    writer.Write({id_data, id_size});
+    writer.Write(data);
+
+    channel_group_->AddCycles();
+
+    return id_size + data.size();
+}
+
 } // namespace eerie_leap::subsys::mdf::mdf4
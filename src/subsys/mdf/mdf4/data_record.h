@@ -5,6 +5,7 @@
 #include <span>
 #include <vector>
 
+#include "subsys/mdf/mdf4_record_writer.h"
 #include "channel_group_block.h"
 
 namespace eerie_leap::subsys::mdf::mdf4 {
@@ -22,6 +23,7 @@ public:
 
     uint64_t WriteToStream(std::streambuf& stream, const std::vector<void*>& values) const;
     uint64_t WriteToStream(std::streambuf& stream, const std::span<uint8_t>& data) const;
+    uint64_t WriteToWriter(Mdf4RecordWriter& writer, const std::span<const uint8_t>& data) const;
 };
 
 } // namespace eerie_leap::subsys::mdf::mdf4
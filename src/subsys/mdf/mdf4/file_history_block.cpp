@@ -35,25 +35,14 @@ uint64_t FileHistoryBlock::GetBlockSize() const {
     return GetBaseSize() + 8 + 2 + 2 + 1 + 3;
 }
 
-std::unique_ptr<uint8_t[]> FileHistoryBlock::Serialize() const {
-    auto buffer = SerializeBase();
-    uint64_t offset = GetBaseSize();
-
-    std::memcpy(buffer.get() + offset, &time_ns_, sizeof(time_ns_));
-    offset += sizeof(time_ns_);
-
-    std::memcpy(buffer.get() + offset, &tz_offset_min_, sizeof(tz_offset_min_));
-    offset += sizeof(tz_offset_min_);
-
-    std::memcpy(buffer.get() + offset, &dst_offset_min_, sizeof(dst_offset_min_));
-    offset += sizeof(dst_offset_min_);
-
-    std::memcpy(buffer.get() + offset, &time_flags_, sizeof(time_flags_));
-    offset += sizeof(time_flags_);
-
-    offset += 3; // reserved_1_
-
-    return buffer;
+void FileHistoryBlock::WriteTo(BlockStreamWriter& writer) const {
+    WriteBase(writer);
+
+    writer.WriteValue(time_ns_);
+    writer.WriteValue(tz_offset_min_);
+    writer.WriteValue(dst_offset_min_);
+    writer.WriteValue(time_flags_);
+    writer.WriteZeros(3); // reserved_1_
 }
 
 
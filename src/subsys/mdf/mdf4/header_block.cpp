@@ -43,37 +43,18 @@ uint64_t HeaderBlock::GetBlockSize() const {
     return GetBaseSize() + 8 + 2 + 2 + 1 + 1 + 1 + 1 + 8 + 8;
 }
 
-std::unique_ptr<uint8_t[]> HeaderBlock::Serialize() const {
-    auto buffer = SerializeBase();
-    uint64_t offset = GetBaseSize();
-
-    std::memcpy(buffer.get() + offset, &start_time_ns_, sizeof(start_time_ns_));
-    offset += sizeof(start_time_ns_);
-
-    std::memcpy(buffer.get() + offset, &tz_offset_min_, sizeof(tz_offset_min_));
-    offset += sizeof(tz_offset_min_);
-
-    std::memcpy(buffer.get() + offset, &dst_offset_min_, sizeof(dst_offset_min_));
-    offset += sizeof(dst_offset_min_);
-
-    std::memcpy(buffer.get() + offset, &time_flags_, sizeof(time_flags_));
-    offset += sizeof(time_flags_);
-
-    std::memcpy(buffer.get() + offset, &time_class_, sizeof(time_class_));
-    offset += sizeof(time_class_);
-
-    std::memcpy(buffer.get() + offset, &flags_, sizeof(flags_));
-    offset += sizeof(flags_);
-
-    offset += 1; // reserved_1_
-
-    std::memcpy(buffer.get() + offset, &hd_start_angle_rad_, sizeof(hd_start_angle_rad_));
-    offset += sizeof(hd_start_angle_rad_);
-
-    std::memcpy(buffer.get() + offset, &hd_distance_m_, sizeof(hd_distance_m_));
-    offset += sizeof(hd_distance_m_);
-
-    return buffer;
+void HeaderBlock::WriteTo(BlockStreamWriter& writer) const {
+    WriteBase(writer);
+
+    writer.WriteValue(start_time_ns_);
+    writer.WriteValue(tz_offset_min_);
+    writer.WriteValue(dst_offset_min_);
+    writer.WriteValue(time_flags_);
+    writer.WriteValue(time_class_);
+    writer.WriteValue(flags_);
+    writer.WriteZeros(1); // reserved_1_
+    writer.WriteValue(hd_start_angle_rad_);
+    writer.WriteValue(hd_distance_m_);
 }
 
 
@@ -41,11 +41,13 @@ public:
     virtual ~IdBlock() = default;
 
     uint64_t GetBlockSize() const override;
-    std::unique_ptr<uint8_t[]> Serialize() const override;
+    void WriteTo(utilities::BlockStreamWriter& writer) const override;
     std::vector<std::shared_ptr<ISerializableBlock>> GetChildren() const override { return {}; }
 
     void AddStandardFlag(StandardFlag flag);
     void ClearStandardFlags();
+    void SetFinalized();
+    bool IsFinalized() const { return is_finalized_; }
 };
 
 } // namespace eerie_leap::subsys::mdf::mdf4
@@ -22,22 +22,13 @@ uint64_t SourceInformationBlock::GetBlockSize() const {
     return GetBaseSize() + 1 + 1 + 1 + 5;
 }
 
-std::unique_ptr<uint8_t[]> SourceInformationBlock::Serialize() const {
-    auto buffer = SerializeBase();
-    uint64_t offset = GetBaseSize();
+void SourceInformationBlock::WriteTo(BlockStreamWriter& writer) const {
+    WriteBase(writer);
 
-    std::memcpy(buffer.get() + offset, &source_type_, sizeof(uint8_t));
-    offset += sizeof(uint8_t);
-
-    std::memcpy(buffer.get() + offset, &bus_type_, sizeof(uint8_t));
-    offset += sizeof(uint8_t);
-
-    std::memcpy(buffer.get() + offset, &flags_, sizeof(flags_));
-    offset += sizeof(flags_);
-
-    offset += 5; // reserved_1_
-
-    return buffer;
+    writer.WriteValue(source_type_);
+    writer.WriteValue(bus_type_);
+    writer.WriteValue(flags_);
+    writer.WriteZeros(5); // reserved_1_
 }
 
 } // namespace eerie_leap::subsys::mdf::mdf4
@@ -19,7 +19,7 @@ public:
     virtual ~TextBlockBase() = default;
 
     uint64_t GetBlockSize() const override;
-    std::unique_ptr<uint8_t[]> Serialize() const override;
+    void WriteTo(BlockStreamWriter& writer) const override;
     std::vector<std::shared_ptr<ISerializableBlock>> GetChildren() const override {
         return {};
     }
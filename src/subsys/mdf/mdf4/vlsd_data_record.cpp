@@ -43,24 +43,27 @@ std::unique_ptr<uint8_t[]> VlsdDataRecord::Create(const std::span<const uint8_t>
 
 std::vector<uint8_t> VlsdDataRecord::GetOffsetData() const {
     std::vector<uint8_t> buffer(offset_channel_size_bytes_);
+    CopyOffsetData(buffer.data());
 
+    return buffer;
+}
+
+void VlsdDataRecord::CopyOffsetData(uint8_t* buffer) const {
     if(offset_channel_size_bytes_ == 1) {
         uint8_t offset = static_cast<uint8_t>(offset_);
-        std::memcpy(buffer.data(), &offset, offset_channel_size_bytes_);
+        std::memcpy(buffer, &offset, offset_channel_size_bytes_);
     } else if(offset_channel_size_bytes_ == 2) {
         uint16_t offset = static_cast<uint16_t>(offset_);
-        std::memcpy(buffer.data(), &offset, offset_channel_size_bytes_);
+        std::memcpy(buffer, &offset, offset_channel_size_bytes_);
     } else if(offset_channel_size_bytes_ == 4) {
         uint32_t offset = static_cast<uint32_t>(offset_);
-        std::memcpy(buffer.data(), &offset, offset_channel_size_bytes_);
+        std::memcpy(buffer, &offset, offset_channel_size_bytes_);
     } else if(offset_channel_size_bytes_ == 8) {
         uint64_t offset = static_cast<uint64_t>(offset_);
-        std::memcpy(buffer.data(), &offset, offset_channel_size_bytes_);
+        std::memcpy(buffer, &offset, offset_channel_size_bytes_);
     } else {
         throw std::runtime_error("Invalid offset size bytes");
     }
-
-    return buffer;
 }
 
 uint64_t VlsdDataRecord::WriteToStream(std::streambuf& stream, const std::span<const uint8_t>& data) {
@@ -75,8 +78,27 @@ uint64_t VlsdDataRecord::WriteToStream(std::streambuf& stream, const std::span<c
         throw std::ios_base::failure("End of stream reached (EOF).");
 
     offset_ += 4 + data.size();
+    vlsd_channel_group_->AddCycles();
 
     return ret;
 }
 
+uint64_t VlsdDataRecord::WriteToWriter(Mdf4RecordWriter& writer, const std::span<const uint8_t>& data) {
+    uint8_t header[8 + sizeof(uint32_t)];
+
+    size_t header_size = vlsd_channel_group_->CopyRecordIdData(header);
+
+    uint32_t data_length = data.size();
+    std::memcpy(header + header_size, &data_length, sizeof(uint32_t));
+    header_size += sizeof(uint32_t);
+
+    writer.Write({header, header_size});
+    writer.Write(data);
+
+    offset_ += 4 + data.size();
+    vlsd_channel_group_->AddCycles();
+
+    return header_size + data.size();
+}
+
 } // namespace eerie_leap::subsys::mdf::mdf4
@@ -5,6 +5,7 @@
 #include <span>
 #include <vector>
 
+#include "subsys/mdf/mdf4_record_writer.h"
 #include "channel_group_block.h"
 
 namespace eerie_leap::subsys::mdf::mdf4 {
@@ -24,7 +25,9 @@ public:
     virtual ~VlsdDataRecord() = default;
     void Reset();
     std::vector<uint8_t> GetOffsetData() const;
+    void CopyOffsetData(uint8_t* buffer) const;
     uint64_t WriteToStream(std::streambuf& stream, const std::span<const uint8_t>& data);
+    uint64_t WriteToWriter(Mdf4RecordWriter& writer, const std::span<const uint8_t>& data);
 };
 
 } // namespace eerie_leap::subsys::mdf::mdf4
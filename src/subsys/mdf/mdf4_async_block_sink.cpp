@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include <zephyr/logging/log.h>
+
+#include "mdf4_async_block_sink.h"
+
+LOG_MODULE_REGISTER(mdf4_async_block_sink_logger);
+
+namespace eerie_leap::subsys::mdf {
+
+Mdf4AsyncBlockSink::Mdf4AsyncBlockSink(
+    std::streambuf& stream,
+    uint64_t stream_address,
+    size_t buffer_size,
+    size_t buffer_count,
+    std::pmr::memory_resource* mr)
+        : stream_sink_(stream, stream_address, buffer_size, mr),
+        mr_(mr),
+        buffer_size_(stream_sink_.GetBufferSize()),
+        buffers_(mr),
+        acquire_timeout_(K_MSEC(CONFIG_EERIE_LEAP_MDF_LOGGER_BUFFER_TIMEOUT_MS)),
+        free_msgq_buffer_(mr),
+        filled_msgq_buffer_(mr),
+        pending_count_(ATOMIC_INIT(0)) {
+
+    k_sem_init(&drained_sem_, 0, 1);
+
+    buffer_count = std::max<size_t>(buffer_count, 2);
+    buffers_.reserve(buffer_count);
+    for(size_t i = 0; i < buffer_count; i++)
+        buffers_.push_back(static_cast<uint8_t*>(mr_->allocate(buffer_size_, Mdf4StreamBlockSink::SECTOR_SIZE)));
+
+    InitializeQueues(buffers_);
+
+    thread_ = std::make_unique<Thread>(
+        "mdf_writer",
+        this,
+        k_stack_size_,
+        k_priority_);
+
+    thread_->Initialize();
+}
+
+Mdf4AsyncBlockSink::~Mdf4AsyncBlockSink() {
+    Stop();
+
+    for(auto* buffer : buffers_)
+        mr_->deallocate(buffer, buffer_size_, Mdf4StreamBlockSink::SECTOR_SIZE);
+}
+
+// Sizes both queues for all buffers, free_buffers are those not held by writers
+void Mdf4AsyncBlockSink::InitializeQueues(std::span<uint8_t* const> free_buffers) {
+    free_msgq_buffer_.resize(buffers_.size());
+    filled_msgq_buffer_.resize(buffers_.size() + 1);
+
+    k_msgq_init(
+        &free_msgq_,
+        reinterpret_cast<char*>(free_msgq_buffer_.data()),
+        sizeof(QueuedBuffer),
+        free_msgq_buffer_.size());
+
+    // NOTE: One extra slot for the stop request
+    k_msgq_init(
+        &filled_msgq_,
+        reinterpret_cast<char*>(filled_msgq_buffer_.data()),
+        sizeof(QueuedBuffer),
+        filled_msgq_buffer_.size());
+
+    for(auto* buffer : free_buffers) {
+        QueuedBuffer queued_buffer = { .buffer = buffer, .size_bytes = 0 };
+        k_msgq_put(&free_msgq_, &queued_buffer, K_NO_WAIT);
+    }
+}
+
+void Mdf4AsyncBlockSink::ReserveBuffers(size_t writer_count) {
+    if(buffers_.size() > writer_count)
+        return;
+
+    if(thread_->IsRunning())
+        throw std::runtime_error("MDF writer thread is running, not enough buffers for all writers");
+
+    std::pmr::vector<uint8_t*> free_buffers(mr_);
+    QueuedBuffer queued_buffer;
+    while(k_msgq_get(&free_msgq_, &queued_buffer, K_NO_WAIT) == 0)
+        free_buffers.push_back(queued_buffer.buffer);
+
+    while(buffers_.size() <= writer_count) {
+        auto* buffer = static_cast<uint8_t*>(mr_->allocate(buffer_size_, Mdf4StreamBlockSink::SECTOR_SIZE));
+        buffers_.push_back(buffer);
+        free_buffers.push_back(buffer);
+    }
+
+    InitializeQueues(free_buffers);
+}
+
+void Mdf4AsyncBlockSink::Start() {
+    if(thread_->IsRunning())
+        return;
+
+    thread_->Start();
+}
+
+void Mdf4AsyncBlockSink::Stop() {
+    if(!thread_->IsRunning())
+        return;
+
+    Flush();
+
+    QueuedBuffer stop_request = { .buffer = nullptr, .size_bytes = 0 };
+    k_msgq_put(&filled_msgq_, &stop_request, K_FOREVER);
+
+    thread_->Join();
+}
+
+uint8_t* Mdf4AsyncBlockSink::AcquireBuffer() {
+    QueuedBuffer queued_buffer;
+
+    if(k_msgq_get(&free_msgq_, &queued_buffer, K_NO_WAIT) != 0) {
+        k_spinlock_key_t key = k_spin_lock(&lock_);
+        stall_count_++;
+        k_spin_unlock(&lock_, key);
+
+        if(k_msgq_get(&free_msgq_, &queued_buffer, acquire_timeout_) != 0)
+            throw std::runtime_error("No MDF record buffer freed by the writer thread in time");
+    }
+
+    uint32_t buffers_in_use = buffers_.size() - k_msgq_num_used_get(&free_msgq_);
+
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+    buffer_high_water_mark_ = std::max(buffer_high_water_mark_, buffers_in_use);
+    k_spin_unlock(&lock_, key);
+
+    return queued_buffer.buffer;
+}
+
+void Mdf4AsyncBlockSink::SubmitBuffer(uint8_t* buffer, size_t size_bytes, const Mdf4BlockOptions& options) {
+    if(!thread_->IsRunning())
+        throw std::runtime_error("MDF writer thread is not running");
+
+    atomic_inc(&pending_count_);
+
+    QueuedBuffer queued_buffer = { .buffer = buffer, .size_bytes = size_bytes, .options = options };
+    k_msgq_put(&filled_msgq_, &queued_buffer, K_FOREVER);
+}
+
+void Mdf4AsyncBlockSink::Flush() {
+    while(atomic_get(&pending_count_) > 0)
+        k_sem_take(&drained_sem_, K_FOREVER);
+}
+
+void Mdf4AsyncBlockSink::EnableDataList(uint32_t writer_id, uint64_t link_address) {
+    if(thread_->IsRunning())
+        throw std::runtime_error("MDF writer thread is running");
+
+    stream_sink_.EnableDataList(writer_id, link_address);
+}
+
+// Writer thread is idle once flushed, as long as nothing else is submitted
+void Mdf4AsyncBlockSink::FlushDataLists() {
+    Flush();
+    stream_sink_.FlushDataLists();
+}
+
+void Mdf4AsyncBlockSink::ThreadEntry() {
+    QueuedBuffer queued_buffer;
+
+    while(true) {
+        k_msgq_get(&filled_msgq_, &queued_buffer, K_FOREVER);
+
+        if(queued_buffer.buffer == nullptr)
+            break;
+
+        uint32_t start_cycles = k_cycle_get_32();
+        bool is_written = true;
+
+        try {
+            stream_sink_.WriteBlock(queued_buffer.buffer, queued_buffer.size_bytes, queued_buffer.options);
+        } catch(const std::exception& e) {
+            LOG_ERR("Failed to write MDF data block: %s", e.what());
+            is_written = false;
+        }
+
+        uint32_t latency_us = k_cyc_to_us_floor32(k_cycle_get_32() - start_cycles);
+
+        k_spinlock_key_t key = k_spin_lock(&lock_);
+
+        if(is_written) {
+            blocks_written_++;
+            bytes_written_ += queued_buffer.size_bytes;
+            flush_latency_sum_us_ += latency_us;
+            flush_latency_min_us_ = std::min(flush_latency_min_us_, latency_us);
+            flush_latency_max_us_ = std::max(flush_latency_max_us_, latency_us);
+        } else {
+            write_error_count_++;
+        }
+
+        k_spin_unlock(&lock_, key);
+
+        queued_buffer.size_bytes = 0;
+        k_msgq_put(&free_msgq_, &queued_buffer, K_NO_WAIT);
+
+        if(atomic_dec(&pending_count_) == 1)
+            k_sem_give(&drained_sem_);
+    }
+}
+
+Mdf4AsyncBlockSinkStatistics Mdf4AsyncBlockSink::GetStatistics() {
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+
+    Mdf4AsyncBlockSinkStatistics statistics = {
+        .buffer_count = static_cast<uint32_t>(buffers_.size()),
+        .buffer_high_water_mark = buffer_high_water_mark_,
+        .stall_count = stall_count_,
+        .write_error_count = write_error_count_,
+        .blocks_written = blocks_written_,
+        .bytes_written = bytes_written_,
+        .flush_latency_min_us = blocks_written_ > 0 ? flush_latency_min_us_ : 0,
+        .flush_latency_mean_us = blocks_written_ > 0
+            ? static_cast<uint32_t>(flush_latency_sum_us_ / blocks_written_)
+            : 0,
+        .flush_latency_max_us = flush_latency_max_us_
+    };
+
+    k_spin_unlock(&lock_, key);
+
+    return statistics;
+}
+
+void Mdf4AsyncBlockSink::ResetStatistics() {
+    k_spinlock_key_t key = k_spin_lock(&lock_);
+
+    buffer_high_water_mark_ = 0;
+    stall_count_ = 0;
+    write_error_count_ = 0;
+    blocks_written_ = 0;
+    bytes_written_ = 0;
+    flush_latency_min_us_ = UINT32_MAX;
+    flush_latency_max_us_ = 0;
+    flush_latency_sum_us_ = 0;
+
+    k_spin_unlock(&lock_, key);
+
+    stream_sink_.ResetCompressionStatistics();
+}
+
+} // namespace eerie_leap::subsys::mdf
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <streambuf>
+#include <vector>
+
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+#include <zephyr/sys/atomic.h>
+
+#include "utilities/memory/memory_resource_manager.h"
+#include "subsys/threading/thread.h"
+#include "i_mdf4_block_sink.h"
+#include "mdf4_stream_block_sink.h"
+
+namespace eerie_leap::subsys::mdf {
+
+using namespace eerie_leap::utilities::memory;
+using namespace eerie_leap::subsys::threading;
+
+struct Mdf4AsyncBlockSinkStatistics {
+    uint32_t buffer_count;
+    uint32_t buffer_high_water_mark;
+    uint32_t stall_count;
+    uint32_t write_error_count;
+    uint32_t blocks_written;
+    uint64_t bytes_written;
+    uint32_t flush_latency_min_us;
+    uint32_t flush_latency_mean_us;
+    uint32_t flush_latency_max_us;
+};
+
+// Writes DT blocks to the stream from a dedicated writer thread.
+// A fixed set of buffers circulates between the producer and the writer,
+// so one buffer fills while another is being written. Producer only
+// blocks when all buffers are waiting for the stream, counted as a stall,
+// and fails once EERIE_LEAP_MDF_LOGGER_BUFFER_TIMEOUT_MS passes.
+// NOTE: GetStreamAddress and GetDataBlocks are only consistent after Flush.
+class Mdf4AsyncBlockSink : public IMdf4BlockSink, public IThread {
+private:
+    struct QueuedBuffer {
+        uint8_t* buffer;
+        size_t size_bytes;
+        Mdf4BlockOptions options;
+    };
+
+    static constexpr int k_stack_size_ = CONFIG_EERIE_LEAP_MDF_LOGGER_THREAD_STACK_SIZE;
+    static constexpr int k_priority_ = CONFIG_EERIE_LEAP_MDF_LOGGER_THREAD_PRIORITY;
+    std::unique_ptr<Thread> thread_;
+
+    Mdf4StreamBlockSink stream_sink_;
+    std::pmr::memory_resource* mr_;
+    size_t buffer_size_;
+    std::pmr::vector<uint8_t*> buffers_;
+    k_timeout_t acquire_timeout_;
+
+    std::pmr::vector<QueuedBuffer> free_msgq_buffer_;
+    std::pmr::vector<QueuedBuffer> filled_msgq_buffer_;
+    k_msgq free_msgq_;
+    k_msgq filled_msgq_;
+
+    atomic_t pending_count_;
+    k_sem drained_sem_;
+
+    k_spinlock lock_;
+    uint32_t buffer_high_water_mark_ = 0;
+    uint32_t stall_count_ = 0;
+    uint32_t write_error_count_ = 0;
+    uint32_t blocks_written_ = 0;
+    uint64_t bytes_written_ = 0;
+    uint32_t flush_latency_min_us_ = UINT32_MAX;
+    uint32_t flush_latency_max_us_ = 0;
+    uint64_t flush_latency_sum_us_ = 0;
+
+    void InitializeQueues(std::span<uint8_t* const> free_buffers);
+    void ThreadEntry() override;
+
+public:
+    Mdf4AsyncBlockSink(
+        std::streambuf& stream,
+        uint64_t stream_address,
+        size_t buffer_size = CONFIG_EERIE_LEAP_MDF_RECORD_BUFFER_SIZE,
+        size_t buffer_count = CONFIG_EERIE_LEAP_MDF_LOGGER_BUFFER_COUNT,
+        std::pmr::memory_resource* mr = Mrm::GetExtPmr());
+    ~Mdf4AsyncBlockSink() override;
+
+    Mdf4AsyncBlockSink(const Mdf4AsyncBlockSink&) = delete;
+    Mdf4AsyncBlockSink& operator=(const Mdf4AsyncBlockSink&) = delete;
+
+    void Start();
+    // Writes all submitted buffers and stops the writer thread
+    void Stop();
+
+    size_t GetBufferSize() const override { return buffer_size_; }
+    // NOTE: Keeps one more buffer than writers, for the one being written.
+    // Buffers can only be added while the writer thread is stopped.
+    void ReserveBuffers(size_t writer_count) override;
+    uint8_t* AcquireBuffer() override;
+    void SubmitBuffer(uint8_t* buffer, size_t size_bytes, const Mdf4BlockOptions& options) override;
+    // Waits for all submitted buffers to be written
+    void Flush() override;
+
+    uint64_t GetStreamAddress() const override { return stream_sink_.GetStreamAddress(); }
+    std::vector<Mdf4DataBlockInfo> GetDataBlocks() const override { return stream_sink_.GetDataBlocks(); }
+
+    // NOTE: Data lists must be enabled before Start, DL blocks are
+    // written by the writer thread along with the data blocks.
+    void EnableDataList(uint32_t writer_id, uint64_t link_address) override;
+    void FlushDataLists() override;
+
+    // NOTE: Blocks are compressed in the writer thread
+    void SetCompressionLevel(int level) { stream_sink_.SetCompressionLevel(level); }
+    int GetCompressionLevel() const { return stream_sink_.GetCompressionLevel(); }
+
+    Mdf4AsyncBlockSinkStatistics GetStatistics();
+    Mdf4CompressionStatistics GetCompressionStatistics() { return stream_sink_.GetCompressionStatistics(); }
+    void ResetStatistics();
+};
+
+} // namespace eerie_leap::subsys::mdf
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <streambuf>
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/can.h>
+#include <zephyr/sys/atomic.h>
+
+#include "utilities/queue/lock_free_bounded_queue.hpp"
+#include "subsys/canbus/can_frame.h"
+#include "subsys/threading/thread.h"
+#include "mdf4_file.h"
+#include "mdf4_record_writer.h"
+#include "mdf4_async_block_sink.h"
+#include "mdf4_triggered_capture.h"
+
+namespace eerie_leap::subsys::mdf {
+
+using namespace eerie_leap::utilities::queue;
+using namespace eerie_leap::subsys::canbus;
+using namespace eerie_leap::subsys::threading;
+
+struct Mdf4CanbusLoggerStatistics {
+    uint32_t logged_count;
+    uint32_t dropped_count;
+    uint32_t queue_capacity;
+    uint32_t queue_high_water_mark;
+    uint32_t rotation_count;
+    // Sink statistics restart with each rotated file
+    Mdf4AsyncBlockSinkStatistics sink;
+    Mdf4CompressionStatistics compression;
+};
+
+// Opens the stream of the next file of a rotated log
+using Mdf4StreamFactory = std::function<std::unique_ptr<std::streambuf>()>;
+
+struct Mdf4FileRotationOptions {
+    // Zero disables the limit
+    uint64_t max_file_size_bytes = 0;
+    uint32_t max_file_duration_ms = 0;
+};
+
+// Logs CAN frames to an MDF4 file off the RX path.
+// Log only copies the frame into a fixed size entry of a lock free queue
+// and never blocks, frames are dropped when the queue is full. Logger
+// thread encodes the records into DT block buffers, which are written to
+// the stream by the sink writer thread. Blocks are linked from DL blocks
+// as they are written and the file is finalized on Stop.
+// Channel group may use either CAN data frame layout, the fixed length one
+// writes a single record per frame and can use TranspositionDeflate.
+// With a triggered capture set, frames go to its ring buffer and are only
+// written as part of capture segments.
+// With rotation set, the file is finalized once it reaches the size or
+// duration limit and logging continues with the same layout in the next
+// stream, which should have its extent preallocated.
+class Mdf4CanbusLogger : public IThread, public IMdf4CaptureSource {
+private:
+    static constexpr size_t MAX_FRAME_DATA_SIZE = 64;
+
+    struct LogEntry {
+        float time;
+        uint32_t id;
+        uint8_t size;
+        uint8_t bus_channel;
+        bool is_extended_id;
+        bool is_transmit;
+        bool is_can_fd;
+        bool is_bit_rate_switch;
+        uint8_t data[MAX_FRAME_DATA_SIZE];
+    };
+
+    static constexpr int k_stack_size_ = CONFIG_EERIE_LEAP_MDF_LOGGER_THREAD_STACK_SIZE;
+    static constexpr int k_priority_ = CONFIG_EERIE_LEAP_MDF_LOGGER_THREAD_PRIORITY;
+    std::unique_ptr<Thread> thread_;
+
+    std::shared_ptr<Mdf4File> mdf4_file_;
+    std::shared_ptr<mdf4::ChannelGroupBlock> channel_group_;
+    bool is_fixed_layout_;
+    std::unique_ptr<std::streambuf> stream_;
+    Mdf4CompressionType compression_;
+
+    LockFreeBoundedQueue<LogEntry> queue_;
+    k_sem queue_sem_;
+    atomic_t is_running_;
+    atomic_t logged_count_;
+    atomic_t dropped_count_;
+
+    std::unique_ptr<Mdf4AsyncBlockSink> sink_;
+    std::unique_ptr<Mdf4RecordWriter> writer_;
+
+    std::shared_ptr<Mdf4TriggeredCapture> capture_;
+    uint16_t capture_source_id_;
+
+    bool is_file_open_;
+    uint64_t file_header_size_bytes_;
+    int64_t file_start_time_ms_;
+    Mdf4StreamFactory next_stream_factory_;
+    Mdf4FileRotationOptions rotation_options_;
+    bool is_rotation_failed_;
+    atomic_t rotation_count_;
+
+    bool OpenFile();
+    void CloseFile();
+    bool IsRotationDue();
+    void RotateFile();
+
+    void ThreadEntry() override;
+    bool Enqueue(const LogEntry& entry);
+    void WriteEntry(const LogEntry& entry);
+    void CaptureEntry(const LogEntry& entry);
+
+public:
+    Mdf4CanbusLogger(
+        std::shared_ptr<Mdf4File> mdf4_file,
+        std::shared_ptr<mdf4::ChannelGroupBlock> channel_group,
+        std::unique_ptr<std::streambuf> stream,
+        Mdf4CompressionType compression = Mdf4CompressionType::None);
+    ~Mdf4CanbusLogger();
+
+    Mdf4CanbusLogger(const Mdf4CanbusLogger&) = delete;
+    Mdf4CanbusLogger& operator=(const Mdf4CanbusLogger&) = delete;
+
+    // Writes the file header and starts the logger and writer threads
+    bool Start();
+    // Writes all queued frames and stops the threads
+    void Stop();
+    bool IsRunning() const { return atomic_get(&is_running_) != 0; }
+
+    // NOTE: Takes effect on next Start, capture segment in progress is
+    // ended on Stop.
+    void SetCapture(std::shared_ptr<Mdf4TriggeredCapture> capture);
+    // NOTE: Mdf4File has to be created unfinalized, takes effect on next Start
+    void SetRotation(Mdf4StreamFactory next_stream_factory, const Mdf4FileRotationOptions& options);
+    void WriteCapturedRecord(uint16_t source_id, std::span<const uint8_t> record, float time) override;
+    void FlushCapturedRecords() override;
+
+    bool Log(const CanFrame& can_frame, float time, uint8_t bus_channel = 0);
+    bool Log(const can_frame& frame, bool is_transmit, float time, uint8_t bus_channel = 0);
+
+    Mdf4CanbusLoggerStatistics GetStatistics();
+    void ResetStatistics();
+    void PrintStatistics();
+};
+
+} // namespace eerie_leap::subsys::mdf
@@ -1,6 +1,9 @@
 #include <algorithm>
+#include <array>
 #include <utility>
 
+#include <zephyr/drivers/can.h>
+
 #include "subsys/time/time_helpers.hpp"
 #include "subsys/mdf/mdf4/channel_block.h"
 #include "subsys/mdf/mdf4/channel_group_block.h"
@@ -13,16 +16,23 @@ namespace eerie_leap::subsys::mdf {
 
 using namespace eerie_leap::subsys::time;
 
-Mdf4File::Mdf4File(bool is_finalized): is_finalized_(is_finalized) {
-    id_block_ = std::make_unique<mdf4::IdBlock>(is_finalized);
+Mdf4File::Mdf4File(bool is_finalized)
+    : is_finalized_(is_finalized), is_created_finalized_(is_finalized) {
+
+    id_block_ = CreateIdBlock(is_finalized);
+    header_block_ = std::make_unique<mdf4::HeaderBlock>();
+}
+
+std::unique_ptr<mdf4::IdBlock> Mdf4File::CreateIdBlock(bool is_finalized) {
+    auto id_block = std::make_unique<mdf4::IdBlock>(is_finalized);
 
     if(!is_finalized) {
-        id_block_->AddStandardFlag(mdf4::IdBlock::StandardFlag::InvalidCGCount);
-        id_block_->AddStandardFlag(mdf4::IdBlock::StandardFlag::InvalidLastDTBlock);
-        id_block_->AddStandardFlag(mdf4::IdBlock::StandardFlag::InvalidDataVLSDBlock);
+        id_block->AddStandardFlag(mdf4::IdBlock::StandardFlag::InvalidCGCount);
+        id_block->AddStandardFlag(mdf4::IdBlock::StandardFlag::InvalidLastDTBlock);
+        id_block->AddStandardFlag(mdf4::IdBlock::StandardFlag::InvalidDataVLSDBlock);
     }
 
-    header_block_ = std::make_unique<mdf4::HeaderBlock>();
+    return id_block;
 }
 
 // NOTE: Incorrect start time in Header Block time seems to
@@ -34,6 +44,7 @@ void Mdf4File::UpdateCurrentTime(system_clock::time_point time) {
 std::shared_ptr<mdf4::DataGroupBlock> Mdf4File::CreateDataGroup(uint8_t record_id_size_bytes) {
     auto data_group = std::make_shared<mdf4::DataGroupBlock>(record_id_size_bytes);
     data_groups_.emplace(data_group, std::unordered_set<uint64_t>{});
+    data_group_list_.push_back(data_group);
 
     header_block_->AddDataGroup(data_group);
 
@@ -41,11 +52,23 @@ std::shared_ptr<mdf4::DataGroupBlock> Mdf4File::CreateDataGroup(uint8_t record_i
 }
 
 const std::vector<std::shared_ptr<mdf4::DataGroupBlock>> Mdf4File::GetDataGroups() const {
-    std::vector<std::shared_ptr<mdf4::DataGroupBlock>> data_groups;
-    for(auto& [data_group, _] : data_groups_)
-        data_groups.push_back(data_group);
+    return data_group_list_;
+}
 
-    return data_groups;
+uint32_t Mdf4File::GetDataGroupIndex(const std::shared_ptr<mdf4::DataGroupBlock>& data_group) const {
+    auto it = std::find(data_group_list_.begin(), data_group_list_.end(), data_group);
+    if(it == data_group_list_.end())
+        throw std::runtime_error("Data group not found");
+
+    return static_cast<uint32_t>(it - data_group_list_.begin());
+}
+
+uint32_t Mdf4File::GetDataGroupIndex(const std::shared_ptr<mdf4::ChannelGroupBlock>& channel_group) const {
+    auto it = channel_group_data_groups_.find(channel_group);
+    if(it == channel_group_data_groups_.end())
+        throw std::runtime_error("Channel group not found");
+
+    return GetDataGroupIndex(it->second);
 }
 
 std::shared_ptr<mdf4::ChannelGroupBlock> Mdf4File::CreateChannelGroup(std::shared_ptr<mdf4::DataGroupBlock> data_group, uint64_t record_id, const std::string& name) {
@@ -62,6 +85,7 @@ std::shared_ptr<mdf4::ChannelGroupBlock> Mdf4File::CreateChannelGroup(std::share
         record_id);
     channel_group->SetName(GetOrCreateTextBlock(name));
     data_group->AddChannelGroup(channel_group);
+    channel_group_data_groups_.emplace(channel_group, data_group);
 
     auto channel_data_type = MdfHelpers::ToMdf4ChannelDataType(MdfDataType::Float32);
     auto channel_time = std::make_shared<mdf4::ChannelBlock>(
@@ -90,19 +114,32 @@ std::shared_ptr<mdf4::ChannelGroupBlock> Mdf4File::CreateVLSDChannelGroup(std::s
         record_id);
     channel_group->SetFlags(std::to_underlying(mdf4::ChannelGroupBlock::Flag::VlsdChannel));
     data_group->AddChannelGroup(channel_group);
+    channel_group_data_groups_.emplace(channel_group, data_group);
 
     return channel_group;
 }
 
-std::shared_ptr<mdf4::ChannelGroupBlock> Mdf4File::CreateCanDataFrameChannelGroup(
+std::shared_ptr<mdf4::ChannelBlock> Mdf4File::CreateBusEventChannelBlock(
+    const std::string& name,
+    uint32_t offset_bytes,
+    uint8_t offset_bits,
+    uint32_t bit_count) {
+
+    auto channel = CreateChannelBlock(MdfDataType::Uint32, name);
+    channel->SetFlags(std::to_underlying(mdf4::ChannelBlock::Flag::BusEvent));
+    channel->SetOffsetBytes(offset_bytes);
+    if(offset_bits > 0)
+        channel->SetOffsetBits(offset_bits);
+    channel->SetBitCount(bit_count);
+
+    return channel;
+}
+
+std::shared_ptr<mdf4::ChannelGroupBlock> Mdf4File::CreateCanBusEventChannelGroup(
     std::shared_ptr<mdf4::DataGroupBlock> data_group,
-    std::shared_ptr<mdf4::ChannelGroupBlock> vlsd_channel_group,
     uint64_t record_id,
     const std::string& name) {
 
-    if(!(vlsd_channel_group->GetFlags() & std::to_underlying(mdf4::ChannelGroupBlock::Flag::VlsdChannel)))
-        throw std::runtime_error("Invalid channel group flags");
-
     auto channel_group = CreateChannelGroup(data_group, record_id, name);
     channel_group->SetFlags(
         std::to_underlying(mdf4::ChannelGroupBlock::Flag::BusEvent)
@@ -116,68 +153,40 @@ std::shared_ptr<mdf4::ChannelGroupBlock> Mdf4File::CreateCanDataFrameChannelGrou
     source_information->SetPath(GetOrCreateTextBlock("CAN"));
     channel_group->AddSourceInformation(source_information);
 
+    return channel_group;
+}
+
+std::shared_ptr<mdf4::ChannelGroupBlock> Mdf4File::CreateCanDataFrameChannelGroup(
+    std::shared_ptr<mdf4::DataGroupBlock> data_group,
+    std::shared_ptr<mdf4::ChannelGroupBlock> vlsd_channel_group,
+    uint64_t record_id,
+    const std::string& name) {
+
+    if(!(vlsd_channel_group->GetFlags() & std::to_underlying(mdf4::ChannelGroupBlock::Flag::VlsdChannel)))
+        throw std::runtime_error("Invalid channel group flags");
+
+    auto channel_group = CreateCanBusEventChannelGroup(data_group, record_id, name);
+
     auto can_data_frame_channel = CreateChannelBlock(MdfDataType::ByteArray, "CAN_DataFrame");
     can_data_frame_channel->SetFlags(std::to_underlying(mdf4::ChannelBlock::Flag::BusEvent));
     can_data_frame_channel->SetBitCount(80);
     channel_group->AddChannel(can_data_frame_channel);
 
-    auto can_data_frame_bus_channel = CreateChannelBlock(MdfDataType::Uint32, "CAN_DataFrame.BusChannel");
-    can_data_frame_bus_channel->SetFlags(std::to_underlying(mdf4::ChannelBlock::Flag::BusEvent));
-    can_data_frame_bus_channel->SetOffsetBytes(4);
-    can_data_frame_bus_channel->SetBitCount(2);
+    auto can_data_frame_bus_channel = CreateBusEventChannelBlock("CAN_DataFrame.BusChannel", 4, 0, 2);
     can_data_frame_channel->SetArrayBlock(can_data_frame_bus_channel);
 
-    auto can_data_frame_id_channel = CreateChannelBlock(MdfDataType::Uint32, "CAN_DataFrame.ID");
-    can_data_frame_id_channel->SetFlags(std::to_underlying(mdf4::ChannelBlock::Flag::BusEvent));
-    can_data_frame_id_channel->SetOffsetBytes(4);
-    can_data_frame_id_channel->SetOffsetBits(2);
-    can_data_frame_id_channel->SetBitCount(29);
-    can_data_frame_bus_channel->LinkBlock(can_data_frame_id_channel);
-
+    can_data_frame_bus_channel->LinkBlock(CreateBusEventChannelBlock("CAN_DataFrame.ID", 4, 2, 29));
     // IDE (Identifier Extension) | 0 - 11 bit ID, 1 - 29 bit ID
-    auto can_data_frame_ide_channel = CreateChannelBlock(MdfDataType::Uint32, "CAN_DataFrame.IDE");
-    can_data_frame_ide_channel->SetFlags(std::to_underlying(mdf4::ChannelBlock::Flag::BusEvent));
-    can_data_frame_ide_channel->SetOffsetBytes(7);
-    can_data_frame_ide_channel->SetOffsetBits(7);
-    can_data_frame_ide_channel->SetBitCount(1);
-    can_data_frame_bus_channel->LinkBlock(can_data_frame_ide_channel);
-
+    can_data_frame_bus_channel->LinkBlock(CreateBusEventChannelBlock("CAN_DataFrame.IDE", 7, 7, 1));
     // Dir (Direction) | 0 - Receive, 1 - Transmit
-    auto can_data_frame_dir_channel = CreateChannelBlock(MdfDataType::Uint32, "CAN_DataFrame.Dir");
-    can_data_frame_dir_channel->SetFlags(std::to_underlying(mdf4::ChannelBlock::Flag::BusEvent));
-    can_data_frame_dir_channel->SetOffsetBytes(8);
-    can_data_frame_dir_channel->SetBitCount(1);
-    can_data_frame_bus_channel->LinkBlock(can_data_frame_dir_channel);
-
-    auto can_data_frame_data_length_channel = CreateChannelBlock(MdfDataType::Uint32, "CAN_DataFrame.DataLength");
-    can_data_frame_data_length_channel->SetFlags(std::to_underlying(mdf4::ChannelBlock::Flag::BusEvent));
-    can_data_frame_data_length_channel->SetOffsetBytes(8);
-    can_data_frame_data_length_channel->SetOffsetBits(1);
-    can_data_frame_data_length_channel->SetBitCount(7);
-    can_data_frame_bus_channel->LinkBlock(can_data_frame_data_length_channel);
-
+    can_data_frame_bus_channel->LinkBlock(CreateBusEventChannelBlock("CAN_DataFrame.Dir", 8, 0, 1));
+    can_data_frame_bus_channel->LinkBlock(CreateBusEventChannelBlock("CAN_DataFrame.DataLength", 8, 1, 7));
     // EDL (Extended Data Length) | 0 - Standard CAN, 1 - CAN FD
-    auto can_data_frame_edl_channel = CreateChannelBlock(MdfDataType::Uint32, "CAN_DataFrame.EDL");
-    can_data_frame_edl_channel->SetFlags(std::to_underlying(mdf4::ChannelBlock::Flag::BusEvent));
-    can_data_frame_edl_channel->SetOffsetBytes(9);
-    can_data_frame_edl_channel->SetBitCount(1);
-    can_data_frame_bus_channel->LinkBlock(can_data_frame_edl_channel);
-
+    can_data_frame_bus_channel->LinkBlock(CreateBusEventChannelBlock("CAN_DataFrame.EDL", 9, 0, 1));
     // BRS (Bit Rate Switch)
-    auto can_data_frame_brs_channel = CreateChannelBlock(MdfDataType::Uint32, "CAN_DataFrame.BRS");
-    can_data_frame_brs_channel->SetFlags(std::to_underlying(mdf4::ChannelBlock::Flag::BusEvent));
-    can_data_frame_brs_channel->SetOffsetBytes(9);
-    can_data_frame_brs_channel->SetOffsetBits(1);
-    can_data_frame_brs_channel->SetBitCount(1);
-    can_data_frame_bus_channel->LinkBlock(can_data_frame_brs_channel);
-
+    can_data_frame_bus_channel->LinkBlock(CreateBusEventChannelBlock("CAN_DataFrame.BRS", 9, 1, 1));
     // DLC (Data Length Code)
-    auto can_data_frame_dlc_channel = CreateChannelBlock(MdfDataType::Uint32, "CAN_DataFrame.DLC");
-    can_data_frame_dlc_channel->SetFlags(std::to_underlying(mdf4::ChannelBlock::Flag::BusEvent));
-    can_data_frame_dlc_channel->SetOffsetBytes(9);
-    can_data_frame_dlc_channel->SetOffsetBits(2);
-    can_data_frame_dlc_channel->SetBitCount(4);
-    can_data_frame_bus_channel->LinkBlock(can_data_frame_dlc_channel);
+    can_data_frame_bus_channel->LinkBlock(CreateBusEventChannelBlock("CAN_DataFrame.DLC", 9, 2, 4));
 
     // VLSD data block offset
     auto can_data_frame_data_bytes_channel = CreateChannelBlock(MdfDataType::ByteArray, "CAN_DataFrame.DataBytes");
@@ -200,6 +209,53 @@ std::shared_ptr<mdf4::ChannelGroupBlock> Mdf4File::CreateCanDataFrameChannelGrou
     return channel_group;
 }
 
+std::shared_ptr<mdf4::ChannelGroupBlock> Mdf4File::CreateCanDataFrameFixedChannelGroup(
+    std::shared_ptr<mdf4::DataGroupBlock> data_group,
+    uint64_t record_id,
+    const std::string& name) {
+
+    auto channel_group = CreateCanBusEventChannelGroup(data_group, record_id, name);
+
+    auto can_data_frame_channel = CreateChannelBlock(MdfDataType::ByteArray, "CAN_DataFrame");
+    can_data_frame_channel->SetFlags(std::to_underlying(mdf4::ChannelBlock::Flag::BusEvent));
+    can_data_frame_channel->SetBitCount((CAN_FIXED_DATA_FRAME_RECORD_SIZE - sizeof(float)) * 8);
+    channel_group->AddChannel(can_data_frame_channel);
+
+    auto can_data_frame_bus_channel = CreateBusEventChannelBlock("CAN_DataFrame.BusChannel", 4, 0, 8);
+    can_data_frame_channel->SetArrayBlock(can_data_frame_bus_channel);
+
+    can_data_frame_bus_channel->LinkBlock(CreateBusEventChannelBlock("CAN_DataFrame.ID", 5, 0, 29));
+    // IDE (Identifier Extension) | 0 - 11 bit ID, 1 - 29 bit ID
+    can_data_frame_bus_channel->LinkBlock(CreateBusEventChannelBlock("CAN_DataFrame.IDE", 8, 7, 1));
+    // Dir (Direction) | 0 - Receive, 1 - Transmit
+    can_data_frame_bus_channel->LinkBlock(CreateBusEventChannelBlock("CAN_DataFrame.Dir", 9, 0, 1));
+    can_data_frame_bus_channel->LinkBlock(CreateBusEventChannelBlock("CAN_DataFrame.DataLength", 9, 1, 7));
+    // EDL (Extended Data Length) | 0 - Standard CAN, 1 - CAN FD
+    can_data_frame_bus_channel->LinkBlock(CreateBusEventChannelBlock("CAN_DataFrame.EDL", 10, 0, 1));
+    // BRS (Bit Rate Switch)
+    can_data_frame_bus_channel->LinkBlock(CreateBusEventChannelBlock("CAN_DataFrame.BRS", 10, 1, 1));
+    // DLC (Data Length Code)
+    can_data_frame_bus_channel->LinkBlock(CreateBusEventChannelBlock("CAN_DataFrame.DLC", 10, 2, 4));
+
+    // Payload inline, DataLength tells how many bytes are valid
+    auto can_data_frame_data_bytes_channel = CreateChannelBlock(MdfDataType::ByteArray, "CAN_DataFrame.DataBytes");
+    can_data_frame_data_bytes_channel->SetFlags(std::to_underlying(mdf4::ChannelBlock::Flag::BusEvent));
+    can_data_frame_data_bytes_channel->SetOffsetBytes(11);
+    can_data_frame_data_bytes_channel->SetBitCount(MAX_CAN_FRAME_DATA_SIZE * 8);
+    can_data_frame_bus_channel->LinkBlock(can_data_frame_data_bytes_channel);
+
+    if(channel_group->GetDataSizeBytes() != CAN_FIXED_DATA_FRAME_RECORD_SIZE)
+        throw std::runtime_error("Unexpected CAN data frame record layout");
+
+    can_fixed_data_frame_records_.emplace(channel_group, std::make_shared<mdf4::DataRecord>(channel_group));
+
+    return channel_group;
+}
+
+bool Mdf4File::IsCanDataFrameFixedChannelGroup(const std::shared_ptr<mdf4::ChannelGroupBlock>& channel_group) const {
+    return can_fixed_data_frame_records_.contains(channel_group);
+}
+
 std::shared_ptr<mdf4::ChannelBlock> Mdf4File::CreateChannelBlock(MdfDataType data_type, std::string name, std::string unit) {
     auto channel_data_type = MdfHelpers::ToMdf4ChannelDataType(data_type);
     auto channel = std::make_shared<mdf4::ChannelBlock>(
@@ -241,6 +297,8 @@ std::shared_ptr<mdf4::TextBlock> Mdf4File::GetOrCreateTextBlock(const std::strin
 uint64_t Mdf4File::WriteFileToStream(std::streambuf& stream) const {
     for(auto& [_, can_data_frame_block] : can_data_frame_blocks_)
         can_data_frame_block.raw_data_vlsd_data_record->Reset();
+    for(auto& [channel_group, _] : channel_group_data_groups_)
+        channel_group->ResetCycleCount();
 
     id_block_->Reset();
     auto current_address = id_block_->ResolveAddress(0);
@@ -253,19 +311,90 @@ uint64_t Mdf4File::WriteFileToStream(std::streambuf& stream) const {
     return bytes_written;
 }
 
-uint64_t Mdf4File::WriteCanbusDataRecordToStream(
-        std::shared_ptr<mdf4::ChannelGroupBlock> channel_group,
-        std::streambuf& stream,
-        const CanFrame& can_frame,
-        float time) const {
+void Mdf4File::EnableDataList(IMdf4BlockSink& sink, const std::shared_ptr<mdf4::DataGroupBlock>& data_group) const {
+    if(!data_group->IsSerialized())
+        throw std::runtime_error("Data group is not written to the stream");
+
+    sink.EnableDataList(GetDataGroupIndex(data_group), data_group->GetDataLinkAddress());
+}
 
-    if(!can_data_frame_blocks_.contains(channel_group))
+void Mdf4File::EnableDataLists(IMdf4BlockSink& sink) const {
+    for(const auto& data_group : data_group_list_)
+        EnableDataList(sink, data_group);
+}
+
+void Mdf4File::FinalizeStream(std::streambuf& stream) {
+    auto write_at = [&stream](uint64_t address, const void* data, size_t size) {
+        if(stream.pubseekpos(address, std::ios_base::out) != address)
+            throw std::ios_base::failure("Failed to seek MDF stream.");
+
+        if(stream.sputn(reinterpret_cast<const char*>(data), size) != size)
+            throw std::ios_base::failure("End of stream reached (EOF).");
+    };
+
+    for(auto& [channel_group, _] : channel_group_data_groups_) {
+        if(!channel_group->IsSerialized())
+            continue;
+
+        uint64_t cycle_count = channel_group->GetCycleCount();
+        write_at(channel_group->GetCycleCountAddress(), &cycle_count, sizeof(cycle_count));
+    }
+
+    // NOTE: ID block goes last, file only claims to be finalized
+    // once everything else is in place.
+    stream.pubsync();
+
+    id_block_->SetFinalized();
+    is_finalized_ = true;
+
+    auto id_block_data = id_block_->Serialize();
+    write_at(0, id_block_data.get(), id_block_->GetBlockSize());
+
+    stream.pubseekoff(0, std::ios_base::end, std::ios_base::out);
+}
+
+void Mdf4File::ResetFinalized() {
+    if(is_created_finalized_ || !is_finalized_)
+        return;
+
+    id_block_ = CreateIdBlock(false);
+    is_finalized_ = false;
+}
+
+const Mdf4File::CanDataFrameBlocks& Mdf4File::GetCanDataFrameBlocks(const std::shared_ptr<mdf4::ChannelGroupBlock>& channel_group) const {
+    auto it = can_data_frame_blocks_.find(channel_group);
+    if(it == can_data_frame_blocks_.end())
         throw std::runtime_error("Invalid channel group");
 
-    auto& can_data_frame_block = can_data_frame_blocks_.at(channel_group);
+    return it->second;
+}
+
+uint8_t Mdf4File::ToCanDlc(size_t data_length) {
+    static constexpr uint8_t can_fd_data_lengths[] = { 12, 16, 20, 24, 32, 48, 64 };
+
+    if(data_length <= 8)
+        return data_length;
 
-    std::vector<uint8_t> data(channel_group->GetDataSizeBytes());
-    memset(data.data(), 0, data.size());
+    auto it = std::lower_bound(std::begin(can_fd_data_lengths), std::end(can_fd_data_lengths), data_length);
+    if(it == std::end(can_fd_data_lengths))
+        throw std::runtime_error("Invalid CAN data length");
+
+    return 9 + (it - std::begin(can_fd_data_lengths));
+}
+
+// Record is built in the caller provided buffer, no allocation per frame
+std::span<uint8_t> Mdf4File::BuildCanbusDataRecord(
+        const std::shared_ptr<mdf4::ChannelGroupBlock>& channel_group,
+        const CanDataFrameBlocks& can_data_frame_block,
+        const Mdf4CanDataFrame& frame,
+        float time,
+        std::span<uint8_t, MAX_CAN_DATA_FRAME_RECORD_SIZE> buffer) const {
+
+    if(channel_group->GetDataSizeBytes() > buffer.size())
+        throw std::runtime_error("CAN data frame record exceeds buffer size");
+
+    auto data = buffer.first(channel_group->GetDataSizeBytes());
+    std::fill(data.begin(), data.end(), 0);
 
     int offset = 0;
 
@@ -277,17 +406,16 @@ uint64_t Mdf4File::WriteCanbusDataRecordToStream(
 
     // CAN_DataFrame.BusChannel
     // 2 bits
-    uint32_t bus_channel = 0;
+    uint32_t bus_channel = frame.bus_channel & 0x03;
     data_pack_0 |= bus_channel;
 
     // CAN_DataFrame.ID
     // 29 bits
-    uint32_t frame_id = can_frame.id;
-    data_pack_0 |= frame_id  << 2;
+    data_pack_0 |= (frame.id & 0x1FFFFFFF) << 2;
 
     // CAN_DataFrame.IDE
     // 1 bit
-    uint32_t frame_ide = 0;
+    uint32_t frame_ide = frame.is_extended_id ? 1 : 0;
     data_pack_0 |= frame_ide << 31;
 
     std::memcpy(data.data() + offset, &data_pack_0, sizeof(data_pack_0));
@@ -297,12 +425,12 @@ uint64_t Mdf4File::WriteCanbusDataRecordToStream(
 
     // CAN_DataFrame.Dir
     // 1 bit
-    uint8_t frame_dir = can_frame.is_transmit ? 1 : 0;
+    uint8_t frame_dir = frame.is_transmit ? 1 : 0;
     data_pack_1 |= frame_dir;
 
     // CAN_DataFrame.DataLength
     // 7 bits
-    uint8_t frame_data_length = can_frame.data.size();
+    uint8_t frame_data_length = frame.data.size();
     data_pack_1 |= frame_data_length << 1;
 
     std::memcpy(data.data() + offset, &data_pack_1, sizeof(data_pack_1));
@@ -312,25 +440,46 @@ uint64_t Mdf4File::WriteCanbusDataRecordToStream(
 
     // CAN_DataFrame.EDL
     // 1 bit
-    uint8_t frame_edl = can_frame.is_can_fd ? 1 : 0;
+    uint8_t frame_edl = frame.is_can_fd ? 1 : 0;
     data_pack_2 |= frame_edl;
 
     // CAN_DataFrame.BRS
     // 1 bit
-    uint8_t frame_brs = 0;
+    uint8_t frame_brs = frame.is_bit_rate_switch ? 1 : 0;
     data_pack_2 |= frame_brs << 1;
 
     // CAN_DataFrame.DLC
     // 4 bits
-    uint8_t frame_dlc = can_frame.data.size();
+    uint8_t frame_dlc = ToCanDlc(frame.data.size());
     data_pack_2 |= frame_dlc << 2;
 
     std::memcpy(data.data() + offset, &data_pack_2, sizeof(data_pack_2));
     offset += sizeof(data_pack_2);
 
     // CAN_DataFrame.DataBytes
-    auto data_pack_3 = can_data_frame_block.raw_data_vlsd_data_record->GetOffsetData();
-    std::memcpy(data.data() + offset, data_pack_3.data(), data_pack_3.size());
+    can_data_frame_block.raw_data_vlsd_data_record->CopyOffsetData(data.data() + offset);
+
+    return data;
+}
+
+uint64_t Mdf4File::WriteCanbusDataRecordToStream(
+        std::shared_ptr<mdf4::ChannelGroupBlock> channel_group,
+        std::streambuf& stream,
+        const CanFrame& can_frame,
+        float time) const {
+
+    auto& can_data_frame_block = GetCanDataFrameBlocks(channel_group);
+
+    Mdf4CanDataFrame frame = {
+        .id = can_frame.id,
+        .is_extended_id = (can_frame.flags & CAN_FRAME_IDE) != 0,
+        .is_transmit = can_frame.is_transmit,
+        .is_can_fd = can_frame.is_can_fd,
+        .data = can_frame.data
+    };
+
+    std::array<uint8_t, MAX_CAN_DATA_FRAME_RECORD_SIZE> buffer;
+    auto data = BuildCanbusDataRecord(channel_group, can_data_frame_block, frame, time, buffer);
 
     auto bytes_written = can_data_frame_block.header_data_record->WriteToStream(stream, data);
     bytes_written += can_data_frame_block.raw_data_vlsd_data_record->WriteToStream(stream, can_frame.data);
@@ -338,4 +487,92 @@ uint64_t Mdf4File::WriteCanbusDataRecordToStream(
     return bytes_written;
 }
 
+uint64_t Mdf4File::WriteCanbusDataRecord(
+        std::shared_ptr<mdf4::ChannelGroupBlock> channel_group,
+        Mdf4RecordWriter& writer,
+        const CanFrame& can_frame,
+        float time) const {
+
+    Mdf4CanDataFrame frame = {
+        .id = can_frame.id,
+        .is_extended_id = (can_frame.flags & CAN_FRAME_IDE) != 0,
+        .is_transmit = can_frame.is_transmit,
+        .is_can_fd = can_frame.is_can_fd,
+        .data = can_frame.data
+    };
+
+    if(IsCanDataFrameFixedChannelGroup(channel_group))
+        return WriteCanbusFixedDataRecord(channel_group, writer, frame, time);
+
+    return WriteCanbusDataRecord(channel_group, writer, frame, time);
+}
+
+uint64_t Mdf4File::WriteCanbusDataRecord(
+        const std::shared_ptr<mdf4::ChannelGroupBlock>& channel_group,
+        Mdf4RecordWriter& writer,
+        const Mdf4CanDataFrame& frame,
+        float time) const {
+
+    auto& can_data_frame_block = GetCanDataFrameBlocks(channel_group);
+
+    std::array<uint8_t, MAX_CAN_DATA_FRAME_RECORD_SIZE> buffer;
+    auto data = BuildCanbusDataRecord(channel_group, can_data_frame_block, frame, time, buffer);
+
+    auto bytes_written = can_data_frame_block.header_data_record->WriteToWriter(writer, data);
+    bytes_written += can_data_frame_block.raw_data_vlsd_data_record->WriteToWriter(writer, frame.data);
+
+    return bytes_written;
+}
+
+// Single record per frame, payload padded to 64 bytes
+uint64_t Mdf4File::WriteCanbusFixedDataRecord(
+        const std::shared_ptr<mdf4::ChannelGroupBlock>& channel_group,
+        Mdf4RecordWriter& writer,
+        const Mdf4CanDataFrame& frame,
+        float time) const {
+
+    auto it = can_fixed_data_frame_records_.find(channel_group);
+    if(it == can_fixed_data_frame_records_.end())
+        throw std::runtime_error("Invalid channel group");
+
+    if(frame.data.size() > MAX_CAN_FRAME_DATA_SIZE)
+        throw std::runtime_error("CAN frame data exceeds 64 bytes");
+
+    std::array<uint8_t, CAN_FIXED_DATA_FRAME_RECORD_SIZE> data = {};
+    int offset = 0;
+
+    // Timestamp
+    std::memcpy(data.data() + offset, &time, sizeof(float));
+    offset += sizeof(float);
+
+    // CAN_DataFrame.BusChannel
+    // 8 bits
+    data[offset] = frame.bus_channel;
+    offset += sizeof(uint8_t);
+
+    // CAN_DataFrame.ID, 29 bits
+    // CAN_DataFrame.IDE, 1 bit
+    uint32_t data_pack_0 = (frame.id & 0x1FFFFFFF) | (frame.is_extended_id ? 1u << 31 : 0);
+    std::memcpy(data.data() + offset, &data_pack_0, sizeof(data_pack_0));
+    offset += sizeof(data_pack_0);
+
+    // CAN_DataFrame.Dir, 1 bit
+    // CAN_DataFrame.DataLength, 7 bits
+    data[offset] = (frame.is_transmit ? 1 : 0) | (frame.data.size() << 1);
+    offset += sizeof(uint8_t);
+
+    // CAN_DataFrame.EDL, 1 bit
+    // CAN_DataFrame.BRS, 1 bit
+    // CAN_DataFrame.DLC, 4 bits
+    data[offset] = (frame.is_can_fd ? 1 : 0)
+        | (frame.is_bit_rate_switch ? 1 << 1 : 0)
+        | (ToCanDlc(frame.data.size()) << 2);
+    offset += sizeof(uint8_t);
+
+    // CAN_DataFrame.DataBytes
+    std::memcpy(data.data() + offset, frame.data.data(), frame.data.size());
+
+    return it->second->WriteToWriter(writer, data);
+}
+
 } // namespace eerie_leap::subsys::mdf
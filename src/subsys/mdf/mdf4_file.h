@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <span>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
@@ -12,6 +13,8 @@
 #include "subsys/mdf/mdf4/header_block.h"
 #include "subsys/mdf/mdf4/data_record.h"
 #include "subsys/mdf/mdf4/vlsd_data_record.h"
+#include "mdf4_record_writer.h"
+#include "i_mdf4_block_sink.h"
 #include "mdf_data_type.h"
 
 namespace eerie_leap::subsys::mdf {
@@ -19,6 +22,17 @@ namespace eerie_leap::subsys::mdf {
 using namespace std::chrono;
 using namespace eerie_leap::subsys::canbus;
 
+// CAN data frame as logged, with bus level details CanFrame doesn't carry
+struct Mdf4CanDataFrame {
+    uint8_t bus_channel = 0;
+    uint32_t id = 0;
+    bool is_extended_id = false;
+    bool is_transmit = false;
+    bool is_can_fd = false;
+    bool is_bit_rate_switch = false;
+    std::span<const uint8_t> data;
+};
+
 class Mdf4File {
 private:
     struct CanDataFrameBlocks {
@@ -27,14 +41,42 @@ private:
     };
 
     bool is_finalized_;
+    bool is_created_finalized_;
 
     std::unique_ptr<mdf4::IdBlock> id_block_;
     std::unique_ptr<mdf4::HeaderBlock> header_block_;
     std::unordered_map<std::shared_ptr<mdf4::DataGroupBlock>, std::unordered_set<uint64_t>> data_groups_;
+    // Data groups in file order, index is used as the block writer ID
+    std::vector<std::shared_ptr<mdf4::DataGroupBlock>> data_group_list_;
+    std::unordered_map<std::shared_ptr<mdf4::ChannelGroupBlock>, std::shared_ptr<mdf4::DataGroupBlock>> channel_group_data_groups_;
     std::unordered_map<std::string, std::shared_ptr<mdf4::TextBlock>> text_blocks_;
     std::unordered_map<std::shared_ptr<mdf4::ChannelGroupBlock>, CanDataFrameBlocks> can_data_frame_blocks_;
+    std::unordered_map<std::shared_ptr<mdf4::ChannelGroupBlock>, std::shared_ptr<mdf4::DataRecord>> can_fixed_data_frame_records_;
 
+    static constexpr size_t MAX_CAN_DATA_FRAME_RECORD_SIZE = 32;
+    static constexpr size_t MAX_CAN_FRAME_DATA_SIZE = 64;
+    // Timestamp, bus channel, ID, Dir/DataLength, EDL/BRS/DLC, DataBytes
+    static constexpr size_t CAN_FIXED_DATA_FRAME_RECORD_SIZE = 4 + 1 + 4 + 1 + 1 + MAX_CAN_FRAME_DATA_SIZE;
+
+    static std::unique_ptr<mdf4::IdBlock> CreateIdBlock(bool is_finalized);
     std::shared_ptr<mdf4::ChannelBlock> CreateChannelBlock(MdfDataType data_type, std::string name, std::string unit = "");
+    std::shared_ptr<mdf4::ChannelBlock> CreateBusEventChannelBlock(
+        const std::string& name,
+        uint32_t offset_bytes,
+        uint8_t offset_bits,
+        uint32_t bit_count);
+    std::shared_ptr<mdf4::ChannelGroupBlock> CreateCanBusEventChannelGroup(
+        std::shared_ptr<mdf4::DataGroupBlock> data_group,
+        uint64_t record_id,
+        const std::string& name);
+    const CanDataFrameBlocks& GetCanDataFrameBlocks(const std::shared_ptr<mdf4::ChannelGroupBlock>& channel_group) const;
+    static uint8_t ToCanDlc(size_t data_length);
+    std::span<uint8_t> BuildCanbusDataRecord(
+        const std::shared_ptr<mdf4::ChannelGroupBlock>& channel_group,
+        const CanDataFrameBlocks& can_data_frame_block,
+        const Mdf4CanDataFrame& frame,
+        float time,
+        std::span<uint8_t, MAX_CAN_DATA_FRAME_RECORD_SIZE> buffer) const;
 
 public:
     static constexpr char* LOG_DATA_FILE_EXTENSION = "mf4";
@@ -46,6 +88,8 @@ public:
 
     std::shared_ptr<mdf4::DataGroupBlock> CreateDataGroup(uint8_t record_id_size_bytes);
     const std::vector<std::shared_ptr<mdf4::DataGroupBlock>> GetDataGroups() const;
+    uint32_t GetDataGroupIndex(const std::shared_ptr<mdf4::DataGroupBlock>& data_group) const;
+    uint32_t GetDataGroupIndex(const std::shared_ptr<mdf4::ChannelGroupBlock>& channel_group) const;
 
     std::shared_ptr<mdf4::ChannelGroupBlock> CreateChannelGroup(std::shared_ptr<mdf4::DataGroupBlock> data_group, uint64_t record_id, const std::string& name);
     std::shared_ptr<mdf4::ChannelGroupBlock> CreateVLSDChannelGroup(std::shared_ptr<mdf4::DataGroupBlock> data_group, uint64_t record_id);
@@ -54,6 +98,14 @@ public:
         std::shared_ptr<mdf4::ChannelGroupBlock> vlsd_channel_group,
         uint64_t record_id,
         const std::string& name);
+    // Bus logging fixed length variant, payload is stored inline in a
+    // 64 byte DataBytes channel, so each frame is a single record.
+    // NOTE: BusChannel takes 8 bits, frames of all buses share the group.
+    std::shared_ptr<mdf4::ChannelGroupBlock> CreateCanDataFrameFixedChannelGroup(
+        std::shared_ptr<mdf4::DataGroupBlock> data_group,
+        uint64_t record_id,
+        const std::string& name);
+    bool IsCanDataFrameFixedChannelGroup(const std::shared_ptr<mdf4::ChannelGroupBlock>& channel_group) const;
     std::shared_ptr<mdf4::ChannelBlock> CreateDataChannel(
         std::shared_ptr<mdf4::ChannelGroupBlock> channel_group,
         MdfDataType data_type,
@@ -63,11 +115,36 @@ public:
     std::shared_ptr<mdf4::TextBlock> GetOrCreateTextBlock(const std::string& name);
 
     uint64_t WriteFileToStream(std::streambuf& stream) const;
+    // NOTE: Data group index is used as writer ID, valid once the file
+    // is written to the stream.
+    void EnableDataList(IMdf4BlockSink& sink, const std::shared_ptr<mdf4::DataGroupBlock>& data_group) const;
+    void EnableDataLists(IMdf4BlockSink& sink) const;
+    // Patches channel group cycle counts and marks the file finalized,
+    // stream is left positioned at its end.
+    void FinalizeStream(std::streambuf& stream);
+    // Undoes FinalizeStream for a file created unfinalized, so the same
+    // layout can be written to the next file of a rotated log.
+    void ResetFinalized();
     uint64_t WriteCanbusDataRecordToStream(
         std::shared_ptr<mdf4::ChannelGroupBlock> channel_group,
         std::streambuf& stream,
         const CanFrame& can_frame,
         float time) const;
+    uint64_t WriteCanbusDataRecord(
+        std::shared_ptr<mdf4::ChannelGroupBlock> channel_group,
+        Mdf4RecordWriter& writer,
+        const CanFrame& can_frame,
+        float time) const;
+    uint64_t WriteCanbusDataRecord(
+        const std::shared_ptr<mdf4::ChannelGroupBlock>& channel_group,
+        Mdf4RecordWriter& writer,
+        const Mdf4CanDataFrame& frame,
+        float time) const;
+    uint64_t WriteCanbusFixedDataRecord(
+        const std::shared_ptr<mdf4::ChannelGroupBlock>& channel_group,
+        Mdf4RecordWriter& writer,
+        const Mdf4CanDataFrame& frame,
+        float time) const;
 };
 
 } // namespace eerie_leap::subsys::mdf
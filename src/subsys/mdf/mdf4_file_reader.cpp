@@ -0,0 +1,568 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <ios>
+#include <stdexcept>
+
+#include "mdf4_file_reader.h"
+
+namespace eerie_leap::subsys::mdf {
+
+Mdf4FileReader::Mdf4FileReader(std::streambuf& stream)
+    : stream_(stream),
+    file_size_(0),
+    stream_position_(UNKNOWN_POSITION),
+    is_finalized_(false),
+    version_(0),
+    start_time_ns_(0) {}
+
+// NOTE: Sequential reads skip the seek, most of the file is read in order
+void Mdf4FileReader::ReadAt(uint64_t address, void* data, size_t size) {
+    if(address + size > file_size_)
+        throw std::ios_base::failure("End of stream reached (EOF).");
+
+    if(address != stream_position_ && stream_.pubseekpos(address, std::ios_base::in) != address) {
+        stream_position_ = UNKNOWN_POSITION;
+        throw std::ios_base::failure("Failed to seek MDF stream.");
+    }
+
+    if(stream_.sgetn(reinterpret_cast<char*>(data), size) != size) {
+        stream_position_ = UNKNOWN_POSITION;
+        throw std::ios_base::failure("End of stream reached (EOF).");
+    }
+
+    stream_position_ = address + size;
+}
+
+Mdf4FileReader::BlockHeader Mdf4FileReader::ReadBlockHeader(uint64_t address) {
+    if(address % 8 != 0 || address < ID_BLOCK_SIZE || address + sizeof(BlockHeader) > file_size_)
+        throw std::runtime_error("Invalid MDF block address");
+
+    BlockHeader header;
+    ReadAt(address, &header, sizeof(BlockHeader));
+
+    if(header.id[0] != '#' || header.id[1] != '#'
+        || header.length < sizeof(BlockHeader) + header.link_count * 8
+        || header.length > file_size_ - address) {
+
+        throw std::runtime_error("Invalid MDF block");
+    }
+
+    return header;
+}
+
+Mdf4FileReader::BlockHeader Mdf4FileReader::ReadBlockHeader(uint64_t address, const char* id) {
+    auto header = ReadBlockHeader(address);
+    if(std::memcmp(header.id, id, 4) != 0)
+        throw std::runtime_error("Unexpected MDF block");
+
+    return header;
+}
+
+uint64_t Mdf4FileReader::ReadLink(uint64_t block_address, size_t link_index) {
+    uint64_t link = 0;
+    ReadAt(block_address + sizeof(BlockHeader) + link_index * 8, &link, sizeof(link));
+
+    return link;
+}
+
+std::string Mdf4FileReader::ReadText(uint64_t address) {
+    if(address == 0)
+        return "";
+
+    auto header = ReadBlockHeader(address);
+    if(std::memcmp(header.id, "##TX", 4) != 0 && std::memcmp(header.id, "##MD", 4) != 0)
+        throw std::runtime_error("Unexpected MDF block");
+
+    std::string text(std::min<uint64_t>(header.length - sizeof(BlockHeader), MAX_TEXT_SIZE), '\0');
+    ReadAt(address + sizeof(BlockHeader), text.data(), text.size());
+    text.resize(std::strlen(text.c_str()));
+
+    return text;
+}
+
+Mdf4ReaderChannel Mdf4FileReader::ReadChannel(uint64_t address) {
+    auto header = ReadBlockHeader(address, "##CN");
+    if(header.link_count < 7)
+        throw std::runtime_error("Invalid MDF channel block");
+
+    // Type, sync type, data type, bit offset, byte offset, bit count, flags
+    uint64_t data_address = address + sizeof(BlockHeader) + header.link_count * 8;
+
+    Mdf4ReaderChannel channel;
+    ReadAt(data_address, &channel.type, sizeof(channel.type));
+    ReadAt(data_address + 1, &channel.sync_type, sizeof(channel.sync_type));
+    ReadAt(data_address + 2, &channel.data_type, sizeof(channel.data_type));
+    ReadAt(data_address + 3, &channel.bit_offset, sizeof(channel.bit_offset));
+    ReadAt(data_address + 4, &channel.byte_offset, sizeof(channel.byte_offset));
+    ReadAt(data_address + 8, &channel.bit_count, sizeof(channel.bit_count));
+    ReadAt(data_address + 12, &channel.flags, sizeof(channel.flags));
+
+    channel.name = ReadText(ReadLink(address, 2));
+    channel.unit = ReadText(ReadLink(address, 6));
+
+    return channel;
+}
+
+Mdf4ReaderChannelGroup Mdf4FileReader::ReadChannelGroup(uint64_t address) {
+    auto header = ReadBlockHeader(address, "##CG");
+    if(header.link_count < 3)
+        throw std::runtime_error("Invalid MDF channel group block");
+
+    // Record ID, cycle count, flags, path separator, reserved, data bytes, invalidation bytes
+    uint64_t data_address = address + sizeof(BlockHeader) + header.link_count * 8;
+
+    Mdf4ReaderChannelGroup channel_group = { .time_channel_index = -1 };
+    ReadAt(data_address, &channel_group.record_id, sizeof(channel_group.record_id));
+    ReadAt(data_address + 8, &channel_group.cycle_count, sizeof(channel_group.cycle_count));
+    ReadAt(data_address + 16, &channel_group.flags, sizeof(channel_group.flags));
+    ReadAt(data_address + 24, &channel_group.data_bytes, sizeof(channel_group.data_bytes));
+    ReadAt(data_address + 28, &channel_group.invalidation_bytes, sizeof(channel_group.invalidation_bytes));
+
+    channel_group.name = ReadText(ReadLink(address, 2));
+
+    uint64_t channel_address = ReadLink(address, 1);
+    while(channel_address != 0) {
+        if(channel_group.channels.size() >= MAX_CHAIN_LENGTH)
+            throw std::runtime_error("MDF channel chain too long");
+
+        auto channel = ReadChannel(channel_address);
+
+        if(channel_group.time_channel_index < 0
+            && channel.type == mdf4::ChannelBlock::Type::Master
+            && channel.sync_type == mdf4::ChannelBlock::SyncType::Time) {
+
+            channel_group.time_channel_index = channel_group.channels.size();
+        }
+
+        channel_group.channels.push_back(std::move(channel));
+        channel_address = ReadLink(channel_address, 0);
+    }
+
+    return channel_group;
+}
+
+void Mdf4FileReader::Open() {
+    data_groups_.clear();
+    stream_position_ = UNKNOWN_POSITION;
+
+    auto file_size = stream_.pubseekoff(0, std::ios_base::end, std::ios_base::in);
+    if(file_size < static_cast<std::streamoff>(ID_BLOCK_SIZE))
+        throw std::runtime_error("Invalid MDF file");
+
+    file_size_ = static_cast<uint64_t>(file_size);
+
+    char id[8];
+    ReadAt(0, id, sizeof(id));
+
+    if(std::memcmp(id, "MDF     ", sizeof(id)) == 0)
+        is_finalized_ = true;
+    else if(std::memcmp(id, "UnFinMF ", sizeof(id)) == 0)
+        is_finalized_ = false;
+    else
+        throw std::runtime_error("Invalid MDF file");
+
+    ReadAt(28, &version_, sizeof(version_));
+    if(version_ < 400)
+        throw std::runtime_error("Unsupported MDF version");
+
+    auto header_block = ReadBlockHeader(ID_BLOCK_SIZE, "##HD");
+    if(header_block.link_count < 1)
+        throw std::runtime_error("Invalid MDF header block");
+
+    ReadAt(ID_BLOCK_SIZE + sizeof(BlockHeader) + header_block.link_count * 8, &start_time_ns_, sizeof(start_time_ns_));
+
+    uint64_t data_group_address = ReadLink(ID_BLOCK_SIZE, 0);
+    while(data_group_address != 0) {
+        if(data_groups_.size() >= MAX_CHAIN_LENGTH)
+            throw std::runtime_error("MDF data group chain too long");
+
+        auto data_group_header = ReadBlockHeader(data_group_address, "##DG");
+        if(data_group_header.link_count < 3)
+            throw std::runtime_error("Invalid MDF data group block");
+
+        Mdf4ReaderDataGroup data_group = { .data_address = ReadLink(data_group_address, 2) };
+        ReadAt(
+            data_group_address + sizeof(BlockHeader) + data_group_header.link_count * 8,
+            &data_group.record_id_size_bytes,
+            sizeof(data_group.record_id_size_bytes));
+
+        if(data_group.record_id_size_bytes > sizeof(uint64_t))
+            throw std::runtime_error("Invalid MDF data group block");
+
+        uint64_t channel_group_address = ReadLink(data_group_address, 1);
+        while(channel_group_address != 0) {
+            if(data_group.channel_groups.size() >= MAX_CHAIN_LENGTH)
+                throw std::runtime_error("MDF channel group chain too long");
+
+            data_group.channel_groups.push_back(ReadChannelGroup(channel_group_address));
+            channel_group_address = ReadLink(channel_group_address, 0);
+        }
+
+        data_groups_.push_back(std::move(data_group));
+        data_group_address = ReadLink(data_group_address, 0);
+    }
+}
+
+double Mdf4FileReader::DecodeValue(const Mdf4ReaderChannel& channel, std::span<const uint8_t> record_data) {
+    size_t byte_count = (channel.bit_offset + channel.bit_count + 7) / 8;
+    if(channel.bit_count == 0 || byte_count > sizeof(uint64_t))
+        throw std::invalid_argument("Unsupported channel layout");
+
+    if(channel.byte_offset + byte_count > record_data.size())
+        throw std::out_of_range("Channel outside of record");
+
+    uint64_t raw = 0;
+    std::memcpy(&raw, record_data.data() + channel.byte_offset, byte_count);
+    raw >>= channel.bit_offset;
+    if(channel.bit_count < 64)
+        raw &= (1ULL << channel.bit_count) - 1;
+
+    switch(channel.data_type) {
+    case mdf4::ChannelBlock::DataType::UnsignedIntegerLe:
+        return static_cast<double>(raw);
+
+    case mdf4::ChannelBlock::DataType::SignedIntegerLe:
+        if(channel.bit_count < 64 && (raw & (1ULL << (channel.bit_count - 1))) != 0)
+            raw |= ~0ULL << channel.bit_count;
+        return static_cast<double>(static_cast<int64_t>(raw));
+
+    case mdf4::ChannelBlock::DataType::FloatLe:
+        if(channel.bit_count == 32)
+            return std::bit_cast<float>(static_cast<uint32_t>(raw));
+        if(channel.bit_count == 64)
+            return std::bit_cast<double>(raw);
+        throw std::invalid_argument("Unsupported channel layout");
+
+    default:
+        throw std::invalid_argument("Unsupported channel data type");
+    }
+}
+
+Mdf4RecordReader::Mdf4RecordReader(
+    Mdf4FileReader& file_reader,
+    size_t data_group_index,
+    std::pmr::memory_resource* mr)
+        : file_reader_(file_reader),
+        data_group_(file_reader.data_groups_.at(data_group_index)),
+        cursor_(),
+        record_cursor_(),
+        list_count_(0),
+        list_next_(0),
+        block_data_size_(0),
+        is_block_compressed_(false),
+        is_end_(false),
+        compressed_buffer_(mr),
+        block_buffer_(mr),
+        transposed_buffer_(mr),
+        record_buffer_(mr),
+        time_index_(mr) {
+
+    Rewind();
+}
+
+bool Mdf4RecordReader::OpenList(uint64_t list_address) {
+    auto header = file_reader_.ReadBlockHeader(list_address, "##DL");
+    if(header.link_count < 1)
+        throw std::runtime_error("Invalid MDF data list block");
+
+    cursor_.list_address = list_address;
+    cursor_.list_index = 0;
+    list_count_ = header.link_count - 1;
+    list_next_ = file_reader_.ReadLink(list_address, 0);
+
+    // NOTE: Lists are written in file order, guards against link loops
+    if(list_next_ != 0 && list_next_ <= list_address)
+        throw std::runtime_error("Invalid MDF data list link");
+
+    return list_count_ > 0;
+}
+
+void Mdf4RecordReader::InflateBlock(uint64_t block_address) {
+    // Original block type, zip type, reserved, zip parameter, original length, compressed length
+    char block_type[2];
+    uint8_t zip_type = 0;
+    uint32_t zip_parameter = 0;
+    uint64_t original_data_length = 0;
+    uint64_t data_length = 0;
+
+    uint64_t data_address = block_address + sizeof(Mdf4FileReader::BlockHeader);
+    file_reader_.ReadAt(data_address, block_type, sizeof(block_type));
+    file_reader_.ReadAt(data_address + 2, &zip_type, sizeof(zip_type));
+    file_reader_.ReadAt(data_address + 4, &zip_parameter, sizeof(zip_parameter));
+    file_reader_.ReadAt(data_address + 8, &original_data_length, sizeof(original_data_length));
+    file_reader_.ReadAt(data_address + 16, &data_length, sizeof(data_length));
+
+    if(std::memcmp(block_type, "DT", 2) != 0
+        || zip_type > 1
+        || original_data_length > CONFIG_EERIE_LEAP_MDF_READER_MAX_BLOCK_SIZE
+        || data_length > CONFIG_EERIE_LEAP_MDF_READER_MAX_BLOCK_SIZE) {
+
+        throw std::runtime_error("Unsupported MDF DZ block");
+    }
+
+    compressed_buffer_.resize(data_length);
+    file_reader_.ReadAt(block_address + DZ_BLOCK_HEADER_SIZE, compressed_buffer_.data(), data_length);
+
+    if(decompressor_ == nullptr)
+        decompressor_ = std::make_unique<InflateDecompressor>();
+
+    block_buffer_.resize(original_data_length);
+    auto& output = zip_type == 1 ? transposed_buffer_ : block_buffer_;
+    output.resize(original_data_length);
+
+    if(decompressor_->Decompress(compressed_buffer_, output) != original_data_length)
+        throw std::runtime_error("Invalid MDF DZ block");
+
+    if(zip_type == 1) {
+        // Column major order for complete records, remaining bytes as is
+        size_t column_count = zip_parameter;
+        size_t row_count = column_count > 0 ? original_data_length / column_count : 0;
+        for(size_t row = 0; row < row_count; row++) {
+            for(size_t column = 0; column < column_count; column++)
+                block_buffer_[row * column_count + column] = transposed_buffer_[column * row_count + row];
+        }
+
+        size_t transposed_size = row_count * column_count;
+        std::copy(
+            transposed_buffer_.begin() + transposed_size,
+            transposed_buffer_.end(),
+            block_buffer_.begin() + transposed_size);
+    }
+
+    block_data_size_ = original_data_length;
+}
+
+void Mdf4RecordReader::LoadBlock(uint64_t block_address) {
+    auto header = file_reader_.ReadBlockHeader(block_address);
+
+    if(std::memcmp(header.id, "##DT", 4) == 0) {
+        is_block_compressed_ = false;
+        block_data_size_ = header.length - sizeof(Mdf4FileReader::BlockHeader);
+    } else if(std::memcmp(header.id, "##DZ", 4) == 0) {
+        if(header.length < DZ_BLOCK_HEADER_SIZE)
+            throw std::runtime_error("Invalid MDF DZ block");
+
+        is_block_compressed_ = true;
+        InflateBlock(block_address);
+    } else {
+        throw std::runtime_error("Unsupported MDF data block");
+    }
+
+    cursor_.block_address = block_address;
+    cursor_.block_offset = 0;
+}
+
+bool Mdf4RecordReader::NextBlock() {
+    if(cursor_.list_address == 0)
+        return false;
+
+    uint32_t list_index = cursor_.list_index + 1;
+    while(list_index >= list_count_) {
+        if(list_next_ == 0)
+            return false;
+
+        OpenList(list_next_);
+        list_index = 0;
+    }
+
+    cursor_.list_index = list_index;
+    LoadBlock(file_reader_.ReadLink(cursor_.list_address, 1 + list_index));
+
+    return true;
+}
+
+void Mdf4RecordReader::RestoreCursor(const DataCursor& cursor) {
+    if(cursor.block_address != cursor_.block_address) {
+        if(cursor.list_address == 0) {
+            list_count_ = 0;
+            list_next_ = 0;
+        } else if(cursor.list_address != cursor_.list_address) {
+            OpenList(cursor.list_address);
+        }
+
+        if(cursor.block_address != 0)
+            LoadBlock(cursor.block_address);
+        else
+            block_data_size_ = 0;
+    }
+
+    cursor_ = cursor;
+    is_end_ = false;
+}
+
+size_t Mdf4RecordReader::ReadData(uint8_t* data, size_t size) {
+    size_t read_size = 0;
+
+    while(read_size < size) {
+        if(cursor_.block_offset >= block_data_size_) {
+            if(!NextBlock())
+                break;
+
+            continue;
+        }
+
+        size_t chunk_size = std::min<uint64_t>(size - read_size, block_data_size_ - cursor_.block_offset);
+
+        if(is_block_compressed_) {
+            std::memcpy(data + read_size, block_buffer_.data() + cursor_.block_offset, chunk_size);
+        } else {
+            file_reader_.ReadAt(
+                cursor_.block_address + sizeof(Mdf4FileReader::BlockHeader) + cursor_.block_offset,
+                data + read_size,
+                chunk_size);
+        }
+
+        cursor_.block_offset += chunk_size;
+        read_size += chunk_size;
+    }
+
+    return read_size;
+}
+
+void Mdf4RecordReader::Rewind() {
+    cursor_ = {};
+    list_count_ = 0;
+    list_next_ = 0;
+    block_data_size_ = 0;
+    is_end_ = data_group_.data_address == 0;
+
+    if(is_end_)
+        return;
+
+    auto header = file_reader_.ReadBlockHeader(data_group_.data_address);
+
+    if(std::memcmp(header.id, "##DL", 4) == 0) {
+        if(OpenList(data_group_.data_address))
+            LoadBlock(file_reader_.ReadLink(data_group_.data_address, 1));
+    } else {
+        LoadBlock(data_group_.data_address);
+    }
+}
+
+bool Mdf4RecordReader::Next(Mdf4Record& record) {
+    if(is_end_)
+        return false;
+
+    record_cursor_ = cursor_;
+
+    // Read of the first record field tells the end of data
+    auto read_first = [this](void* data, size_t size) {
+        size_t read_size = ReadData(static_cast<uint8_t*>(data), size);
+        if(read_size == 0) {
+            is_end_ = true;
+            return false;
+        }
+
+        if(read_size != size)
+            throw std::runtime_error("Truncated MDF record");
+
+        return true;
+    };
+
+    size_t channel_group_index = 0;
+
+    if(data_group_.record_id_size_bytes > 0) {
+        uint64_t record_id = 0;
+        if(!read_first(&record_id, data_group_.record_id_size_bytes))
+            return false;
+
+        auto it = std::find_if(
+            data_group_.channel_groups.begin(),
+            data_group_.channel_groups.end(),
+            [record_id](const Mdf4ReaderChannelGroup& channel_group) {
+                return channel_group.record_id == record_id; });
+
+        if(it == data_group_.channel_groups.end())
+            throw std::runtime_error("Unknown MDF record ID");
+
+        channel_group_index = std::distance(data_group_.channel_groups.begin(), it);
+    } else if(data_group_.channel_groups.size() != 1) {
+        throw std::runtime_error("Invalid MDF data group");
+    }
+
+    const auto& channel_group = data_group_.channel_groups[channel_group_index];
+
+    uint64_t size_bytes = channel_group.data_bytes + channel_group.invalidation_bytes;
+    if(channel_group.IsVlsd()) {
+        uint32_t length = 0;
+        if(data_group_.record_id_size_bytes > 0) {
+            if(ReadData(reinterpret_cast<uint8_t*>(&length), sizeof(length)) != sizeof(length))
+                throw std::runtime_error("Truncated MDF record");
+        } else if(!read_first(&length, sizeof(length))) {
+            return false;
+        }
+
+        size_bytes = length;
+    }
+
+    if(size_bytes > MAX_RECORD_SIZE)
+        throw std::runtime_error("Invalid MDF record size");
+
+    record_buffer_.resize(size_bytes);
+
+    if(data_group_.record_id_size_bytes > 0 || channel_group.IsVlsd()) {
+        if(ReadData(record_buffer_.data(), size_bytes) != size_bytes)
+            throw std::runtime_error("Truncated MDF record");
+    } else if(!read_first(record_buffer_.data(), size_bytes)) {
+        return false;
+    }
+
+    record.channel_group_index = channel_group_index;
+    record.data = record_buffer_;
+    record.time = std::nullopt;
+
+    if(channel_group.time_channel_index >= 0) {
+        record.time = Mdf4FileReader::DecodeValue(
+            channel_group.channels[channel_group.time_channel_index],
+            record.data);
+    }
+
+    return true;
+}
+
+size_t Mdf4RecordReader::BuildTimeIndex(uint32_t interval_ms) {
+    time_index_.clear();
+    Rewind();
+
+    double interval = interval_ms / 1000.0;
+
+    Mdf4Record record;
+    while(Next(record)) {
+        if(!record.time.has_value())
+            continue;
+
+        // NOTE: Entries only go forward in time, keeps the index sorted
+        if(time_index_.empty() || record.time.value() >= time_index_.back().time + interval)
+            time_index_.push_back({ record.time.value(), record_cursor_ });
+    }
+
+    Rewind();
+
+    return time_index_.size();
+}
+
+bool Mdf4RecordReader::Seek(double time) {
+    auto it = std::upper_bound(
+        time_index_.begin(),
+        time_index_.end(),
+        time,
+        [](double time, const TimeIndexEntry& entry) { return time < entry.time; });
+
+    if(it == time_index_.begin())
+        Rewind();
+    else
+        RestoreCursor(std::prev(it)->cursor);
+
+    Mdf4Record record;
+    while(Next(record)) {
+        if(record.time.has_value() && record.time.value() >= time) {
+            RestoreCursor(record_cursor_);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace eerie_leap::subsys::mdf
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "utilities/compression/inflate_decompressor.h"
+#include "utilities/memory/memory_resource_manager.h"
+#include "subsys/mdf/mdf4/channel_block.h"
+
+namespace eerie_leap::subsys::mdf {
+
+using namespace eerie_leap::utilities::compression;
+using namespace eerie_leap::utilities::memory;
+
+struct Mdf4ReaderChannel {
+    std::string name;
+    std::string unit;
+    mdf4::ChannelBlock::Type type;
+    mdf4::ChannelBlock::SyncType sync_type;
+    mdf4::ChannelBlock::DataType data_type;
+    uint8_t bit_offset;
+    uint32_t byte_offset;
+    uint32_t bit_count;
+    uint32_t flags;
+};
+
+struct Mdf4ReaderChannelGroup {
+    std::string name;
+    uint64_t record_id;
+    uint64_t cycle_count;
+    uint16_t flags;
+    uint32_t data_bytes;
+    uint32_t invalidation_bytes;
+    std::vector<Mdf4ReaderChannel> channels;
+    // Index of the time master channel, -1 if the group has none
+    int32_t time_channel_index;
+
+    bool IsVlsd() const { return (flags & 0x01) != 0; }
+};
+
+struct Mdf4ReaderDataGroup {
+    uint64_t data_address;
+    uint8_t record_id_size_bytes;
+    std::vector<Mdf4ReaderChannelGroup> channel_groups;
+};
+
+struct Mdf4Record {
+    size_t channel_group_index;
+    // Master channel value in seconds, empty for groups without one
+    std::optional<double> time;
+    // Record bytes following the record ID, for VLSD records the
+    // signal data following the length
+    std::span<const uint8_t> data;
+};
+
+// Parses MDF4 file structure, ID, HD, DG, CG and CN blocks, records are
+// read through Mdf4RecordReader. Only block metadata is kept in RAM.
+// NOTE: Channel conversions are not applied, values are raw. Unfinalized
+// files are readable up to their last linked data block, run
+// Mdf4FileRecovery first to get the rest.
+class Mdf4FileReader {
+private:
+    friend class Mdf4RecordReader;
+
+    struct BlockHeader {
+        char id[4];
+        uint32_t reserved;
+        uint64_t length;
+        uint64_t link_count;
+    };
+
+    static constexpr size_t ID_BLOCK_SIZE = 64;
+    static constexpr size_t MAX_CHAIN_LENGTH = 4096;
+    static constexpr size_t MAX_TEXT_SIZE = 256;
+    static constexpr uint64_t UNKNOWN_POSITION = UINT64_MAX;
+
+    std::streambuf& stream_;
+    uint64_t file_size_;
+    uint64_t stream_position_;
+
+    bool is_finalized_;
+    uint16_t version_;
+    uint64_t start_time_ns_;
+    std::vector<Mdf4ReaderDataGroup> data_groups_;
+
+    void ReadAt(uint64_t address, void* data, size_t size);
+    BlockHeader ReadBlockHeader(uint64_t address);
+    BlockHeader ReadBlockHeader(uint64_t address, const char* id);
+    uint64_t ReadLink(uint64_t block_address, size_t link_index);
+    std::string ReadText(uint64_t address);
+
+    Mdf4ReaderChannelGroup ReadChannelGroup(uint64_t address);
+    Mdf4ReaderChannel ReadChannel(uint64_t address);
+
+public:
+    explicit Mdf4FileReader(std::streambuf& stream);
+
+    // Throws if the stream isn't a readable MDF4 file
+    void Open();
+
+    bool IsFinalized() const { return is_finalized_; }
+    uint16_t GetVersion() const { return version_; }
+    uint64_t GetStartTimeNs() const { return start_time_ns_; }
+    const std::vector<Mdf4ReaderDataGroup>& GetDataGroups() const { return data_groups_; }
+
+    // Decodes little endian integer and float channels from record data
+    static double DecodeValue(const Mdf4ReaderChannel& channel, std::span<const uint8_t> record_data);
+};
+
+// Streams records of a data group in file order. DT blocks are read in
+// place, DZ blocks are inflated one at a time into a block buffer.
+// Optional sparse time index keeps the position of a record every
+// interval, seeks binary search it and read forward from the entry found.
+// NOTE: Readers share the file reader stream, use them from one thread.
+class Mdf4RecordReader {
+private:
+    struct DataCursor {
+        // DL block holding the data block, 0 if the data group links a single block
+        uint64_t list_address;
+        uint32_t list_index;
+        uint64_t block_address;
+        uint64_t block_offset;
+    };
+
+    struct TimeIndexEntry {
+        double time;
+        DataCursor cursor;
+    };
+
+    static constexpr size_t DZ_BLOCK_HEADER_SIZE = 48;
+    static constexpr size_t MAX_RECORD_SIZE = 65536;
+
+    Mdf4FileReader& file_reader_;
+    const Mdf4ReaderDataGroup& data_group_;
+
+    DataCursor cursor_;
+    DataCursor record_cursor_;
+    uint32_t list_count_;
+    uint64_t list_next_;
+    uint64_t block_data_size_;
+    bool is_block_compressed_;
+    bool is_end_;
+
+    std::unique_ptr<InflateDecompressor> decompressor_;
+    std::pmr::vector<uint8_t> compressed_buffer_;
+    std::pmr::vector<uint8_t> block_buffer_;
+    std::pmr::vector<uint8_t> transposed_buffer_;
+    std::pmr::vector<uint8_t> record_buffer_;
+    std::pmr::vector<TimeIndexEntry> time_index_;
+
+    bool OpenList(uint64_t list_address);
+    void LoadBlock(uint64_t block_address);
+    void InflateBlock(uint64_t block_address);
+    bool NextBlock();
+    void RestoreCursor(const DataCursor& cursor);
+    size_t ReadData(uint8_t* data, size_t size);
+    uint64_t ReadRecordId();
+
+public:
+    Mdf4RecordReader(
+        Mdf4FileReader& file_reader,
+        size_t data_group_index,
+        std::pmr::memory_resource* mr = Mrm::GetExtPmr());
+
+    Mdf4RecordReader(const Mdf4RecordReader&) = delete;
+    Mdf4RecordReader& operator=(const Mdf4RecordReader&) = delete;
+
+    // Record data stays valid until the next call
+    bool Next(Mdf4Record& record);
+    void Rewind();
+
+    // Scans the data group once, returns number of index entries
+    size_t BuildTimeIndex(uint32_t interval_ms = CONFIG_EERIE_LEAP_MDF_READER_INDEX_INTERVAL_MS);
+    size_t GetTimeIndexSize() const { return time_index_.size(); }
+    // Positions the reader at the first record with time at or past the
+    // time given, returns false if there is none
+    bool Seek(double time);
+};
+
+} // namespace eerie_leap::subsys::mdf
@@ -0,0 +1,429 @@
+#include <algorithm>
+#include <cstring>
+#include <ios>
+#include <stdexcept>
+
+#include <zephyr/logging/log.h>
+
+#ifdef CONFIG_EERIE_LEAP_FS
+#include <filesystem>
+
+#include "subsys/fs/services/fs_service_stream_buf.h"
+#endif
+
+#include "mdf4/data_list_block.h"
+#include "mdf4_file.h"
+#include "mdf4_file_recovery.h"
+
+LOG_MODULE_REGISTER(mdf4_file_recovery_logger);
+
+namespace eerie_leap::subsys::mdf {
+
+Mdf4FileRecovery::Mdf4FileRecovery(std::streambuf& stream)
+    : stream_(stream), file_size_(0), recovered_block_count_(0) {}
+
+void Mdf4FileRecovery::ReadAt(uint64_t address, void* data, size_t size) {
+    if(address + size > file_size_ || stream_.pubseekpos(address, std::ios_base::in) != address)
+        throw std::ios_base::failure("Failed to seek MDF stream.");
+
+    if(stream_.sgetn(reinterpret_cast<char*>(data), size) != size)
+        throw std::ios_base::failure("End of stream reached (EOF).");
+}
+
+void Mdf4FileRecovery::WriteAt(uint64_t address, const void* data, size_t size) {
+    if(stream_.pubseekpos(address, std::ios_base::out) != address)
+        throw std::ios_base::failure("Failed to seek MDF stream.");
+
+    if(stream_.sputn(reinterpret_cast<const char*>(data), size) != size)
+        throw std::ios_base::failure("End of stream reached (EOF).");
+}
+
+bool Mdf4FileRecovery::TryReadBlockHeader(uint64_t address, BlockHeader& header) {
+    if(address % 8 != 0 || address < ID_BLOCK_SIZE || address + sizeof(BlockHeader) > file_size_)
+        return false;
+
+    ReadAt(address, &header, sizeof(BlockHeader));
+
+    return header.id[0] == '#' && header.id[1] == '#'
+        && header.length >= sizeof(BlockHeader)
+        && header.length <= file_size_ - address;
+}
+
+bool Mdf4FileRecovery::TryReadBlockTrailer(uint64_t address, uint32_t& writer_id) {
+    if(address + IMdf4BlockSink::BLOCK_TRAILER_SIZE > file_size_)
+        return false;
+
+    char trailer[IMdf4BlockSink::BLOCK_TRAILER_SIZE];
+    ReadAt(address, trailer, sizeof(trailer));
+
+    if(std::memcmp(trailer, IMdf4BlockSink::BLOCK_TRAILER_ID, sizeof(IMdf4BlockSink::BLOCK_TRAILER_ID)) != 0)
+        return false;
+
+    std::memcpy(&writer_id, trailer + sizeof(IMdf4BlockSink::BLOCK_TRAILER_ID), sizeof(writer_id));
+
+    return true;
+}
+
+Mdf4FileRecovery::BlockHeader Mdf4FileRecovery::ReadBlockHeader(uint64_t address, const char* id) {
+    BlockHeader header;
+    if(!TryReadBlockHeader(address, header) || std::memcmp(header.id, id, 4) != 0)
+        throw std::runtime_error("Invalid MDF block");
+
+    return header;
+}
+
+uint64_t Mdf4FileRecovery::ReadLink(uint64_t block_address, size_t link_index) {
+    uint64_t link = 0;
+    ReadAt(block_address + sizeof(BlockHeader) + link_index * 8, &link, sizeof(link));
+
+    return link;
+}
+
+bool Mdf4FileRecovery::IsDataBlock(const BlockHeader& header) {
+    return std::memcmp(header.id, "##DT", 4) == 0 || std::memcmp(header.id, "##DZ", 4) == 0;
+}
+
+uint64_t Mdf4FileRecovery::GetDataSizeBytes(uint64_t address, const BlockHeader& header) {
+    if(std::memcmp(header.id, "##DT", 4) == 0)
+        return header.length - sizeof(BlockHeader);
+
+    // DZ block original data length
+    uint64_t data_size_bytes = 0;
+    ReadAt(address + sizeof(BlockHeader) + 8, &data_size_bytes, sizeof(data_size_bytes));
+
+    return data_size_bytes;
+}
+
+void Mdf4FileRecovery::ReadDataGroups() {
+    auto header_block = ReadBlockHeader(ID_BLOCK_SIZE, "##HD");
+    if(header_block.link_count < 1)
+        throw std::runtime_error("Invalid MDF header block");
+
+    uint64_t data_group_address = ReadLink(ID_BLOCK_SIZE, 0);
+
+    while(data_group_address != 0) {
+        if(data_groups_.size() >= MAX_CHAIN_LENGTH)
+            throw std::runtime_error("MDF data group chain too long");
+
+        auto data_group_header = ReadBlockHeader(data_group_address, "##DG");
+        if(data_group_header.link_count < 3)
+            throw std::runtime_error("Invalid MDF data group block");
+
+        DataGroupInfo data_group = {
+            .address = data_group_address,
+            .link_address = data_group_address + sizeof(BlockHeader) + 2 * 8,
+            .is_link_broken = false,
+            .last_listed_address = 0,
+            .data_list_end = 0,
+            .data_size_bytes = 0
+        };
+        ReadAt(
+            data_group_address + sizeof(BlockHeader) + data_group_header.link_count * 8,
+            &data_group.record_id_size_bytes,
+            sizeof(data_group.record_id_size_bytes));
+
+        uint64_t channel_group_address = ReadLink(data_group_address, 1);
+
+        while(channel_group_address != 0) {
+            if(data_group.channel_groups.size() >= MAX_CHAIN_LENGTH)
+                throw std::runtime_error("MDF channel group chain too long");
+
+            auto channel_group_header = ReadBlockHeader(channel_group_address, "##CG");
+            if(channel_group_header.link_count < 1)
+                throw std::runtime_error("Invalid MDF channel group block");
+
+            // Record ID, cycle count, flags, path separator, reserved, data bytes, invalidation bytes
+            uint64_t data_address = channel_group_address + sizeof(BlockHeader) + channel_group_header.link_count * 8;
+            uint16_t flags = 0;
+            uint32_t data_bytes = 0;
+            uint32_t invalidation_bytes = 0;
+            ReadAt(data_address + 16, &flags, sizeof(flags));
+            ReadAt(data_address + 24, &data_bytes, sizeof(data_bytes));
+            ReadAt(data_address + 28, &invalidation_bytes, sizeof(invalidation_bytes));
+
+            data_group.channel_groups.push_back({
+                .cycle_count_address = data_address + 8,
+                .flags = flags,
+                .record_size_bytes = data_group.record_id_size_bytes + data_bytes + invalidation_bytes
+            });
+
+            channel_group_address = ReadLink(channel_group_address, 0);
+        }
+
+        data_groups_.push_back(std::move(data_group));
+        data_group_address = ReadLink(data_group_address, 0);
+    }
+}
+
+void Mdf4FileRecovery::ReadDataLists(DataGroupInfo& data_group) {
+    uint64_t address = ReadLink(data_group.address, 2);
+    uint64_t previous_address = data_group.address;
+
+    while(address != 0) {
+        BlockHeader header;
+        bool is_valid = address > previous_address && TryReadBlockHeader(address, header);
+
+        // Placeholder data block of a data group nothing was listed for
+        if(is_valid && previous_address == data_group.address
+            && std::memcmp(header.id, "##DT", 4) == 0 && header.length == sizeof(BlockHeader)) {
+
+            return;
+        }
+
+        is_valid = is_valid
+            && std::memcmp(header.id, "##DL", 4) == 0
+            && header.link_count >= 2
+            && header.length == mdf4::DataListBlock::GetBlockSize(header.link_count - 1);
+
+        uint64_t last_block_address = 0;
+        BlockHeader last_block_header;
+        if(is_valid) {
+            last_block_address = ReadLink(address, header.link_count - 1);
+            is_valid = TryReadBlockHeader(last_block_address, last_block_header) && IsDataBlock(last_block_header);
+        }
+
+        if(!is_valid) {
+            data_group.is_link_broken = true;
+            return;
+        }
+
+        uint64_t last_data_offset = 0;
+        ReadAt(address + header.length - 8, &last_data_offset, sizeof(last_data_offset));
+
+        data_group.data_size_bytes = last_data_offset + GetDataSizeBytes(last_block_address, last_block_header);
+        data_group.last_listed_address = last_block_address;
+        data_group.data_list_end = address + header.length;
+        data_group.link_address = address + mdf4::DataListBlock::NEXT_LINK_OFFSET;
+
+        previous_address = address;
+        address = ReadLink(address, 0);
+    }
+}
+
+// Walks block headers from the address, returns end of the last complete block
+uint64_t Mdf4FileRecovery::ScanTail(uint64_t address) {
+    static constexpr char empty_id[4] = {};
+
+    uint64_t end = address;
+
+    while(address + sizeof(BlockHeader) <= file_size_) {
+        BlockHeader header;
+        ReadAt(address, &header, sizeof(BlockHeader));
+
+        // Data blocks start on sector boundaries, gap before them is zeroed
+        if(std::memcmp(header.id, empty_id, 4) == 0) {
+            if(address % SECTOR_SIZE == 0)
+                break;
+
+            address += SECTOR_SIZE - address % SECTOR_SIZE;
+            continue;
+        }
+
+        if(!TryReadBlockHeader(address, header))
+            break;
+
+        uint64_t block_end = address + (header.length + 7) / 8 * 8;
+
+        // Data blocks without a trailer can't be assigned to a data group
+        uint32_t writer_id = UINT32_MAX;
+        if(IsDataBlock(header) && TryReadBlockTrailer(block_end, writer_id))
+            block_end += IMdf4BlockSink::BLOCK_TRAILER_SIZE;
+
+        if(IsDataBlock(header) && header.length > sizeof(BlockHeader) && writer_id < data_groups_.size()) {
+            auto& data_group = data_groups_[writer_id];
+
+            if(address > data_group.last_listed_address) {
+                data_group.data_blocks.push_back({
+                    .address = address,
+                    .size_bytes = header.length,
+                    .data_size_bytes = GetDataSizeBytes(address, header),
+                    .writer_id = writer_id
+                });
+            }
+        }
+
+        address = block_end;
+        end = address;
+    }
+
+    return end;
+}
+
+void Mdf4FileRecovery::WriteDataLists(uint64_t address) {
+    for(auto& data_group : data_groups_) {
+        if(data_group.data_blocks.empty()) {
+            if(data_group.is_link_broken) {
+                uint64_t link = 0;
+                WriteAt(data_group.link_address, &link, sizeof(link));
+            }
+
+            continue;
+        }
+
+        std::span<const Mdf4DataBlockInfo> data_blocks(data_group.data_blocks);
+
+        while(!data_blocks.empty()) {
+            auto list_blocks = data_blocks.first(std::min<size_t>(data_blocks.size(), CONFIG_EERIE_LEAP_MDF_DATA_LIST_SIZE));
+            data_blocks = data_blocks.subspan(list_blocks.size());
+
+            std::vector<uint8_t> buffer(mdf4::DataListBlock::GetBlockSize(list_blocks.size()));
+            mdf4::DataListBlock::Serialize(list_blocks, data_group.data_size_bytes, buffer);
+
+            WriteAt(address, buffer.data(), buffer.size());
+            stream_.pubsync();
+            WriteAt(data_group.link_address, &address, sizeof(address));
+
+            data_group.link_address = address + mdf4::DataListBlock::NEXT_LINK_OFFSET;
+            for(const auto& data_block : list_blocks)
+                data_group.data_size_bytes += data_block.data_size_bytes;
+
+            address += buffer.size();
+            recovered_block_count_ += list_blocks.size();
+        }
+    }
+}
+
+// Returns ID flags of counts that couldn't be derived from the data size
+uint16_t Mdf4FileRecovery::UpdateCycleCounts() {
+    uint16_t invalid_flags = 0;
+
+    for(const auto& data_group : data_groups_) {
+        if(data_group.data_size_bytes == 0)
+            continue;
+
+        bool has_vlsd_channel = std::any_of(
+            data_group.channel_groups.begin(),
+            data_group.channel_groups.end(),
+            [](const ChannelGroupInfo& channel_group) { return (channel_group.flags & FLAG_VLSD_CHANNEL) != 0; });
+
+        if(has_vlsd_channel)
+            invalid_flags |= FLAG_INVALID_VLSD_DATA_BYTES;
+
+        if(data_group.channel_groups.size() != 1
+            || has_vlsd_channel
+            || data_group.channel_groups.front().record_size_bytes == 0) {
+
+            invalid_flags |= FLAG_INVALID_CG_COUNT;
+            continue;
+        }
+
+        const auto& channel_group = data_group.channel_groups.front();
+        uint64_t cycle_count = data_group.data_size_bytes / channel_group.record_size_bytes;
+        WriteAt(channel_group.cycle_count_address, &cycle_count, sizeof(cycle_count));
+    }
+
+    return invalid_flags;
+}
+
+Mdf4RecoveryResult Mdf4FileRecovery::Recover() {
+    data_groups_.clear();
+    recovered_block_count_ = 0;
+
+    try {
+        auto file_size = stream_.pubseekoff(0, std::ios_base::end, std::ios_base::in);
+        if(file_size < static_cast<std::streamoff>(ID_BLOCK_SIZE))
+            return Mdf4RecoveryResult::Invalid;
+
+        file_size_ = static_cast<uint64_t>(file_size);
+
+        char id[8];
+        uint16_t standard_flags = 0;
+        ReadAt(0, id, sizeof(id));
+        ReadAt(ID_STANDARD_FLAGS_OFFSET, &standard_flags, sizeof(standard_flags));
+
+        if(std::memcmp(id, "MDF     ", sizeof(id)) == 0)
+            return Mdf4RecoveryResult::AlreadyFinalized;
+
+        if(std::memcmp(id, "UnFinMF ", sizeof(id)) != 0)
+            return Mdf4RecoveryResult::Invalid;
+
+        // Recovered before, only counts left for MDF tools to fix
+        if((standard_flags & FLAG_INVALID_LAST_DT_BLOCK) == 0)
+            return Mdf4RecoveryResult::PartiallyRecovered;
+
+        ReadDataGroups();
+
+        uint64_t scan_address = UINT64_MAX;
+        for(auto& data_group : data_groups_) {
+            ReadDataLists(data_group);
+
+            if(data_group.data_list_end > 0)
+                scan_address = std::min(scan_address, data_group.data_list_end);
+        }
+
+        // Without any DL block written the whole file is scanned
+        if(scan_address == UINT64_MAX)
+            scan_address = ID_BLOCK_SIZE;
+
+        uint64_t end = ScanTail((scan_address + 7) / 8 * 8);
+
+        // Last block may end unaligned at the end of the file
+        static constexpr uint8_t padding[8] = {};
+        if(end > file_size_)
+            WriteAt(file_size_, padding, end - file_size_);
+
+        WriteDataLists(end);
+        stream_.pubsync();
+
+        // NOTE: Data blocks are all linked with their length, flags of
+        // counts still invalid are kept for MDF tools to fix.
+        standard_flags = UpdateCycleCounts();
+        bool is_complete = standard_flags == 0;
+        stream_.pubsync();
+
+        WriteAt(ID_STANDARD_FLAGS_OFFSET, &standard_flags, sizeof(standard_flags));
+        if(is_complete)
+            WriteAt(0, "MDF     ", sizeof(id));
+
+        stream_.pubsync();
+
+        LOG_INF("MDF file recovered, %u data blocks linked.", recovered_block_count_);
+
+        return is_complete
+            ? Mdf4RecoveryResult::Recovered
+            : Mdf4RecoveryResult::PartiallyRecovered;
+    } catch(const std::exception& e) {
+        LOG_ERR("Failed to recover MDF file: %s", e.what());
+    }
+
+    return Mdf4RecoveryResult::Invalid;
+}
+
+#ifdef CONFIG_EERIE_LEAP_FS
+uint32_t Mdf4FileRecovery::RecoverDirectory(
+    eerie_leap::subsys::fs::services::IFsService& fs_service,
+    std::string_view relative_path) {
+
+    using namespace eerie_leap::subsys::fs::services;
+
+    const std::string extension = "." + std::string(Mdf4File::LOG_DATA_FILE_EXTENSION);
+    uint32_t recovered_count = 0;
+
+    for(const auto& file_name : fs_service.ListFiles(relative_path)) {
+        if(!file_name.ends_with(extension))
+            continue;
+
+        auto file_path = (std::filesystem::path(relative_path) / file_name).string();
+
+        try {
+            FsServiceStreamBuf stream(&fs_service, file_path, FsServiceStreamBuf::OpenMode::ReadWrite);
+
+            Mdf4FileRecovery recovery(stream);
+            auto result = recovery.Recover();
+
+            if(result == Mdf4RecoveryResult::Recovered || result == Mdf4RecoveryResult::PartiallyRecovered) {
+                LOG_INF("Recovered MDF file %s.", file_path.c_str());
+                recovered_count++;
+            } else if(result == Mdf4RecoveryResult::Invalid) {
+                LOG_ERR("MDF file %s is not recoverable.", file_path.c_str());
+            }
+        } catch(const std::exception& e) {
+            LOG_ERR("Failed to open MDF file %s: %s", file_path.c_str(), e.what());
+        }
+    }
+
+    return recovered_count;
+}
+#endif
+
+} // namespace eerie_leap::subsys::mdf
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <streambuf>
+#include <string_view>
+#include <vector>
+
+#include "i_mdf4_block_sink.h"
+
+#ifdef CONFIG_EERIE_LEAP_FS
+#include "subsys/fs/services/i_fs_service.h"
+#endif
+
+namespace eerie_leap::subsys::mdf {
+
+enum class Mdf4RecoveryResult {
+    AlreadyFinalized,
+    Recovered,
+    // Data is linked, but cycle counts of some channel groups are unknown
+    PartiallyRecovered,
+    Invalid
+};
+
+// Finalizes MDF4 files left unfinalized by a power loss.
+// Data blocks already linked from DL blocks are trusted, only the file
+// past the last DL block written is scanned for blocks, which are
+// assigned to data groups by the writer ID in their trailer and linked
+// from new DL blocks. Cycle counts are derived from the data size for
+// data groups with a single fixed length channel group.
+// NOTE: Records of variable length or multiple channel groups would have
+// to be parsed to be counted, those files keep the unfinalized ID with
+// the cycle count flag set, along with the VLSD data bytes flag for VLSD
+// channel groups, which MDF tools are able to fix.
+class Mdf4FileRecovery {
+private:
+    struct BlockHeader {
+        char id[4];
+        uint32_t reserved;
+        uint64_t length;
+        uint64_t link_count;
+    };
+
+    struct ChannelGroupInfo {
+        uint64_t cycle_count_address;
+        uint16_t flags;
+        uint32_t record_size_bytes;
+    };
+
+    struct DataGroupInfo {
+        uint64_t address;
+        uint8_t record_id_size_bytes;
+        std::vector<ChannelGroupInfo> channel_groups;
+        // Link the next DL block gets patched into
+        uint64_t link_address;
+        // Link points to a block that never made it to the card
+        bool is_link_broken;
+        uint64_t last_listed_address;
+        uint64_t data_list_end;
+        uint64_t data_size_bytes;
+        std::vector<Mdf4DataBlockInfo> data_blocks;
+    };
+
+    static constexpr size_t ID_BLOCK_SIZE = 64;
+    static constexpr size_t ID_STANDARD_FLAGS_OFFSET = 60;
+    static constexpr uint16_t FLAG_INVALID_CG_COUNT = 0x01;
+    static constexpr uint16_t FLAG_INVALID_LAST_DT_BLOCK = 0x04;
+    static constexpr uint16_t FLAG_INVALID_VLSD_DATA_BYTES = 0x20;
+    static constexpr uint16_t FLAG_VLSD_CHANNEL = 0x01;
+    static constexpr size_t MAX_CHAIN_LENGTH = 4096;
+    static constexpr size_t SECTOR_SIZE = 512;
+
+    std::streambuf& stream_;
+    uint64_t file_size_;
+    std::vector<DataGroupInfo> data_groups_;
+    uint32_t recovered_block_count_;
+
+    void ReadAt(uint64_t address, void* data, size_t size);
+    void WriteAt(uint64_t address, const void* data, size_t size);
+    bool TryReadBlockHeader(uint64_t address, BlockHeader& header);
+    bool TryReadBlockTrailer(uint64_t address, uint32_t& writer_id);
+    BlockHeader ReadBlockHeader(uint64_t address, const char* id);
+    uint64_t ReadLink(uint64_t block_address, size_t link_index);
+    static bool IsDataBlock(const BlockHeader& header);
+    uint64_t GetDataSizeBytes(uint64_t address, const BlockHeader& header);
+
+    void ReadDataGroups();
+    void ReadDataLists(DataGroupInfo& data_group);
+    uint64_t ScanTail(uint64_t address);
+    void WriteDataLists(uint64_t address);
+    uint16_t UpdateCycleCounts();
+
+public:
+    explicit Mdf4FileRecovery(std::streambuf& stream);
+
+    Mdf4RecoveryResult Recover();
+    uint32_t GetRecoveredBlockCount() const { return recovered_block_count_; }
+
+#ifdef CONFIG_EERIE_LEAP_FS
+    // Recovers all unfinalized MDF4 files of the directory, meant to run on
+    // boot before logging starts. Returns number of files recovered.
+    static uint32_t RecoverDirectory(
+        eerie_leap::subsys::fs::services::IFsService& fs_service,
+        std::string_view relative_path = "");
+#endif
+};
+
+} // namespace eerie_leap::subsys::mdf
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <cstring>
+
+#include "mdf4_stream_block_sink.h"
+#include "mdf4_record_writer.h"
+
+namespace eerie_leap::subsys::mdf {
+
+Mdf4RecordWriter::Mdf4RecordWriter(
+    std::streambuf& stream,
+    uint64_t stream_address,
+    size_t buffer_size,
+    std::pmr::memory_resource* mr)
+        : owned_sink_(std::make_unique<Mdf4StreamBlockSink>(stream, stream_address, buffer_size, mr)),
+        sink_(*owned_sink_),
+        options_(),
+        buffer_size_(sink_.GetBufferSize() - IMdf4BlockSink::BLOCK_TRAILER_SIZE),
+        buffer_(nullptr),
+        buffer_offset_(IMdf4BlockSink::BLOCK_HEADER_SIZE),
+        data_size_bytes_(0) {}
+
+Mdf4RecordWriter::Mdf4RecordWriter(IMdf4BlockSink& sink, const Mdf4BlockOptions& options)
+    : sink_(sink),
+    options_(options),
+    buffer_size_(sink_.GetBufferSize() - IMdf4BlockSink::BLOCK_TRAILER_SIZE),
+    buffer_(nullptr),
+    buffer_offset_(IMdf4BlockSink::BLOCK_HEADER_SIZE),
+    data_size_bytes_(0) {}
+
+Mdf4RecordWriter::~Mdf4RecordWriter() {
+    try {
+        Flush();
+    } catch(const std::exception& e) {}
+}
+
+void Mdf4RecordWriter::FlushBlock() {
+    uint8_t* buffer = buffer_;
+    size_t size_bytes = buffer_offset_;
+
+    buffer_ = nullptr;
+    buffer_offset_ = IMdf4BlockSink::BLOCK_HEADER_SIZE;
+
+    sink_.SubmitBuffer(buffer, size_bytes, options_);
+}
+
+void Mdf4RecordWriter::Write(std::span<const uint8_t> data) {
+    while(!data.empty()) {
+        if(buffer_ == nullptr)
+            buffer_ = sink_.AcquireBuffer();
+
+        size_t chunk_size = std::min(data.size(), buffer_size_ - buffer_offset_);
+
+        std::memcpy(buffer_ + buffer_offset_, data.data(), chunk_size);
+        buffer_offset_ += chunk_size;
+        data_size_bytes_ += chunk_size;
+        data = data.subspan(chunk_size);
+
+        if(buffer_offset_ == buffer_size_)
+            FlushBlock();
+    }
+}
+
+void Mdf4RecordWriter::Flush() {
+    if(buffer_ != nullptr && buffer_offset_ > IMdf4BlockSink::BLOCK_HEADER_SIZE)
+        FlushBlock();
+
+    sink_.Flush();
+}
+
+std::vector<Mdf4DataBlockInfo> Mdf4RecordWriter::GetDataBlocks() const {
+    auto data_blocks = sink_.GetDataBlocks();
+    std::erase_if(data_blocks, [this](const Mdf4DataBlockInfo& data_block) {
+        return data_block.writer_id != options_.writer_id; });
+
+    return data_blocks;
+}
+
+} // namespace eerie_leap::subsys::mdf
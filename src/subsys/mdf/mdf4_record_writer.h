@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <streambuf>
+#include <vector>
+
+#include "utilities/memory/memory_resource_manager.h"
+#include "i_mdf4_block_sink.h"
+
+namespace eerie_leap::subsys::mdf {
+
+using namespace eerie_leap::utilities::memory;
+
+// Accumulates records in a sink provided, sector aligned buffer and emits
+// them as DT blocks of buffer size.
+// NOTE: Records may be split across blocks, as allowed for DT blocks
+// referenced from a DL block, so every full block has exactly buffer size.
+class Mdf4RecordWriter {
+private:
+    std::unique_ptr<IMdf4BlockSink> owned_sink_;
+    IMdf4BlockSink& sink_;
+    Mdf4BlockOptions options_;
+
+    size_t buffer_size_;
+    uint8_t* buffer_;
+    size_t buffer_offset_;
+
+    uint64_t data_size_bytes_;
+
+    void FlushBlock();
+
+public:
+    // Writes blocks to the stream in the calling thread
+    Mdf4RecordWriter(
+        std::streambuf& stream,
+        uint64_t stream_address,
+        size_t buffer_size = CONFIG_EERIE_LEAP_MDF_RECORD_BUFFER_SIZE,
+        std::pmr::memory_resource* mr = Mrm::GetExtPmr());
+    explicit Mdf4RecordWriter(IMdf4BlockSink& sink, const Mdf4BlockOptions& options = {});
+    ~Mdf4RecordWriter();
+
+    Mdf4RecordWriter(const Mdf4RecordWriter&) = delete;
+    Mdf4RecordWriter& operator=(const Mdf4RecordWriter&) = delete;
+
+    void Write(std::span<const uint8_t> data);
+    void Flush();
+
+    size_t GetBufferSize() const { return buffer_size_; }
+    size_t GetBufferedSizeBytes() const { return buffer_ != nullptr ? buffer_offset_ - IMdf4BlockSink::BLOCK_HEADER_SIZE : 0; }
+    uint64_t GetStreamAddress() const { return sink_.GetStreamAddress(); }
+    uint64_t GetDataSizeBytes() const { return data_size_bytes_; }
+    // Blocks written by this writer
+    std::vector<Mdf4DataBlockInfo> GetDataBlocks() const;
+};
+
+} // namespace eerie_leap::subsys::mdf
@@ -0,0 +1,273 @@
+#include <algorithm>
+#include <cstring>
+#include <ios>
+#include <stdexcept>
+
+#include <zephyr/kernel.h>
+
+#include "mdf4/data_list_block.h"
+#include "mdf4_stream_block_sink.h"
+
+namespace eerie_leap::subsys::mdf {
+
+Mdf4StreamBlockSink::Mdf4StreamBlockSink(
+    std::streambuf& stream,
+    uint64_t stream_address,
+    size_t buffer_size,
+    std::pmr::memory_resource* mr)
+        : stream_(stream),
+        mr_(mr),
+        buffer_size_(AlignBufferSize(buffer_size)),
+        stream_address_(stream_address),
+        compression_level_(CONFIG_EERIE_LEAP_MDF_DZ_LEVEL),
+        compressor_(nullptr),
+        compressed_buffer_(nullptr),
+        transposed_buffer_(nullptr),
+        data_list_size_(CONFIG_EERIE_LEAP_MDF_DATA_LIST_SIZE) {}
+
+Mdf4StreamBlockSink::~Mdf4StreamBlockSink() {
+    for(auto* buffer : buffers_)
+        mr_->deallocate(buffer, buffer_size_, SECTOR_SIZE);
+
+    for(auto* buffer : { compressed_buffer_, transposed_buffer_ }) {
+        if(buffer != nullptr)
+            mr_->deallocate(buffer, buffer_size_, SECTOR_SIZE);
+    }
+}
+
+size_t Mdf4StreamBlockSink::AlignBufferSize(size_t buffer_size) {
+    return std::max((buffer_size + SECTOR_SIZE - 1) / SECTOR_SIZE * SECTOR_SIZE, SECTOR_SIZE);
+}
+
+// Blocks are written in the calling thread, no buffer is held in between
+void Mdf4StreamBlockSink::ReserveBuffers(size_t writer_count) {
+    while(buffers_.size() < writer_count) {
+        auto* buffer = static_cast<uint8_t*>(mr_->allocate(buffer_size_, SECTOR_SIZE));
+        buffers_.push_back(buffer);
+        free_buffers_.push_back(buffer);
+    }
+}
+
+uint8_t* Mdf4StreamBlockSink::AcquireBuffer() {
+    if(free_buffers_.empty())
+        ReserveBuffers(buffers_.size() + 1);
+
+    uint8_t* buffer = free_buffers_.back();
+    free_buffers_.pop_back();
+
+    return buffer;
+}
+
+void Mdf4StreamBlockSink::SubmitBuffer(uint8_t* buffer, size_t size_bytes, const Mdf4BlockOptions& options) {
+    try {
+        WriteBlock(buffer, size_bytes, options);
+    } catch(...) {
+        free_buffers_.push_back(buffer);
+        throw;
+    }
+
+    free_buffers_.push_back(buffer);
+}
+
+void Mdf4StreamBlockSink::SetCompressionLevel(int level) {
+    compression_level_ = std::clamp(level, DeflateCompressor::MIN_LEVEL, DeflateCompressor::MAX_LEVEL);
+
+    if(compressor_)
+        compressor_->SetLevel(compression_level_);
+}
+
+void Mdf4StreamBlockSink::WriteToStream(const void* data, size_t size) {
+    auto ret = stream_.sputn(
+        reinterpret_cast<const char*>(data),
+        static_cast<std::streamsize>(size));
+
+    if(ret != size)
+        throw std::ios_base::failure("End of stream reached (EOF).");
+
+    stream_address_ += size;
+}
+
+void Mdf4StreamBlockSink::WritePadding(size_t alignment) {
+    static constexpr uint8_t padding[SECTOR_SIZE] = {};
+
+    size_t padding_size = (alignment - stream_address_ % alignment) % alignment;
+    if(padding_size > 0)
+        WriteToStream(padding, padding_size);
+}
+
+void Mdf4StreamBlockSink::PatchLink(uint64_t link_address, uint64_t address) {
+    if(stream_.pubseekpos(link_address, std::ios_base::out) != link_address)
+        throw std::ios_base::failure("Failed to seek to MDF link.");
+
+    auto ret = stream_.sputn(reinterpret_cast<const char*>(&address), sizeof(address));
+
+    if(stream_.pubseekpos(stream_address_, std::ios_base::out) != stream_address_ || ret != sizeof(address))
+        throw std::ios_base::failure("Failed to patch MDF link.");
+}
+
+void Mdf4StreamBlockSink::EnableDataList(uint32_t writer_id, uint64_t link_address) {
+    data_lists_[writer_id] = { .link_address = link_address, .data_offset = 0, .data_blocks = {} };
+}
+
+void Mdf4StreamBlockSink::WriteDataList(DataListState& data_list) {
+    if(data_list.data_blocks.empty())
+        return;
+
+    std::pmr::vector<uint8_t> buffer(mdf4::DataListBlock::GetBlockSize(data_list.data_blocks.size()), mr_);
+    mdf4::DataListBlock::Serialize(data_list.data_blocks, data_list.data_offset, buffer);
+
+    WritePadding(8);
+    uint64_t address = stream_address_;
+    WriteToStream(buffer.data(), buffer.size());
+
+    // NOTE: DL block is synced before it gets linked, so a link that
+    // reached the card never points to a block that didn't.
+    stream_.pubsync();
+    PatchLink(data_list.link_address, address);
+
+    data_list.link_address = address + mdf4::DataListBlock::NEXT_LINK_OFFSET;
+    for(const auto& data_block : data_list.data_blocks)
+        data_list.data_offset += data_block.data_size_bytes;
+    data_list.data_blocks.clear();
+}
+
+void Mdf4StreamBlockSink::FlushDataLists() {
+    for(auto& [_, data_list] : data_lists_)
+        WriteDataList(data_list);
+}
+
+size_t Mdf4StreamBlockSink::CompressBlock(const uint8_t* buffer, size_t size_bytes, const Mdf4BlockOptions& options) {
+    if(compressor_ == nullptr) {
+        compressor_ = std::make_unique<DeflateCompressor>(compression_level_, mr_);
+        compressed_buffer_ = static_cast<uint8_t*>(mr_->allocate(buffer_size_, SECTOR_SIZE));
+    }
+
+    uint32_t start_cycles = k_cycle_get_32();
+
+    std::span<const uint8_t> data(buffer + BLOCK_HEADER_SIZE, size_bytes - BLOCK_HEADER_SIZE);
+
+    uint8_t zip_type = 0;
+    uint32_t zip_parameter = 0;
+
+    size_t row_count = options.record_size_bytes > 1 ? data.size() / options.record_size_bytes : 0;
+    if(options.compression == Mdf4CompressionType::TranspositionDeflate && row_count > 1) {
+        if(transposed_buffer_ == nullptr)
+            transposed_buffer_ = static_cast<uint8_t*>(mr_->allocate(buffer_size_, SECTOR_SIZE));
+
+        // Column major order for complete records, remaining bytes stay as is
+        size_t column_count = options.record_size_bytes;
+        for(size_t row = 0; row < row_count; row++) {
+            for(size_t column = 0; column < column_count; column++)
+                transposed_buffer_[column * row_count + row] = data[row * column_count + column];
+        }
+
+        size_t transposed_size = row_count * column_count;
+        std::memcpy(transposed_buffer_ + transposed_size, data.data() + transposed_size, data.size() - transposed_size);
+
+        data = std::span<const uint8_t>(transposed_buffer_, data.size());
+        zip_type = 1;
+        zip_parameter = column_count;
+    }
+
+    size_t compressed_size = compressor_->Compress(
+        data,
+        std::span<uint8_t>(compressed_buffer_ + DZ_BLOCK_HEADER_SIZE, size_bytes - DZ_BLOCK_HEADER_SIZE));
+
+    uint32_t compression_time_us = k_cyc_to_us_floor32(k_cycle_get_32() - start_cycles);
+
+    bool is_compressed = compressed_size > 0 && compressed_size + DZ_BLOCK_HEADER_SIZE < size_bytes;
+
+    k_spinlock_key_t key = k_spin_lock(&compression_statistics_lock_);
+
+    compression_statistics_.input_bytes += size_bytes;
+    compression_statistics_.output_bytes += is_compressed ? compressed_size + DZ_BLOCK_HEADER_SIZE : size_bytes;
+    compression_statistics_.compression_time_us += compression_time_us;
+    if(is_compressed)
+        compression_statistics_.compressed_block_count++;
+    else
+        compression_statistics_.uncompressed_block_count++;
+
+    k_spin_unlock(&compression_statistics_lock_, key);
+
+    if(!is_compressed)
+        return 0;
+
+    uint64_t length = DZ_BLOCK_HEADER_SIZE + compressed_size;
+    uint64_t original_data_length = size_bytes - BLOCK_HEADER_SIZE;
+    uint64_t data_length = compressed_size;
+
+    std::memset(compressed_buffer_, 0, DZ_BLOCK_HEADER_SIZE);
+    std::memcpy(compressed_buffer_, "##DZ", 4);
+    std::memcpy(compressed_buffer_ + 8, &length, sizeof(length));
+    std::memcpy(compressed_buffer_ + 24, "DT", 2);
+    compressed_buffer_[26] = zip_type;
+    std::memcpy(compressed_buffer_ + 28, &zip_parameter, sizeof(zip_parameter));
+    std::memcpy(compressed_buffer_ + 32, &original_data_length, sizeof(original_data_length));
+    std::memcpy(compressed_buffer_ + 40, &data_length, sizeof(data_length));
+
+    return length;
+}
+
+void Mdf4StreamBlockSink::WriteBlock(uint8_t* buffer, size_t size_bytes, const Mdf4BlockOptions& options) {
+    if(size_bytes < BLOCK_HEADER_SIZE || size_bytes > buffer_size_ - BLOCK_TRAILER_SIZE)
+        throw std::length_error("MDF block doesn't fit the buffer.");
+
+    size_t block_size = 0;
+    if(options.compression != Mdf4CompressionType::None && size_bytes > DZ_BLOCK_HEADER_SIZE)
+        block_size = CompressBlock(buffer, size_bytes, options);
+
+    uint8_t* block = buffer;
+    if(block_size > 0) {
+        block = compressed_buffer_;
+    } else {
+        uint64_t length = size_bytes;
+        std::memset(buffer, 0, BLOCK_HEADER_SIZE);
+        std::memcpy(buffer, "##DT", 4);
+        std::memcpy(buffer + 8, &length, sizeof(length));
+
+        block_size = size_bytes;
+    }
+
+    // Trailer starts 8 byte aligned past the block, as the next block would
+    size_t trailer_offset = (block_size + 7) / 8 * 8;
+    std::memset(block + block_size, 0, trailer_offset - block_size);
+    std::memcpy(block + trailer_offset, BLOCK_TRAILER_ID, sizeof(BLOCK_TRAILER_ID));
+    std::memcpy(block + trailer_offset + sizeof(BLOCK_TRAILER_ID), &options.writer_id, sizeof(options.writer_id));
+
+    WritePadding(SECTOR_SIZE);
+
+    Mdf4DataBlockInfo data_block = {
+        .address = stream_address_,
+        .size_bytes = block_size,
+        .data_size_bytes = size_bytes - BLOCK_HEADER_SIZE,
+        .writer_id = options.writer_id
+    };
+    data_blocks_.push_back(data_block);
+    WriteToStream(block, trailer_offset + BLOCK_TRAILER_SIZE);
+
+    auto data_list = data_lists_.find(options.writer_id);
+    if(data_list == data_lists_.end())
+        return;
+
+    // NOTE: All lists are written together, so blocks of any writer
+    // not listed yet are past the last DL written.
+    data_list->second.data_blocks.push_back(data_block);
+    if(data_list->second.data_blocks.size() >= data_list_size_)
+        FlushDataLists();
+}
+
+Mdf4CompressionStatistics Mdf4StreamBlockSink::GetCompressionStatistics() {
+    k_spinlock_key_t key = k_spin_lock(&compression_statistics_lock_);
+    auto statistics = compression_statistics_;
+    k_spin_unlock(&compression_statistics_lock_, key);
+
+    return statistics;
+}
+
+void Mdf4StreamBlockSink::ResetCompressionStatistics() {
+    k_spinlock_key_t key = k_spin_lock(&compression_statistics_lock_);
+    compression_statistics_ = {};
+    k_spin_unlock(&compression_statistics_lock_, key);
+}
+
+} // namespace eerie_leap::subsys::mdf
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <streambuf>
+#include <unordered_map>
+#include <vector>
+
+#include <zephyr/spinlock.h>
+
+#include "utilities/memory/memory_resource_manager.h"
+#include "utilities/compression/deflate_compressor.h"
+#include "i_mdf4_block_sink.h"
+
+namespace eerie_leap::subsys::mdf {
+
+using namespace eerie_leap::utilities::memory;
+using namespace eerie_leap::utilities::compression;
+
+struct Mdf4CompressionStatistics {
+    uint32_t compressed_block_count;
+    // Blocks requested compressed but written as DT as they didn't shrink
+    uint32_t uncompressed_block_count;
+    uint64_t input_bytes;
+    uint64_t output_bytes;
+    uint64_t compression_time_us;
+};
+
+// Writes DT blocks to the stream in the calling thread.
+// Blocks start on sector boundaries, a partial block leaves a gap
+// before the next one. Blocks submitted with compression are written
+// as DZ blocks when that makes them smaller.
+// Writers with data list enabled get a DL block every
+// EERIE_LEAP_MDF_DATA_LIST_SIZE blocks, chained to the previous one,
+// so a file cut short by power loss only needs its tail recovered.
+// Once any writer fills its list, DL blocks are written for all of them.
+// NOTE: DL links are patched in place, the stream must be seekable
+// and not opened for append.
+class Mdf4StreamBlockSink : public IMdf4BlockSink {
+private:
+    struct DataListState {
+        // Link the next DL block gets patched into
+        uint64_t link_address;
+        uint64_t data_offset;
+        std::vector<Mdf4DataBlockInfo> data_blocks;
+    };
+
+    static constexpr size_t DZ_BLOCK_HEADER_SIZE = BLOCK_HEADER_SIZE + 24;
+
+    std::streambuf& stream_;
+    std::pmr::memory_resource* mr_;
+
+    size_t buffer_size_;
+    std::vector<uint8_t*> buffers_;
+    std::vector<uint8_t*> free_buffers_;
+
+    uint64_t stream_address_;
+    std::vector<Mdf4DataBlockInfo> data_blocks_;
+
+    int compression_level_;
+    std::unique_ptr<DeflateCompressor> compressor_;
+    uint8_t* compressed_buffer_;
+    uint8_t* transposed_buffer_;
+
+    k_spinlock compression_statistics_lock_;
+    Mdf4CompressionStatistics compression_statistics_ = {};
+
+    size_t data_list_size_;
+    std::unordered_map<uint32_t, DataListState> data_lists_;
+
+    void WriteToStream(const void* data, size_t size);
+    void WritePadding(size_t alignment);
+    void WriteDataList(DataListState& data_list);
+    void PatchLink(uint64_t link_address, uint64_t address);
+    // Returns DZ block size, 0 if the block should be written uncompressed
+    size_t CompressBlock(const uint8_t* buffer, size_t size_bytes, const Mdf4BlockOptions& options);
+
+public:
+    static constexpr size_t SECTOR_SIZE = 512;
+
+    Mdf4StreamBlockSink(
+        std::streambuf& stream,
+        uint64_t stream_address,
+        size_t buffer_size = CONFIG_EERIE_LEAP_MDF_RECORD_BUFFER_SIZE,
+        std::pmr::memory_resource* mr = Mrm::GetExtPmr());
+    ~Mdf4StreamBlockSink() override;
+
+    Mdf4StreamBlockSink(const Mdf4StreamBlockSink&) = delete;
+    Mdf4StreamBlockSink& operator=(const Mdf4StreamBlockSink&) = delete;
+
+    static size_t AlignBufferSize(size_t buffer_size);
+
+    // Completes the block header in place and writes the block in one call
+    void WriteBlock(uint8_t* buffer, size_t size_bytes, const Mdf4BlockOptions& options = {});
+
+    size_t GetBufferSize() const override { return buffer_size_; }
+    void ReserveBuffers(size_t writer_count) override;
+    // NOTE: Buffers are allocated as writers need them, each acquire
+    // gets a buffer of its own until it's submitted.
+    uint8_t* AcquireBuffer() override;
+    void SubmitBuffer(uint8_t* buffer, size_t size_bytes, const Mdf4BlockOptions& options) override;
+    void Flush() override {}
+
+    uint64_t GetStreamAddress() const override { return stream_address_; }
+    std::vector<Mdf4DataBlockInfo> GetDataBlocks() const override { return data_blocks_; }
+
+    void EnableDataList(uint32_t writer_id, uint64_t link_address) override;
+    void FlushDataLists() override;
+
+    // NOTE: Not thread safe against WriteBlock, set before writing
+    void SetCompressionLevel(int level);
+    int GetCompressionLevel() const { return compression_level_; }
+
+    Mdf4CompressionStatistics GetCompressionStatistics();
+    void ResetCompressionStatistics();
+};
+
+} // namespace eerie_leap::subsys::mdf
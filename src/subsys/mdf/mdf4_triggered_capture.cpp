@@ -0,0 +1,324 @@
+#include <cstring>
+#include <stdexcept>
+
+#include <zephyr/logging/log.h>
+
+#include "mdf4_triggered_capture.h"
+
+LOG_MODULE_REGISTER(mdf4_triggered_capture);
+
+namespace eerie_leap::subsys::mdf {
+
+Mdf4TriggeredCapture::Mdf4TriggeredCapture(
+    uint32_t pre_trigger_ms,
+    uint32_t post_trigger_ms,
+    size_t buffer_size,
+    std::pmr::memory_resource* mr)
+        : buffer_(buffer_size, mr),
+        head_(0),
+        tail_(0),
+        used_bytes_(0),
+        entry_count_(0),
+        pre_trigger_time_(pre_trigger_ms / 1000.0f),
+        post_trigger_time_(post_trigger_ms / 1000.0f),
+        is_recording_(false),
+        capture_end_time_(0),
+        is_trigger_pending_(ATOMIC_INIT(0)),
+        trigger_count_(ATOMIC_INIT(0)),
+        segment_count_(ATOMIC_INIT(0)),
+        overwritten_count_(ATOMIC_INIT(0)),
+        dropped_count_(ATOMIC_INIT(0)) {
+
+    if(buffer_size < sizeof(EntryHeader) * 2)
+        throw std::invalid_argument("Capture buffer is too small");
+
+    k_mutex_init(&mutex_);
+}
+
+uint16_t Mdf4TriggeredCapture::RegisterSource(IMdf4CaptureSource& source) {
+    k_mutex_lock(&mutex_, K_FOREVER);
+
+    for(size_t i = 0; i < sources_.size(); i++) {
+        if(sources_[i] == nullptr) {
+            sources_[i] = &source;
+            k_mutex_unlock(&mutex_);
+
+            return static_cast<uint16_t>(i);
+        }
+    }
+
+    if(sources_.size() >= DISCARDED_SOURCE_ID) {
+        k_mutex_unlock(&mutex_);
+        throw std::runtime_error("Too many capture sources");
+    }
+
+    sources_.push_back(&source);
+    uint16_t source_id = static_cast<uint16_t>(sources_.size() - 1);
+
+    k_mutex_unlock(&mutex_);
+
+    return source_id;
+}
+
+void Mdf4TriggeredCapture::UnregisterSource(uint16_t source_id) {
+    k_mutex_lock(&mutex_, K_FOREVER);
+
+    // NOTE: Slot may be reused, so records of the source can't stay buffered
+    if(source_id < sources_.size() && sources_[source_id] != nullptr) {
+        sources_[source_id] = nullptr;
+        Discard(source_id);
+    }
+
+    k_mutex_unlock(&mutex_);
+}
+
+size_t Mdf4TriggeredCapture::GetEntrySize(size_t size_bytes) {
+    return (sizeof(EntryHeader) + size_bytes + 3) & ~static_cast<size_t>(3);
+}
+
+void Mdf4TriggeredCapture::Evict() {
+    EntryHeader header;
+    size_t tail_space = buffer_.size() - tail_;
+
+    if(tail_space >= sizeof(EntryHeader))
+        std::memcpy(&header, buffer_.data() + tail_, sizeof(EntryHeader));
+
+    if(tail_space < sizeof(EntryHeader) || header.source_id == PADDING_SOURCE_ID) {
+        used_bytes_ -= tail_space;
+        tail_ = 0;
+
+        return;
+    }
+
+    size_t entry_size = GetEntrySize(header.size_bytes);
+    used_bytes_ -= entry_size;
+    tail_ += entry_size;
+    if(tail_ == buffer_.size())
+        tail_ = 0;
+
+    if(header.source_id != DISCARDED_SOURCE_ID)
+        entry_count_--;
+}
+
+void Mdf4TriggeredCapture::EvictOverwritten() {
+    size_t entry_count = entry_count_;
+    Evict();
+
+    if(entry_count_ != entry_count)
+        atomic_inc(&overwritten_count_);
+}
+
+void Mdf4TriggeredCapture::Push(uint16_t source_id, float time, std::span<const uint8_t> record) {
+    size_t entry_size = GetEntrySize(record.size());
+    if(record.size() > UINT16_MAX || entry_size > buffer_.size()) {
+        atomic_inc(&dropped_count_);
+        return;
+    }
+
+    if(used_bytes_ == 0)
+        Clear();
+
+    // Entries are kept contiguous, the space left at the end is skipped
+    size_t tail_space = buffer_.size() - head_;
+    if(tail_space < entry_size) {
+        while(buffer_.size() - used_bytes_ < tail_space)
+            EvictOverwritten();
+
+        if(tail_space >= sizeof(EntryHeader)) {
+            EntryHeader padding = {
+                .time = 0,
+                .source_id = PADDING_SOURCE_ID,
+                .size_bytes = 0
+            };
+            std::memcpy(buffer_.data() + head_, &padding, sizeof(EntryHeader));
+        }
+
+        used_bytes_ += tail_space;
+        head_ = 0;
+    }
+
+    while(buffer_.size() - used_bytes_ < entry_size)
+        EvictOverwritten();
+
+    EntryHeader header = {
+        .time = time,
+        .source_id = source_id,
+        .size_bytes = static_cast<uint16_t>(record.size())
+    };
+    std::memcpy(buffer_.data() + head_, &header, sizeof(EntryHeader));
+    std::memcpy(buffer_.data() + head_ + sizeof(EntryHeader), record.data(), record.size());
+
+    used_bytes_ += entry_size;
+    head_ += entry_size;
+    if(head_ == buffer_.size())
+        head_ = 0;
+
+    entry_count_++;
+}
+
+// Marks buffered records of the source in place, other sources keep theirs
+void Mdf4TriggeredCapture::Discard(uint16_t source_id) {
+    size_t position = tail_;
+    size_t remaining_bytes = used_bytes_;
+
+    while(remaining_bytes > 0) {
+        EntryHeader header;
+        size_t tail_space = buffer_.size() - position;
+
+        if(tail_space >= sizeof(EntryHeader))
+            std::memcpy(&header, buffer_.data() + position, sizeof(EntryHeader));
+
+        if(tail_space < sizeof(EntryHeader) || header.source_id == PADDING_SOURCE_ID) {
+            remaining_bytes -= tail_space;
+            position = 0;
+
+            continue;
+        }
+
+        if(header.source_id == source_id) {
+            header.source_id = DISCARDED_SOURCE_ID;
+            std::memcpy(buffer_.data() + position, &header, sizeof(EntryHeader));
+            entry_count_--;
+        }
+
+        size_t entry_size = GetEntrySize(header.size_bytes);
+        remaining_bytes -= entry_size;
+        position += entry_size;
+        if(position == buffer_.size())
+            position = 0;
+    }
+}
+
+void Mdf4TriggeredCapture::Clear() {
+    head_ = 0;
+    tail_ = 0;
+    used_bytes_ = 0;
+    entry_count_ = 0;
+}
+
+void Mdf4TriggeredCapture::WriteRecord(uint16_t source_id, std::span<const uint8_t> record, float time) {
+    if(source_id >= sources_.size() || sources_[source_id] == nullptr)
+        return;
+
+    try {
+        sources_[source_id]->WriteCapturedRecord(source_id, record, time);
+    } catch(const std::exception& e) {
+        LOG_ERR("Failed to write captured record: %s", e.what());
+        atomic_inc(&dropped_count_);
+    }
+}
+
+void Mdf4TriggeredCapture::BeginSegment(float time) {
+    float start_time = time - pre_trigger_time_;
+
+    while(used_bytes_ > 0) {
+        EntryHeader header;
+        size_t tail_space = buffer_.size() - tail_;
+
+        if(tail_space >= sizeof(EntryHeader))
+            std::memcpy(&header, buffer_.data() + tail_, sizeof(EntryHeader));
+
+        if(tail_space >= sizeof(EntryHeader)
+            && header.source_id != PADDING_SOURCE_ID
+            && header.source_id != DISCARDED_SOURCE_ID
+            && header.time >= start_time) {
+
+            WriteRecord(
+                header.source_id,
+                std::span<const uint8_t>(buffer_.data() + tail_ + sizeof(EntryHeader), header.size_bytes),
+                header.time);
+        }
+
+        Evict();
+    }
+
+    Clear();
+
+    is_recording_ = true;
+    capture_end_time_ = time + post_trigger_time_;
+
+    LOG_INF("Capture triggered at %.3f s.", static_cast<double>(time));
+}
+
+void Mdf4TriggeredCapture::EndSegment() {
+    is_recording_ = false;
+
+    for(auto* source : sources_) {
+        if(source == nullptr)
+            continue;
+
+        try {
+            source->FlushCapturedRecords();
+        } catch(const std::exception& e) {
+            LOG_ERR("Failed to flush captured records: %s", e.what());
+        }
+    }
+
+    atomic_inc(&segment_count_);
+    LOG_INF("Capture segment written.");
+}
+
+void Mdf4TriggeredCapture::Capture(uint16_t source_id, float time, std::span<const uint8_t> record) {
+    k_mutex_lock(&mutex_, K_FOREVER);
+
+    if(is_recording_ && time > capture_end_time_)
+        EndSegment();
+
+    // NOTE: Triggers during a segment are ignored, not extending it
+    if(atomic_cas(&is_trigger_pending_, 1, 0) && !is_recording_) {
+        atomic_inc(&trigger_count_);
+        BeginSegment(time);
+    }
+
+    if(is_recording_)
+        WriteRecord(source_id, record, time);
+    else
+        Push(source_id, time, record);
+
+    k_mutex_unlock(&mutex_);
+}
+
+void Mdf4TriggeredCapture::Trigger() {
+    atomic_set(&is_trigger_pending_, 1);
+}
+
+void Mdf4TriggeredCapture::Flush() {
+    k_mutex_lock(&mutex_, K_FOREVER);
+
+    if(is_recording_)
+        EndSegment();
+
+    k_mutex_unlock(&mutex_);
+}
+
+bool Mdf4TriggeredCapture::IsRecording() {
+    k_mutex_lock(&mutex_, K_FOREVER);
+    bool is_recording = is_recording_;
+    k_mutex_unlock(&mutex_);
+
+    return is_recording;
+}
+
+Mdf4TriggeredCaptureStatistics Mdf4TriggeredCapture::GetStatistics() {
+    k_mutex_lock(&mutex_, K_FOREVER);
+    uint32_t buffered_count = static_cast<uint32_t>(entry_count_);
+    k_mutex_unlock(&mutex_);
+
+    return {
+        .trigger_count = static_cast<uint32_t>(atomic_get(&trigger_count_)),
+        .segment_count = static_cast<uint32_t>(atomic_get(&segment_count_)),
+        .buffered_count = buffered_count,
+        .overwritten_count = static_cast<uint32_t>(atomic_get(&overwritten_count_)),
+        .dropped_count = static_cast<uint32_t>(atomic_get(&dropped_count_)),
+        .buffer_size = static_cast<uint32_t>(buffer_.size())
+    };
+}
+
+void Mdf4TriggeredCapture::ResetStatistics() {
+    atomic_set(&trigger_count_, 0);
+    atomic_set(&segment_count_, 0);
+    atomic_set(&overwritten_count_, 0);
+    atomic_set(&dropped_count_, 0);
+}
+
+} // namespace eerie_leap::subsys::mdf
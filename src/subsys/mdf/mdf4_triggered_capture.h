@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+
+#include "utilities/memory/memory_resource_manager.h"
+
+namespace eerie_leap::subsys::mdf {
+
+using namespace eerie_leap::utilities::memory;
+
+// Writes records released by Mdf4TriggeredCapture into its data groups
+class IMdf4CaptureSource {
+public:
+    virtual ~IMdf4CaptureSource() = default;
+
+    // NOTE: Called with the capture lock held, from the thread that
+    // captured the record starting or ending the segment.
+    virtual void WriteCapturedRecord(uint16_t source_id, std::span<const uint8_t> record, float time) = 0;
+    virtual void FlushCapturedRecords() = 0;
+};
+
+struct Mdf4TriggeredCaptureStatistics {
+    uint32_t trigger_count;
+    uint32_t segment_count;
+    uint32_t buffered_count;
+    uint32_t overwritten_count;
+    uint32_t dropped_count;
+    uint32_t buffer_size;
+};
+
+// Event driven logging, records are kept in a RAM ring buffer instead of
+// being written, oldest records are overwritten once it is full.
+// On trigger, buffered records within the pre-trigger window are written
+// through their sources, followed by records captured during the
+// post-trigger window, then the capture is armed again. Segments of all
+// events are appended to the data groups of the same file.
+// Trigger may come from any thread, it takes effect with the next record
+// captured, whose time is the trigger time. E.g. a CanbusComLoggingCommand
+// handler starting the logging can call Trigger.
+// NOTE: Ring buffer has to hold the pre-trigger window of all sources,
+// records older than the window are discarded on trigger.
+class Mdf4TriggeredCapture {
+private:
+    struct EntryHeader {
+        float time;
+        uint16_t source_id;
+        uint16_t size_bytes;
+    };
+
+    static constexpr uint16_t PADDING_SOURCE_ID = UINT16_MAX;
+    // Records of unregistered sources, skipped until evicted
+    static constexpr uint16_t DISCARDED_SOURCE_ID = UINT16_MAX - 1;
+
+    std::pmr::vector<uint8_t> buffer_;
+    size_t head_;
+    size_t tail_;
+    size_t used_bytes_;
+    size_t entry_count_;
+
+    float pre_trigger_time_;
+    float post_trigger_time_;
+    bool is_recording_;
+    float capture_end_time_;
+
+    std::vector<IMdf4CaptureSource*> sources_;
+
+    k_mutex mutex_;
+    atomic_t is_trigger_pending_;
+    atomic_t trigger_count_;
+    atomic_t segment_count_;
+    atomic_t overwritten_count_;
+    atomic_t dropped_count_;
+
+    static size_t GetEntrySize(size_t size_bytes);
+    void Push(uint16_t source_id, float time, std::span<const uint8_t> record);
+    void Evict();
+    void EvictOverwritten();
+    void Discard(uint16_t source_id);
+    void Clear();
+
+    void BeginSegment(float time);
+    void EndSegment();
+    void WriteRecord(uint16_t source_id, std::span<const uint8_t> record, float time);
+
+public:
+    Mdf4TriggeredCapture(
+        uint32_t pre_trigger_ms = CONFIG_EERIE_LEAP_MDF_CAPTURE_PRE_TRIGGER_MS,
+        uint32_t post_trigger_ms = CONFIG_EERIE_LEAP_MDF_CAPTURE_POST_TRIGGER_MS,
+        size_t buffer_size = CONFIG_EERIE_LEAP_MDF_CAPTURE_BUFFER_SIZE,
+        std::pmr::memory_resource* mr = Mrm::GetExtPmr());
+
+    Mdf4TriggeredCapture(const Mdf4TriggeredCapture&) = delete;
+    Mdf4TriggeredCapture& operator=(const Mdf4TriggeredCapture&) = delete;
+
+    uint16_t RegisterSource(IMdf4CaptureSource& source);
+    // Buffered records of the source are discarded once it is unregistered
+    void UnregisterSource(uint16_t source_id);
+
+    // Buffers the record, or writes it while a segment is being captured
+    void Capture(uint16_t source_id, float time, std::span<const uint8_t> record);
+    void Trigger();
+    // Ends the segment in progress, sources are flushed
+    void Flush();
+
+    bool IsRecording();
+
+    Mdf4TriggeredCaptureStatistics GetStatistics();
+    void ResetStatistics();
+};
+
+} // namespace eerie_leap::subsys::mdf
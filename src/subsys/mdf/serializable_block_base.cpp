@@ -1,58 +1,123 @@
+#include <ios>
+#include <stdexcept>
+#include <vector>
+
 #include "subsys/mdf/serializable_block_base.h"
 
 namespace eerie_leap::subsys::mdf {
 
+using namespace eerie_leap::subsys::mdf::utilities;
+
+namespace {
+
+// Walks the block tree depth first in GetChildren() order. Uses an explicit
+// stack as channel chains are linked child to child and would otherwise
+// recurse once per channel.
+template<typename ShouldVisit, typename Visit>
+void VisitBlocks(ISerializableBlock& root, ShouldVisit should_visit, Visit visit) {
+    std::vector<ISerializableBlock*> pending;
+
+    auto push_children = [&pending](const ISerializableBlock& block) {
+        auto children = block.GetChildren();
+        for(auto it = children.rbegin(); it != children.rend(); ++it) {
+            if(*it)
+                pending.push_back(it->get());
+        }
+    };
+
+    visit(root);
+    push_children(root);
+
+    while(!pending.empty()) {
+        auto* block = pending.back();
+        pending.pop_back();
+
+        // NOTE: Checked on pop rather than push, a block shared by several
+        // parents is only visited once, at its first position in the walk.
+        if(!should_visit(*block))
+            continue;
+
+        visit(*block);
+        push_children(*block);
+    }
+}
+
+} // namespace
+
 SerializableBlockBase::SerializableBlockBase()
     : address_(0), is_serialized_(false) {}
 
+std::unique_ptr<uint8_t[]> SerializableBlockBase::Serialize() const {
+    const uint64_t size = GetBlockSize();
+    auto buffer = std::make_unique<uint8_t[]>(size);
+
+    BlockStreamWriter writer({ buffer.get(), size });
+    WriteTo(writer);
+
+    return buffer;
+}
+
 uint64_t SerializableBlockBase::WriteToStream(std::streambuf& stream) {
-    const auto block_data = Serialize();
-    is_serialized_ = true;
+    BlockStreamWriter writer(stream);
 
-    auto ret = stream.sputn(
-        reinterpret_cast<const char*>(block_data.get()),
-        static_cast<std::streamsize>(GetBlockSize()));
+    VisitBlocks(*this,
+        [](const ISerializableBlock& block) { return !block.IsSerialized(); },
+        [this, &writer](ISerializableBlock& block) {
+            const uint64_t block_offset = writer.GetSizeBytes();
+            if(address_ + block_offset != block.GetAddress())
+                throw std::logic_error("Block address doesn't match stream position.");
 
-    if(ret != GetBlockSize())
-        throw std::ios_base::failure("End of stream reached (EOF).");
+            block.WriteTo(writer);
+            block.SetSerialized(true);
 
-    for(auto& child : GetChildren()) {
-        if(child && !child->IsSerialized())
-            ret += child->WriteToStream(stream);
-    }
+            if(writer.GetSizeBytes() - block_offset != block.GetBlockSize())
+                throw std::logic_error("Block size doesn't match bytes written.");
+        });
+
+    writer.Flush();
 
-    return ret;
+    return writer.GetSizeBytes();
 }
 
 uint64_t SerializableBlockBase::GetAddress() const {
     return address_;
 }
 
+void SerializableBlockBase::SetAddress(uint64_t address) {
+    address_ = address;
+}
+
 bool SerializableBlockBase::IsSerialized() const {
     return is_serialized_;
 }
 
+void SerializableBlockBase::SetSerialized(bool is_serialized) {
+    is_serialized_ = is_serialized;
+}
+
 void SerializableBlockBase::Reset() {
-    if(address_ == 0 && is_serialized_ == false)
-        return;
+    auto is_dirty = [](const ISerializableBlock& block) {
+        return block.GetAddress() != 0 || block.IsSerialized();
+    };
 
-    address_ = 0;
-    is_serialized_ = false;
+    if(!is_dirty(*this))
+        return;
 
-    for(auto& child : GetChildren()) {
-        if(child)
-            child->Reset();
-    }
+    VisitBlocks(*this, is_dirty, [](ISerializableBlock& block) {
+        block.SetAddress(0);
+        block.SetSerialized(false);
+    });
 }
 
 uint64_t SerializableBlockBase::ResolveAddress(uint64_t parent_address) {
-    address_ = parent_address;
-    uint64_t current_address = address_ + GetBlockSize();
-
-    for(auto& child : GetChildren()) {
-        if(child && child->GetAddress() == 0)
-            current_address = child->ResolveAddress(current_address);
-    }
+    uint64_t current_address = parent_address;
+
+    VisitBlocks(*this,
+        [](const ISerializableBlock& block) { return block.GetAddress() == 0; },
+        [&current_address](ISerializableBlock& block) {
+            block.SetAddress(current_address);
+            current_address += block.GetBlockSize();
+        });
 
     return current_address;
 }
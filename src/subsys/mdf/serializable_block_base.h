@@ -8,6 +8,9 @@
 
 namespace eerie_leap::subsys::mdf {
 
+// NOTE: Block tree is written in two passes, ResolveAddress assigns
+// addresses and WriteToStream streams blocks in the same depth first
+// order, so no block is ever serialized into an intermediate buffer.
 class SerializableBlockBase : public virtual ISerializableBlock {
 protected:
     uint64_t address_;
@@ -16,9 +19,12 @@ protected:
 public:
     SerializableBlockBase();
 
+    std::unique_ptr<uint8_t[]> Serialize() const override;
     uint64_t WriteToStream(std::streambuf& stream) override;
     uint64_t GetAddress() const override;
+    void SetAddress(uint64_t address) override;
     bool IsSerialized() const override;
+    void SetSerialized(bool is_serialized) override;
     void Reset() override;
     uint64_t ResolveAddress(uint64_t parent_address) override;
 };
@@ -2,8 +2,8 @@
 
 #include <cstddef>
 #include <cstdint>
-#include <cstring>
 #include <memory>
+#include <stdexcept>
 #include <vector>
 #include <utility>
 #include <concepts>
@@ -61,26 +61,18 @@ public:
         return links;
     }
 
-    std::unique_ptr<uint8_t[]> Serialize() const override {
-        const uint64_t size = GetLinksSizeBytes();
-        auto buffer = std::make_unique<uint8_t[]>(size);
-        std::memset(buffer.get(), 0, size);
-
-        uint64_t offset = 0;
-
+    void WriteTo(BlockStreamWriter& writer) const override {
         for(auto& link : links_) {
+            uint64_t address = 0;
+
             if(link) {
-                auto address = link->GetAddress();
+                address = link->GetAddress();
                 if(address == 0)
                     throw std::runtime_error("Invalid Block address");
-
-                std::memcpy(buffer.get() + offset, &address, LINK_SIZE_BYTES);
             }
 
-            offset += LINK_SIZE_BYTES;
+            writer.WriteValue(address);
         }
-
-        return buffer;
     }
 };
 
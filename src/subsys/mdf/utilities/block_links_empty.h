@@ -25,9 +25,7 @@ public:
         return {};
     }
 
-    std::unique_ptr<uint8_t[]> Serialize() const override {
-        return {};
-    }
+    void WriteTo(BlockStreamWriter& writer) const override {}
 };
 
 } // namespace eerie_leap::subsys::mdf::utilities
@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <cstring>
+#include <ios>
+
+#include "block_stream_writer.h"
+
+namespace eerie_leap::subsys::mdf::utilities {
+
+BlockStreamWriter::BlockStreamWriter(std::streambuf& stream)
+    : stream_(&stream), buffer_(), scratch_offset_(0), size_bytes_(0) {}
+
+BlockStreamWriter::BlockStreamWriter(std::span<uint8_t> buffer)
+    : stream_(nullptr), buffer_(buffer), scratch_offset_(0), size_bytes_(0) {}
+
+BlockStreamWriter::~BlockStreamWriter() {
+    try {
+        Flush();
+    } catch(const std::exception& e) {}
+}
+
+void BlockStreamWriter::FlushScratch() {
+    if(scratch_offset_ == 0)
+        return;
+
+    auto size = static_cast<std::streamsize>(scratch_offset_);
+    scratch_offset_ = 0;
+
+    if(stream_->sputn(reinterpret_cast<const char*>(scratch_.data()), size) != size)
+        throw std::ios_base::failure("End of stream reached (EOF).");
+}
+
+void BlockStreamWriter::Write(const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+
+    if(stream_ == nullptr) {
+        if(size_bytes_ + size > buffer_.size())
+            throw std::ios_base::failure("Block buffer overflow.");
+
+        std::memcpy(buffer_.data() + size_bytes_, bytes, size);
+        size_bytes_ += size;
+
+        return;
+    }
+
+    size_bytes_ += size;
+
+    // NOTE: Payloads larger than the scratch buffer, e.g. text,
+    // bypass it instead of being copied in chunks.
+    if(size > SCRATCH_SIZE_BYTES) {
+        FlushScratch();
+
+        if(stream_->sputn(reinterpret_cast<const char*>(bytes), static_cast<std::streamsize>(size)) != static_cast<std::streamsize>(size))
+            throw std::ios_base::failure("End of stream reached (EOF).");
+
+        return;
+    }
+
+    while(size > 0) {
+        size_t chunk_size = std::min(size, SCRATCH_SIZE_BYTES - scratch_offset_);
+        std::memcpy(scratch_.data() + scratch_offset_, bytes, chunk_size);
+        scratch_offset_ += chunk_size;
+        bytes += chunk_size;
+        size -= chunk_size;
+
+        if(scratch_offset_ == SCRATCH_SIZE_BYTES)
+            FlushScratch();
+    }
+}
+
+void BlockStreamWriter::WriteZeros(size_t size) {
+    static constexpr uint8_t zeros[16] = {};
+
+    while(size > 0) {
+        size_t chunk_size = std::min(size, sizeof(zeros));
+        Write(zeros, chunk_size);
+        size -= chunk_size;
+    }
+}
+
+void BlockStreamWriter::WritePadded(std::string_view text, size_t size, char pad_char) {
+    size_t text_size = std::min(text.size(), size);
+    Write(text.data(), text_size);
+
+    if(pad_char == '\0') {
+        WriteZeros(size - text_size);
+        return;
+    }
+
+    for(size_t i = text_size; i < size; i++)
+        Write(&pad_char, 1);
+}
+
+void BlockStreamWriter::Flush() {
+    if(stream_ != nullptr)
+        FlushScratch();
+}
+
+} // namespace eerie_leap::subsys::mdf::utilities
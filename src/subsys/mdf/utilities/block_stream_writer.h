@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <streambuf>
+#include <string_view>
+#include <type_traits>
+
+namespace eerie_leap::subsys::mdf::utilities {
+
+// Writes block fields either to a stream through a small fixed scratch
+// buffer or straight into a caller provided memory buffer, so blocks are
+// serialized without an intermediate heap copy of the whole block.
+class BlockStreamWriter {
+private:
+    static constexpr size_t SCRATCH_SIZE_BYTES = 64;
+
+    std::streambuf* stream_;
+    std::span<uint8_t> buffer_;
+
+    std::array<uint8_t, SCRATCH_SIZE_BYTES> scratch_;
+    size_t scratch_offset_;
+    uint64_t size_bytes_;
+
+    void FlushScratch();
+
+public:
+    explicit BlockStreamWriter(std::streambuf& stream);
+    explicit BlockStreamWriter(std::span<uint8_t> buffer);
+    ~BlockStreamWriter();
+
+    BlockStreamWriter(const BlockStreamWriter&) = delete;
+    BlockStreamWriter& operator=(const BlockStreamWriter&) = delete;
+
+    void Write(const void* data, size_t size);
+    void WriteZeros(size_t size);
+    // Writes text truncated or padded with pad_char to size bytes
+    void WritePadded(std::string_view text, size_t size, char pad_char = '\0');
+
+    template<typename T>
+    void WriteValue(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        Write(&value, sizeof(T));
+    }
+
+    void Flush();
+
+    // Bytes written so far, including not yet flushed ones
+    uint64_t GetSizeBytes() const { return size_bytes_; }
+};
+
+} // namespace eerie_leap::subsys::mdf::utilities
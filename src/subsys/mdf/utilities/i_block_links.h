@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "subsys/mdf/i_serializable_block.h"
+#include "block_stream_writer.h"
 
 namespace eerie_leap::subsys::mdf::utilities {
 
@@ -16,7 +17,7 @@ public:
     virtual int Count() const = 0;
     virtual uint64_t GetLinksSizeBytes() const = 0;
     virtual const std::vector<std::shared_ptr<ISerializableBlock>> GetLinks() const = 0;
-    virtual std::unique_ptr<uint8_t[]> Serialize() const = 0;
+    virtual void WriteTo(BlockStreamWriter& writer) const = 0;
 };
 
 } // namespace eerie_leap::subsys::mdf::utilities
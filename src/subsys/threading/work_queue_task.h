@@ -41,6 +41,12 @@ public:
         return k_work_cancel_delayable_sync(&work, sync_);
     }
 
+    // NOTE: Doesn't wait for the work to complete, only safe to release
+    // the task after it when called from its own work queue.
+    void CancelOnQueue() {
+        k_work_cancel_delayable(&work);
+    }
+
     bool Flush() {
         return k_work_flush_delayable(&work, sync_);
     }
@@ -12,6 +12,12 @@ WorkQueueThread::WorkQueueThread(std::string name, int stack_size, int priority,
 }
 
 WorkQueueThread::~WorkQueueThread() {
+    if(!initialized_)
+        return;
+
+    // NOTE: Queue has to be plugged to be stopped,
+    // otherwise the thread outlives its stack
+    k_work_queue_drain(&work_q_, true);
     k_work_queue_stop(&work_q_, K_FOREVER);
 }
 
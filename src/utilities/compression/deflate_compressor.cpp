@@ -0,0 +1,266 @@
+#include <algorithm>
+#include <array>
+
+#include "deflate_compressor.h"
+
+namespace eerie_leap::utilities::compression {
+
+namespace {
+
+constexpr std::array<uint16_t, 29> LENGTH_BASE = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+constexpr std::array<uint8_t, 29> LENGTH_EXTRA_BITS = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+constexpr std::array<uint16_t, 30> DISTANCE_BASE = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+constexpr std::array<uint8_t, 30> DISTANCE_EXTRA_BITS = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+// Hash chain depth and early exit match length per level
+constexpr std::array<uint16_t, 10> MAX_CHAIN = { 0, 4, 8, 16, 32, 64, 128, 256, 512, 1024 };
+constexpr std::array<uint16_t, 10> NICE_LENGTH = { 0, 16, 32, 32, 64, 64, 128, 258, 258, 258 };
+
+class BitWriter {
+private:
+    std::span<uint8_t> output_;
+    size_t position_ = 0;
+    uint32_t bits_ = 0;
+    int bit_count_ = 0;
+    bool is_overflow_ = false;
+
+public:
+    explicit BitWriter(std::span<uint8_t> output) : output_(output) {}
+
+    void WriteByte(uint8_t value) {
+        if(position_ < output_.size())
+            output_[position_++] = value;
+        else
+            is_overflow_ = true;
+    }
+
+    // Values are packed starting from the least significant bit
+    void Write(uint32_t value, int bit_count) {
+        bits_ |= value << bit_count_;
+        bit_count_ += bit_count;
+
+        while(bit_count_ >= 8) {
+            WriteByte(bits_ & 0xFF);
+            bits_ >>= 8;
+            bit_count_ -= 8;
+        }
+    }
+
+    // Huffman codes are stored starting from the most significant bit
+    void WriteCode(uint32_t code, int bit_count) {
+        uint32_t reversed = 0;
+        for(int i = 0; i < bit_count; i++) {
+            reversed = (reversed << 1) | (code & 1);
+            code >>= 1;
+        }
+
+        Write(reversed, bit_count);
+    }
+
+    void AlignToByte() {
+        if(bit_count_ > 0)
+            Write(0, 8 - bit_count_);
+    }
+
+    size_t GetPosition() const { return position_; }
+    bool IsOverflow() const { return is_overflow_; }
+};
+
+void WriteLiteralLength(BitWriter& writer, uint16_t symbol) {
+    if(symbol <= 143)
+        writer.WriteCode(0x30 + symbol, 8);
+    else if(symbol <= 255)
+        writer.WriteCode(0x190 + symbol - 144, 9);
+    else if(symbol <= 279)
+        writer.WriteCode(symbol - 256, 7);
+    else
+        writer.WriteCode(0xC0 + symbol - 280, 8);
+}
+
+void WriteMatch(BitWriter& writer, size_t length, size_t distance) {
+    size_t length_code = LENGTH_BASE.size() - 1;
+    while(LENGTH_BASE[length_code] > length)
+        length_code--;
+
+    WriteLiteralLength(writer, 257 + length_code);
+    writer.Write(length - LENGTH_BASE[length_code], LENGTH_EXTRA_BITS[length_code]);
+
+    size_t distance_code = DISTANCE_BASE.size() - 1;
+    while(DISTANCE_BASE[distance_code] > distance)
+        distance_code--;
+
+    writer.WriteCode(distance_code, 5);
+    writer.Write(distance - DISTANCE_BASE[distance_code], DISTANCE_EXTRA_BITS[distance_code]);
+}
+
+void WriteStoredBlocks(BitWriter& writer, std::span<const uint8_t> input) {
+    static constexpr size_t MAX_STORED_BLOCK_SIZE = 65535;
+
+    do {
+        size_t block_size = std::min(input.size(), MAX_STORED_BLOCK_SIZE);
+        bool is_final = block_size == input.size();
+
+        writer.Write(is_final ? 1 : 0, 1);
+        writer.Write(0, 2);
+        writer.AlignToByte();
+
+        writer.Write(block_size, 16);
+        writer.Write(~block_size & 0xFFFF, 16);
+
+        for(size_t i = 0; i < block_size; i++)
+            writer.WriteByte(input[i]);
+
+        input = input.subspan(block_size);
+    } while(!input.empty() && !writer.IsOverflow());
+}
+
+} // namespace
+
+DeflateCompressor::DeflateCompressor(int level, std::pmr::memory_resource* mr)
+    : mr_(mr), level_(std::clamp(level, MIN_LEVEL, MAX_LEVEL)) {
+
+    head_ = static_cast<int32_t*>(mr_->allocate(HASH_SIZE * sizeof(int32_t), alignof(int32_t)));
+    prev_ = static_cast<int32_t*>(mr_->allocate(WINDOW_SIZE * sizeof(int32_t), alignof(int32_t)));
+}
+
+DeflateCompressor::~DeflateCompressor() {
+    mr_->deallocate(head_, HASH_SIZE * sizeof(int32_t), alignof(int32_t));
+    mr_->deallocate(prev_, WINDOW_SIZE * sizeof(int32_t), alignof(int32_t));
+}
+
+void DeflateCompressor::SetLevel(int level) {
+    level_ = std::clamp(level, MIN_LEVEL, MAX_LEVEL);
+}
+
+uint32_t DeflateCompressor::Hash(const uint8_t* data) {
+    uint32_t value = data[0] | (data[1] << 8) | (data[2] << 16);
+
+    return (value * 2654435761u) >> (32 - HASH_BITS);
+}
+
+uint32_t DeflateCompressor::Adler32(std::span<const uint8_t> data, uint32_t adler) {
+    static constexpr uint32_t MOD_ADLER = 65521;
+    // Largest chunk before the sums may overflow 32 bits
+    static constexpr size_t MAX_CHUNK_SIZE = 5552;
+
+    uint32_t a = adler & 0xFFFF;
+    uint32_t b = adler >> 16;
+
+    while(!data.empty()) {
+        size_t chunk_size = std::min(data.size(), MAX_CHUNK_SIZE);
+
+        for(size_t i = 0; i < chunk_size; i++) {
+            a += data[i];
+            b += a;
+        }
+
+        a %= MOD_ADLER;
+        b %= MOD_ADLER;
+        data = data.subspan(chunk_size);
+    }
+
+    return (b << 16) | a;
+}
+
+size_t DeflateCompressor::Compress(std::span<const uint8_t> input, std::span<uint8_t> output) {
+    BitWriter writer(output);
+
+    // zlib header, deflate with 32 KiB window
+    uint8_t cmf = 0x78;
+    uint8_t flevel = level_ <= 1 ? 0 : level_ <= 5 ? 1 : level_ == 6 ? 2 : 3;
+    uint8_t flg = flevel << 6;
+    flg += 31 - ((cmf << 8) | flg) % 31;
+    writer.WriteByte(cmf);
+    writer.WriteByte(flg);
+
+    if(level_ == 0) {
+        WriteStoredBlocks(writer, input);
+    } else {
+        std::fill_n(head_, HASH_SIZE, -1);
+
+        // Single final block with fixed Huffman codes
+        writer.Write(1, 1);
+        writer.Write(1, 2);
+
+        const uint8_t* data = input.data();
+        const int32_t size = static_cast<int32_t>(input.size());
+        const int max_chain = MAX_CHAIN[level_];
+        const size_t nice_length = NICE_LENGTH[level_];
+
+        auto insert = [this, data](int32_t position) {
+            uint32_t hash = Hash(data + position);
+            prev_[position & WINDOW_MASK] = head_[hash];
+            head_[hash] = position;
+        };
+
+        int32_t position = 0;
+        while(position < size && !writer.IsOverflow()) {
+            size_t best_length = 0;
+            size_t best_distance = 0;
+
+            if(position + static_cast<int32_t>(MIN_MATCH) <= size) {
+                size_t max_length = std::min<size_t>(MAX_MATCH, size - position);
+                int32_t candidate = head_[Hash(data + position)];
+                int chain = max_chain;
+
+                while(candidate >= 0 && position - candidate < static_cast<int32_t>(WINDOW_SIZE) && chain-- > 0) {
+                    if(data[candidate + best_length] == data[position + best_length]) {
+                        size_t length = 0;
+                        while(length < max_length && data[candidate + length] == data[position + length])
+                            length++;
+
+                        if(length > best_length) {
+                            best_length = length;
+                            best_distance = position - candidate;
+
+                            if(length >= nice_length || length == max_length)
+                                break;
+                        }
+                    }
+
+                    // Overwritten ring slots may point forward, chain ends there
+                    int32_t next = prev_[candidate & WINDOW_MASK];
+                    if(next >= candidate)
+                        break;
+                    candidate = next;
+                }
+
+                insert(position);
+            }
+
+            if(best_length >= MIN_MATCH) {
+                WriteMatch(writer, best_length, best_distance);
+
+                int32_t match_end = position + static_cast<int32_t>(best_length);
+                for(position++; position < match_end; position++) {
+                    if(position + static_cast<int32_t>(MIN_MATCH) <= size)
+                        insert(position);
+                }
+            } else {
+                WriteLiteralLength(writer, data[position]);
+                position++;
+            }
+        }
+
+        WriteLiteralLength(writer, 256);
+        writer.AlignToByte();
+    }
+
+    uint32_t adler = Adler32(input);
+    writer.WriteByte(adler >> 24);
+    writer.WriteByte(adler >> 16);
+    writer.WriteByte(adler >> 8);
+    writer.WriteByte(adler);
+
+    return writer.IsOverflow() ? 0 : writer.GetPosition();
+}
+
+} // namespace eerie_leap::utilities::compression
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+
+#include "utilities/memory/memory_resource_manager.h"
+
+namespace eerie_leap::utilities::compression {
+
+using namespace eerie_leap::utilities::memory;
+
+// Small footprint zlib (RFC 1950) stream compressor.
+// Uses LZ77 with hash chains over a 4 KiB window and fixed Huffman codes,
+// level trades search depth for speed, level 0 emits stored blocks.
+// NOTE: Whole input is compressed in one call, output is a complete
+// zlib stream readable by any inflate implementation.
+class DeflateCompressor {
+private:
+    static constexpr int HASH_BITS = 12;
+    static constexpr size_t HASH_SIZE = 1 << HASH_BITS;
+    static constexpr size_t WINDOW_SIZE = 4096;
+    static constexpr size_t WINDOW_MASK = WINDOW_SIZE - 1;
+    static constexpr size_t MIN_MATCH = 3;
+    static constexpr size_t MAX_MATCH = 258;
+
+    std::pmr::memory_resource* mr_;
+    int32_t* head_;
+    int32_t* prev_;
+    int level_;
+
+    static uint32_t Hash(const uint8_t* data);
+
+public:
+    static constexpr int MIN_LEVEL = 0;
+    static constexpr int MAX_LEVEL = 9;
+
+    explicit DeflateCompressor(int level = 1, std::pmr::memory_resource* mr = Mrm::GetExtPmr());
+    ~DeflateCompressor();
+
+    DeflateCompressor(const DeflateCompressor&) = delete;
+    DeflateCompressor& operator=(const DeflateCompressor&) = delete;
+
+    void SetLevel(int level);
+    int GetLevel() const { return level_; }
+
+    // Returns compressed size, 0 if output is too small
+    size_t Compress(std::span<const uint8_t> input, std::span<uint8_t> output);
+
+    static uint32_t Adler32(std::span<const uint8_t> data, uint32_t adler = 1);
+};
+
+} // namespace eerie_leap::utilities::compression
@@ -0,0 +1,275 @@
+#include <algorithm>
+#include <array>
+
+#include "deflate_compressor.h"
+#include "inflate_decompressor.h"
+
+namespace eerie_leap::utilities::compression {
+
+namespace {
+
+constexpr std::array<uint16_t, 29> LENGTH_BASE = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+constexpr std::array<uint8_t, 29> LENGTH_EXTRA_BITS = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+constexpr std::array<uint16_t, 30> DISTANCE_BASE = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+constexpr std::array<uint8_t, 30> DISTANCE_EXTRA_BITS = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+// Order code length code lengths are stored in dynamic block headers
+constexpr std::array<uint8_t, 19> CODE_LENGTH_ORDER = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+// Thrown on malformed input, caught by Decompress
+struct InflateError {};
+
+class BitReader {
+private:
+    std::span<const uint8_t> input_;
+    size_t position_ = 0;
+    uint32_t bits_ = 0;
+    int bit_count_ = 0;
+
+public:
+    explicit BitReader(std::span<const uint8_t> input) : input_(input) {}
+
+    uint8_t ReadByte() {
+        if(position_ >= input_.size())
+            throw InflateError();
+
+        return input_[position_++];
+    }
+
+    // Values are packed starting from the least significant bit
+    uint32_t Read(int bit_count) {
+        while(bit_count_ < bit_count) {
+            bits_ |= static_cast<uint32_t>(ReadByte()) << bit_count_;
+            bit_count_ += 8;
+        }
+
+        uint32_t value = bits_ & ((1u << bit_count) - 1);
+        bits_ >>= bit_count;
+        bit_count_ -= bit_count;
+
+        return value;
+    }
+
+    void AlignToByte() {
+        bits_ = 0;
+        bit_count_ = 0;
+    }
+
+    size_t GetPosition() const { return position_; }
+};
+
+template<typename Huffman>
+void BuildHuffman(Huffman& huffman, const uint8_t* lengths, size_t count) {
+    huffman.counts.fill(0);
+    for(size_t i = 0; i < count; i++)
+        huffman.counts[lengths[i]]++;
+
+    if(huffman.counts[0] == count)
+        return;
+
+    // Over subscribed code sets are rejected, incomplete ones are allowed
+    int left = 1;
+    for(size_t length = 1; length < huffman.counts.size(); length++) {
+        left <<= 1;
+        left -= huffman.counts[length];
+        if(left < 0)
+            throw InflateError();
+    }
+
+    std::array<uint16_t, 16> offsets;
+    offsets[1] = 0;
+    for(size_t length = 1; length < offsets.size() - 1; length++)
+        offsets[length + 1] = offsets[length] + huffman.counts[length];
+
+    for(size_t symbol = 0; symbol < count; symbol++) {
+        if(lengths[symbol] != 0)
+            huffman.symbols[offsets[lengths[symbol]]++] = symbol;
+    }
+}
+
+// Huffman codes are stored starting from the most significant bit
+template<typename Huffman>
+uint16_t DecodeSymbol(BitReader& reader, const Huffman& huffman) {
+    int code = 0;
+    int first = 0;
+    int index = 0;
+
+    for(size_t length = 1; length < huffman.counts.size(); length++) {
+        code |= reader.Read(1);
+        int count = huffman.counts[length];
+
+        if(code - count < first)
+            return huffman.symbols[index + (code - first)];
+
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+
+    throw InflateError();
+}
+
+} // namespace
+
+size_t InflateDecompressor::Decompress(std::span<const uint8_t> input, std::span<uint8_t> output) {
+    if(input.size() < 6)
+        return 0;
+
+    // zlib header, deflate with no preset dictionary
+    uint8_t cmf = input[0];
+    uint8_t flg = input[1];
+    if((cmf & 0x0F) != 8 || (cmf >> 4) > 7 || (cmf * 256 + flg) % 31 != 0 || (flg & 0x20) != 0)
+        return 0;
+
+    BitReader reader(input.subspan(2, input.size() - 6));
+    size_t position = 0;
+
+    try {
+        bool is_last = false;
+
+        while(!is_last) {
+            is_last = reader.Read(1) == 1;
+            uint32_t type = reader.Read(2);
+
+            if(type == 0) {
+                reader.AlignToByte();
+
+                uint16_t length = reader.ReadByte();
+                length |= reader.ReadByte() << 8;
+                uint16_t length_complement = reader.ReadByte();
+                length_complement |= reader.ReadByte() << 8;
+
+                if(length != static_cast<uint16_t>(~length_complement) || length > output.size() - position)
+                    throw InflateError();
+
+                for(size_t i = 0; i < length; i++)
+                    output[position++] = reader.ReadByte();
+
+                continue;
+            }
+
+            std::array<uint8_t, MAX_LITERAL_LENGTH_CODES + MAX_DISTANCE_CODES> lengths;
+
+            if(type == 1) {
+                std::fill(lengths.begin(), lengths.begin() + 144, 8);
+                std::fill(lengths.begin() + 144, lengths.begin() + 256, 9);
+                std::fill(lengths.begin() + 256, lengths.begin() + 280, 7);
+                std::fill(lengths.begin() + 280, lengths.begin() + 288, 8);
+                BuildHuffman(literal_length_, lengths.data(), MAX_LITERAL_LENGTH_CODES);
+
+                std::fill(lengths.begin(), lengths.begin() + MAX_DISTANCE_CODES, 5);
+                BuildHuffman(distance_, lengths.data(), MAX_DISTANCE_CODES);
+            } else if(type == 2) {
+                size_t literal_length_count = reader.Read(5) + 257;
+                size_t distance_count = reader.Read(5) + 1;
+                size_t code_length_count = reader.Read(4) + 4;
+
+                if(literal_length_count > 286 || distance_count > MAX_DISTANCE_CODES)
+                    throw InflateError();
+
+                lengths.fill(0);
+                for(size_t i = 0; i < code_length_count; i++)
+                    lengths[CODE_LENGTH_ORDER[i]] = reader.Read(3);
+
+                // Code length codes reuse the distance table
+                BuildHuffman(distance_, lengths.data(), CODE_LENGTH_ORDER.size());
+
+                size_t index = 0;
+                while(index < literal_length_count + distance_count) {
+                    uint16_t symbol = DecodeSymbol(reader, distance_);
+
+                    if(symbol < 16) {
+                        lengths[index++] = symbol;
+                        continue;
+                    }
+
+                    uint8_t length = 0;
+                    size_t repeat = 0;
+                    if(symbol == 16) {
+                        if(index == 0)
+                            throw InflateError();
+                        length = lengths[index - 1];
+                        repeat = 3 + reader.Read(2);
+                    } else if(symbol == 17) {
+                        repeat = 3 + reader.Read(3);
+                    } else {
+                        repeat = 11 + reader.Read(7);
+                    }
+
+                    if(index + repeat > literal_length_count + distance_count)
+                        throw InflateError();
+
+                    while(repeat-- > 0)
+                        lengths[index++] = length;
+                }
+
+                if(lengths[256] == 0)
+                    throw InflateError();
+
+                BuildHuffman(literal_length_, lengths.data(), literal_length_count);
+                BuildHuffman(distance_, lengths.data() + literal_length_count, distance_count);
+            } else {
+                throw InflateError();
+            }
+
+            while(true) {
+                uint16_t symbol = DecodeSymbol(reader, literal_length_);
+
+                if(symbol < 256) {
+                    if(position >= output.size())
+                        throw InflateError();
+
+                    output[position++] = symbol;
+                    continue;
+                }
+
+                if(symbol == 256)
+                    break;
+
+                symbol -= 257;
+                if(symbol >= LENGTH_BASE.size())
+                    throw InflateError();
+
+                size_t length = LENGTH_BASE[symbol] + reader.Read(LENGTH_EXTRA_BITS[symbol]);
+
+                uint16_t distance_symbol = DecodeSymbol(reader, distance_);
+                if(distance_symbol >= DISTANCE_BASE.size())
+                    throw InflateError();
+
+                size_t distance = DISTANCE_BASE[distance_symbol] + reader.Read(DISTANCE_EXTRA_BITS[distance_symbol]);
+
+                if(distance > position || length > output.size() - position)
+                    throw InflateError();
+
+                // NOTE: Byte by byte, source and destination may overlap
+                for(size_t i = 0; i < length; i++, position++)
+                    output[position] = output[position - distance];
+            }
+        }
+    } catch(const InflateError&) {
+        return 0;
+    }
+
+    // Adler-32 trailer follows the deflate data, stored big endian
+    auto trailer = input.subspan(2 + reader.GetPosition());
+    if(trailer.size() < 4)
+        return 0;
+
+    uint32_t adler = (static_cast<uint32_t>(trailer[0]) << 24) | (trailer[1] << 16) | (trailer[2] << 8) | trailer[3];
+    if(adler != DeflateCompressor::Adler32(output.first(position)))
+        return 0;
+
+    return position;
+}
+
+} // namespace eerie_leap::utilities::compression
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace eerie_leap::utilities::compression {
+
+// Small footprint zlib (RFC 1950) stream decompressor, counterpart of
+// DeflateCompressor. Handles stored, fixed and dynamic Huffman blocks.
+// NOTE: Codes are decoded bit by bit against canonical code counts,
+// slower than table driven inflate but needs no lookup tables beyond
+// the ~1.3 KiB of code tables held by the instance.
+class InflateDecompressor {
+private:
+    static constexpr size_t MAX_BITS = 15;
+    static constexpr size_t MAX_LITERAL_LENGTH_CODES = 288;
+    static constexpr size_t MAX_DISTANCE_CODES = 30;
+
+    struct Huffman {
+        std::array<uint16_t, MAX_BITS + 1> counts;
+        std::array<uint16_t, MAX_LITERAL_LENGTH_CODES> symbols;
+    };
+
+    Huffman literal_length_;
+    Huffman distance_;
+
+public:
+    InflateDecompressor() = default;
+
+    InflateDecompressor(const InflateDecompressor&) = delete;
+    InflateDecompressor& operator=(const InflateDecompressor&) = delete;
+
+    // Returns decompressed size, 0 if input is invalid or output is too small
+    size_t Decompress(std::span<const uint8_t> input, std::span<uint8_t> output);
+};
+
+} // namespace eerie_leap::utilities::compression
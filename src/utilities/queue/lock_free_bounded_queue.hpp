@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+namespace eerie_leap::utilities::queue {
+
+// Bounded multi-producer multi-consumer queue.
+// Each cell carries a sequence number telling whether it is ready to be
+// written or read for the current lap, so Push and Pop are a single CAS on
+// the position plus a copy, with no locks. Push never blocks and fails when
+// the queue is full. Capacity must be a power of two.
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+class LockFreeBoundedQueue {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::pmr::memory_resource* mr_;
+    Cell* cells_;
+    size_t capacity_;
+    size_t mask_;
+
+    std::atomic<size_t> enqueue_position_;
+    std::atomic<size_t> dequeue_position_;
+    std::atomic<size_t> high_water_mark_;
+
+public:
+    LockFreeBoundedQueue(size_t capacity, std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+        : mr_(mr), capacity_(capacity), mask_(capacity - 1),
+        enqueue_position_(0), dequeue_position_(0), high_water_mark_(0) {
+
+        if(capacity_ < 2 || (capacity_ & mask_) != 0)
+            throw std::invalid_argument("Queue capacity must be a power of two");
+
+        cells_ = static_cast<Cell*>(mr_->allocate(sizeof(Cell) * capacity_, alignof(Cell)));
+        for(size_t i = 0; i < capacity_; i++)
+            new(&cells_[i].sequence) std::atomic<size_t>(i);
+    }
+
+    ~LockFreeBoundedQueue() {
+        mr_->deallocate(cells_, sizeof(Cell) * capacity_, alignof(Cell));
+    }
+
+    LockFreeBoundedQueue(const LockFreeBoundedQueue&) = delete;
+    LockFreeBoundedQueue& operator=(const LockFreeBoundedQueue&) = delete;
+
+    bool Push(const T& value) {
+        size_t position = enqueue_position_.load(std::memory_order_relaxed);
+        Cell* cell;
+
+        while(true) {
+            cell = &cells_[position & mask_];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+            if(diff == 0) {
+                if(enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            } else if(diff < 0) {
+                return false;
+            } else {
+                position = enqueue_position_.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = value;
+        cell->sequence.store(position + 1, std::memory_order_release);
+
+        size_t size = position + 1 - dequeue_position_.load(std::memory_order_relaxed);
+        size_t high_water_mark = high_water_mark_.load(std::memory_order_relaxed);
+        while(size > high_water_mark
+            && !high_water_mark_.compare_exchange_weak(high_water_mark, size, std::memory_order_relaxed)) {}
+
+        return true;
+    }
+
+    bool Pop(T& value) {
+        size_t position = dequeue_position_.load(std::memory_order_relaxed);
+        Cell* cell;
+
+        while(true) {
+            cell = &cells_[position & mask_];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+
+            if(diff == 0) {
+                if(dequeue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            } else if(diff < 0) {
+                return false;
+            } else {
+                position = dequeue_position_.load(std::memory_order_relaxed);
+            }
+        }
+
+        value = cell->value;
+        cell->sequence.store(position + mask_ + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    size_t GetCapacity() const { return capacity_; }
+
+    size_t GetSize() const {
+        return enqueue_position_.load(std::memory_order_relaxed) - dequeue_position_.load(std::memory_order_relaxed);
+    }
+
+    size_t GetHighWaterMark() const { return high_water_mark_.load(std::memory_order_relaxed); }
+    void ResetHighWaterMark() { high_water_mark_.store(GetSize(), std::memory_order_relaxed); }
+};
+
+} // namespace eerie_leap::utilities::queue
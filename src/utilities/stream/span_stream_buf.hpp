@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <streambuf>
+
+namespace eerie_leap::utilities::stream {
+
+// Read only stream over memory that is already loaded, e.g.
+// SpanStreamBuf stream_buf(content);
+// dbc->LoadDbcFile(stream_buf);
+class SpanStreamBuf : public std::streambuf {
+public:
+    explicit SpanStreamBuf(std::span<const uint8_t> content) {
+        auto* begin = reinterpret_cast<char*>(const_cast<uint8_t*>(content.data()));
+        setg(begin, begin, begin + content.size());
+    }
+
+protected:
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+        if(!(which & std::ios_base::in))
+            return pos_type(off_type(-1));
+
+        off_type position = 0;
+        if(dir == std::ios_base::beg)
+            position = off;
+        else if(dir == std::ios_base::cur)
+            position = (gptr() - eback()) + off;
+        else
+            position = (egptr() - eback()) + off;
+
+        if(position < 0 || position > egptr() - eback())
+            return pos_type(off_type(-1));
+
+        setg(eback(), eback() + position, egptr());
+
+        return pos_type(position);
+    }
+
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+};
+
+} // namespace eerie_leap::utilities::stream